@@ -0,0 +1,240 @@
+/**
+ * @file chaos_indicators.hpp
+ * @author Karel Kraus
+ * @brief Fast chaos indicators (MEGNO, FLI, SALI) calculated during
+ * integration of variational equations.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/integrator/event.hpp"
+#include "gravitacek2/chaos/variational_equations.hpp"
+
+#include <memory>
+
+namespace gr2
+{
+    /**
+     * @brief Classification of orbit by chaos indicator.
+     *
+     */
+    enum OrbitClass
+    {
+        undecided,  //!<indicator has not converged yet
+        regular,    //!<orbit is regular
+        chaotic,    //!<orbit is chaotic
+    };
+
+    /**
+     * @brief General chaos indicator calculated from deviation vectors of
+     * VariationalGeoMotion.
+     *
+     * Indicator is updated after every step. When it classifies the orbit,
+     * it can terminate the integration (indicator becomes terminal event).
+     */
+    class ChaosIndicator : public Event
+    {
+    protected:
+        std::shared_ptr<VariationalGeoMotion> ode;  //!<variational equations
+        bool early_termination; //!<stop integration when the orbit is classified
+        OrbitClass orbit_class; //!<current classification of orbit
+        real t_last;            //!<time of the last update
+
+        /**
+         * @brief Classify the orbit (and stop integration if early
+         * termination is enabled).
+         *
+         * @param orbit_class class of orbit
+         */
+        void decide(const OrbitClass &orbit_class);
+    public:
+        /**
+         * @brief Construct a new ChaosIndicator object.
+         *
+         * @param ode variational equations
+         * @param early_termination true if integration should be stopped when the orbit is classified
+         */
+        ChaosIndicator(std::shared_ptr<VariationalGeoMotion> ode, const bool &early_termination);
+
+        /**
+         * @brief Get value of the indicator.
+         *
+         * @return value of the indicator at the time of the last update
+         */
+        virtual real get_value() const = 0;
+
+        /**
+         * @brief Get classification of orbit.
+         *
+         * @return class of orbit
+         */
+        OrbitClass get_orbit_class() const;
+
+        /**
+         * @brief Get time of the last update.
+         *
+         * @return time of the last update
+         */
+        real get_time() const;
+
+        /**
+         * @brief Prepare indicator for new orbit.
+         *
+         */
+        virtual void reset();
+
+        virtual real value(const real &t, const real &dt, const real y[], const real dydt[]) override;
+    };
+
+    /**
+     * @brief Mean Exponential Growth factor of Nearby Orbits (MEGNO).
+     *
+     * Mean value \f$\langle Y \rangle\f$ is read from quadratures of
+     * VariationalGeoMotion (MEGNO has to be enabled). For quasi-periodic
+     * orbits \f$\langle Y \rangle \to 2\f$, for chaotic orbits it grows as
+     * \f$\lambda t/2\f$.
+     *
+     * Growing \f$\langle Y \rangle\f$ of weakly chaotic orbit passes through
+     * 2 too, so the orbit is regular only if \f$\langle Y \rangle\f$ stays
+     * close to 2 from the time \f$t_b\f$ it came close until
+     * \f$w t_b\f$, where \f$w\f$ is `regular_window`.
+     */
+    class MEGNO : public ChaosIndicator
+    {
+    protected:
+        real t_min;         //!<minimal time for classification
+        real regular_tol;   //!<orbit is regular if \f$|\langle Y \rangle - 2|\f$ is below this value
+        real chaotic_limit; //!<orbit is chaotic if \f$\langle Y \rangle\f$ exceeds this value
+        real regular_window;//!<ratio of times, during which \f$\langle Y \rangle\f$ has to stay close to 2
+        real t_band;        //!<time since which \f$\langle Y \rangle\f$ is close to 2 (negative if it is not)
+        real megno;         //!<MEGNO \f$Y\f$
+        real mean_megno;    //!<mean MEGNO \f$\langle Y \rangle\f$
+    public:
+        /**
+         * @brief Construct a new MEGNO object.
+         *
+         * @param ode variational equations with MEGNO quadratures
+         * @param t_min minimal time for classification
+         * @param regular_tol orbit is regular if \f$|\langle Y \rangle - 2|\f$ is below this value
+         * @param chaotic_limit orbit is chaotic if \f$\langle Y \rangle\f$ exceeds this value
+         * @param early_termination true if integration should be stopped when the orbit is classified
+         * @param regular_window orbit is regular if \f$|\langle Y \rangle - 2|\f$ stays below `regular_tol` from time \f$t_b\f$ until `regular_window` \f$t_b\f$
+         */
+        MEGNO(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &regular_tol=0.05, const real &chaotic_limit=5, const bool &early_termination=true, const real &regular_window=2);
+
+        /**
+         * @brief Get mean MEGNO.
+         *
+         * @return value of \f$\langle Y \rangle\f$
+         */
+        virtual real get_value() const override;
+
+        /**
+         * @brief Get MEGNO.
+         *
+         * @return value of \f$Y\f$
+         */
+        real get_megno() const;
+
+        virtual void reset() override;
+
+        virtual void apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[]) override;
+    };
+
+    /**
+     * @brief Fast Lyapunov Indicator (FLI).
+     *
+     * FLI is the largest value of \f$\ln |\vec{w}|\f$ reached by deviation
+     * vector with unit initial norm. Deviation vector is normalized after
+     * every step and logarithms of norms are accumulated. For regular orbits
+     * FLI grows logarithmically, for chaotic orbits linearly.
+     *
+     * Growth of FLI is checked over windows \f$[t_b, w t_b]\f$, where \f$w\f$
+     * is `regular_window` and every window starts where the previous one
+     * ended. The orbit is regular if FLI grew at most by
+     * \f$s \ln(t/t_b)\f$ over a window ending after `t_min`, where \f$s\f$
+     * is `regular_slope`.
+     */
+    class FLI : public ChaosIndicator
+    {
+    protected:
+        int index;          //!<index of deviation vector
+        real t_min;         //!<minimal time for regular classification
+        real chaotic_limit; //!<orbit is chaotic if FLI exceeds this value
+        real regular_slope; //!<maximal growth of FLI over window relative to growth of \f$\ln t\f$ for regular orbit
+        real regular_window;//!<ratio of times at the end and at the beginning of window
+        real t_band;        //!<time at the beginning of the current window (negative before the first step)
+        real fli_band;      //!<FLI at the beginning of the current window
+        real log_norm;      //!<accumulated logarithm of norm of deviation vector
+        real fli;           //!<value of FLI
+    public:
+        /**
+         * @brief Construct a new FLI object.
+         *
+         * @param ode variational equations
+         * @param t_min minimal time for regular classification
+         * @param chaotic_limit orbit is chaotic if FLI exceeds this value
+         * @param index index of deviation vector
+         * @param early_termination true if integration should be stopped when the orbit is classified
+         * @param regular_slope orbit is regular if FLI grows at most by `regular_slope` \f$\ln(t/t_b)\f$ over window
+         * @param regular_window ratio of times at the end and at the beginning of window
+         */
+        FLI(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &chaotic_limit=20, const int &index=0, const bool &early_termination=true, const real &regular_slope=2, const real &regular_window=2);
+
+        virtual real get_value() const override;
+
+        virtual void reset() override;
+
+        virtual void apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[]) override;
+    };
+
+    /**
+     * @brief Smaller Alignment Index (SALI).
+     *
+     * Two deviation vectors are normalized after every step and
+     * \f$\mathrm{SALI} = \min(|\hat{w}_1 + \hat{w}_2|, |\hat{w}_1 - \hat{w}_2|)\f$.
+     * For chaotic orbits both vectors align with the most unstable direction
+     * and SALI decreases exponentially, for regular orbits it oscillates
+     * around nonzero value.
+     *
+     * The orbit is regular if SALI stays above `regular_limit` from
+     * \f$t_s = \max(t_b, t_\text{min})\f$ until \f$w t_s\f$, where \f$t_b\f$
+     * is the time it rose above the limit and \f$w\f$ is `regular_window`.
+     * SALI starts at \f$\sqrt{2}\f$, so the window cannot start before
+     * \f$t_\text{min}\f$.
+     */
+    class SALI : public ChaosIndicator
+    {
+    protected:
+        int index1;         //!<index of the first deviation vector
+        int index2;         //!<index of the second deviation vector
+        real t_min;         //!<minimal time for regular classification
+        real chaotic_limit; //!<orbit is chaotic if SALI drops below this value
+        real regular_limit; //!<orbit is regular if SALI stays above this value
+        real regular_window;//!<ratio of times, during which SALI has to stay above `regular_limit`
+        real t_band;        //!<time since which SALI is above `regular_limit` (negative if it is not)
+        real sali;          //!<value of SALI
+    public:
+        /**
+         * @brief Construct a new SALI object.
+         *
+         * @param ode variational equations
+         * @param t_min minimal time for regular classification
+         * @param chaotic_limit orbit is chaotic if SALI drops below this value
+         * @param index1 index of the first deviation vector
+         * @param index2 index of the second deviation vector
+         * @param early_termination true if integration should be stopped when the orbit is classified
+         * @param regular_limit orbit is regular if SALI stays above this value
+         * @param regular_window orbit is regular if SALI stays above `regular_limit` from time \f$t_s\f$ until `regular_window` \f$t_s\f$
+         */
+        SALI(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &chaotic_limit=1e-8, const int &index1=1, const int &index2=2, const bool &early_termination=true, const real &regular_limit=1e-4, const real &regular_window=2);
+
+        virtual real get_value() const override;
+
+        virtual void reset() override;
+
+        virtual void apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[]) override;
+    };
+}
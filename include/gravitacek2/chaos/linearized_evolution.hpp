@@ -7,6 +7,15 @@
 
 namespace gr2
 {
+    /**
+     * @brief Calculate tidal matrix \f$A^\mu_{\ \nu} = -R^\mu_{\ \alpha\nu\beta}u^\alpha u^\beta\f$.
+     *
+     * @param spt space-time
+     * @param y position and four-velocity
+     * @param A array for saving matrix \f$4\times 4\f$ stored by rows
+     */
+    void tidal_matrix(GeoMotion* spt, const real *y, real *A);
+
     gsl_matrix* matrix_H(GeoMotion* spt, const real *y);
 
     // gsl_matrix* time_corrected_matrix_H(GeoMotion* spt, const real *y);
@@ -14,4 +23,19 @@ namespace gr2
     real expected_growth(GeoMotion* spt, const real *y);
 
     real max_norm_growth(GeoMotion* spt, const real *y);
+
+    /**
+     * @brief Calculate max_norm_growth() for many four-velocities at one
+     * position.
+     *
+     * Metric and Riemann tensor are calculated only once. No memory is
+     * allocated.
+     *
+     * @param spt space-time
+     * @param y position (four-velocity in `y` is not used)
+     * @param n number of four-velocities
+     * @param u four-velocities, \f$u^\mu\f$ of a-th four-velocity is `u[4*a + mu]`
+     * @param values array for saving \f$n\f$ values
+     */
+    void max_norm_growth(GeoMotion* spt, const real *y, const int &n, const real *u, real *values);
 }
\ No newline at end of file
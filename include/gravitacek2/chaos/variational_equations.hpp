@@ -0,0 +1,197 @@
+/**
+ * @file variational_equations.hpp
+ * @author Karel Kraus
+ * @brief Geodesic motion together with its variational equations (tangent
+ * map) and calculation of Lyapunov spectrum.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/integrator/odesystem.hpp"
+#include "gravitacek2/integrator/event.hpp"
+#include "gravitacek2/geomotion/geomotion.hpp"
+
+#include <memory>
+
+namespace gr2
+{
+    /**
+     * @brief Geodesic motion with linearized evolution of deviation vectors.
+     *
+     * Geodesic \f$x^\mu(\tau)\f$ is integrated together with \f$k\f$
+     * deviation vectors. Every deviation vector consists of coordinate
+     * deviation \f$\xi^\mu = \delta x^\mu\f$ and its covariant derivative
+     * \f$\eta^\mu = \frac{D\xi^\mu}{d\tau} = \delta u^\mu + \Gamma^\mu_{\alpha\beta} u^\alpha \xi^\beta\f$.
+     * Linearization of geodesic equation then gives
+     * \f[
+     * \frac{d\xi^\mu}{d\tau} = \eta^\mu - \Gamma^\mu_{\alpha\beta} u^\alpha \xi^\beta, \quad
+     * \frac{d\eta^\mu}{d\tau} = -\Gamma^\mu_{\alpha\beta} u^\alpha \eta^\beta - R^\mu_{\alpha\nu\beta} u^\alpha \xi^\nu u^\beta,
+     * \f]
+     * where derivatives of Christoffel symbols are contained in Riemann
+     * tensor. Equations are exact (no finite separation of particles is
+     * used).
+     *
+     * Variables of geodesic motion are followed by deviation vectors, each
+     * of them stored as \f$(\xi^\mu, \eta^\mu)\f$ with \f$2d\f$ components.
+     *
+     * Optionally the quadratures of MEGNO are integrated as the last two
+     * variables for the first deviation vector \f$\vec{w}\f$ (integration
+     * has to start at \f$t = 0\f$)
+     * \f[
+     * \frac{dJ}{dt} = t\frac{\vec{w}\cdot\dot{\vec{w}}}{\vec{w}\cdot\vec{w}}, \quad
+     * \frac{dK}{dt} = \frac{2J}{t},
+     * \f]
+     * so that MEGNO is \f$Y = 2J/t\f$ and its mean value is
+     * \f$\langle Y \rangle = K/t\f$. Both are independent of the norm of
+     * \f$\vec{w}\f$, so deviation vectors can be renormalized freely.
+     */
+    class VariationalGeoMotion : public OdeSystem
+    {
+    protected:
+        std::shared_ptr<GeoMotion> spt; //!<space-time of the geodesic motion
+        int dim;                        //!<dimension of space-time
+        int k;                          //!<number of deviation vectors
+        int megno_index;                //!<index of MEGNO quadrature \f$J\f$ (-1 if it is not integrated)
+        real *G;                        //!<matrix \f$\Gamma^\mu_{\alpha\beta} u^\alpha\f$, index \f$\mu d + \beta\f$
+        real *A;                        //!<matrix \f$-R^\mu_{\alpha\nu\beta} u^\alpha u^\beta\f$, index \f$\mu d + \nu\f$
+    public:
+        /**
+         * @brief Construct a new VariationalGeoMotion object.
+         *
+         * @param spt space-time
+         * @param k number of deviation vectors (from 1 to \f$2d\f$)
+         * @param megno true if quadratures of MEGNO should be integrated
+         */
+        VariationalGeoMotion(std::shared_ptr<GeoMotion> spt, const int &k=1, const bool &megno=false);
+
+        /**
+         * @brief Destroy the VariationalGeoMotion object.
+         *
+         */
+        ~VariationalGeoMotion();
+
+        /**
+         * @brief Get space-time.
+         *
+         * @return space-time of the geodesic motion
+         */
+        std::shared_ptr<GeoMotion> get_spacetime() const;
+
+        /**
+         * @brief Get number of deviation vectors.
+         *
+         * @return number of deviation vectors
+         */
+        int get_k() const;
+
+        /**
+         * @brief Get index of the first component of deviation vector.
+         *
+         * @param i index of deviation vector
+         * @return index of \f$\xi^0\f$ of i-th deviation vector
+         */
+        int get_deviation_index(const int &i) const;
+
+        /**
+         * @brief Get index of MEGNO quadratures.
+         *
+         * @return index of \f$J\f$, \f$K\f$ follows it (-1 if MEGNO is not integrated)
+         */
+        int get_megno_index() const;
+
+        /**
+         * @brief Set deviation vectors to orthonormal vectors in generic
+         * direction.
+         *
+         * Vectors are not aligned with coordinate directions, because
+         * deviations in \f$t\f$ or \f$\phi\f$ of stationary axially
+         * symmetric space-times do not grow exponentially. MEGNO quadratures
+         * are set to zero.
+         *
+         * @param y variables (geodesic part is not changed)
+         */
+        void init_deviations(real y[]) const;
+
+        /**
+         * @brief Orthonormalize deviation vectors (QR decomposition by
+         * modified Gram-Schmidt process).
+         *
+         * Logarithms of diagonal elements of R (norms of deviation vectors
+         * after projection) are added to `log_norms`.
+         *
+         * @param y variables
+         * @param log_norms array of \f$k\f$ accumulated logarithms of norms
+         */
+        void orthonormalize(real y[], real log_norms[]) const;
+
+        /**
+         * @brief Normalize one deviation vector.
+         *
+         * Equations of deviation vectors are linear, so their derivatives are
+         * rescaled by the same factor if `dydt` is given.
+         *
+         * @param i index of deviation vector
+         * @param y variables
+         * @param dydt derivatives of variables (if given)
+         * @return logarithm of norm of deviation vector before normalization
+         */
+        real normalize(const int &i, real y[], real dydt[] = nullptr) const;
+
+        virtual void function(const real &t, const real y[], real dydt[]) override;
+    };
+
+    /**
+     * @brief Event calculating Lyapunov spectrum from VariationalGeoMotion.
+     *
+     * Deviation vectors are periodically orthonormalized and logarithms of
+     * their norms are accumulated. Lyapunov exponents are given as
+     * accumulated logarithms divided by the elapsed time.
+     */
+    class LyapunovSpectrum : public Event
+    {
+    protected:
+        std::shared_ptr<VariationalGeoMotion> ode;  //!<variational equations
+        real period;        //!<time between orthonormalizations
+        real t_start;       //!<initial time of integration
+        real t_last;        //!<time of the last orthonormalization
+        real *log_norms;    //!<accumulated logarithms of norms of deviation vectors
+    public:
+        /**
+         * @brief Construct a new LyapunovSpectrum object.
+         *
+         * @param ode variational equations
+         * @param period time between orthonormalizations
+         * @param t_start initial time of integration
+         */
+        LyapunovSpectrum(std::shared_ptr<VariationalGeoMotion> ode, const real &period, const real &t_start=0);
+
+        /**
+         * @brief Destroy the LyapunovSpectrum object.
+         *
+         */
+        ~LyapunovSpectrum();
+
+        /**
+         * @brief Get Lyapunov exponents.
+         *
+         * Exponents are calculated at the time of the last
+         * orthonormalization.
+         *
+         * @param exponents array for storing \f$k\f$ exponents
+         */
+        void get_exponents(real exponents[]) const;
+
+        /**
+         * @brief Get time of the last orthonormalization.
+         *
+         * @return time of the last orthonormalization
+         */
+        real get_time() const;
+
+        virtual real value(const real &t, const real &dt, const real y[], const real dydt[]) override;
+
+        virtual void apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[]) override;
+    };
+}
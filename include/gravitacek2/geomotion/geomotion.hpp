@@ -7,10 +7,26 @@
  */
 
 #pragma once
+#include <vector>
+#include <array>
+
 #include "gravitacek2/integrator/odesystem.hpp"
 
 namespace gr2
 {
+    /**
+     * @brief Nonzero Christoffel symbol \f$\tensor{\Gamma}{^\mu_\kappa_\lambda}\f$
+     * used in sparse contraction.
+     */
+    struct ChristoffelEntry
+    {
+        int mu;         //!<upper index \f$\mu\f$
+        int kappa;      //!<first lower index \f$\kappa\f$
+        int lambda;     //!<second lower index \f$\lambda \geq \kappa\f$
+        int index;      //!<index of symbol in contiguous storage
+        real factor;    //!<multiplicity of term in contraction (2 if \f$\kappa \neq \lambda\f$)
+    };
+
     /**
      * @brief General representation for ODEs describing geodesic motion.
      * 
@@ -22,11 +38,18 @@ namespace gr2
     protected:
         int dim;                        //!<dimension of space(-time)
 
-        //TODO: should be converted to 1D arrays
+        // ========== Contiguous storage of tensors ========== 
+        real *metric_data;              //!<components of `metric`, index \f$\mu d + \nu\f$
+        real *christoffel_symbols_data; //!<components of `christoffel_symbols`, index \f$(\mu d + \kappa)d + \lambda\f$
+        real *riemann_tensor_data;      //!<components of `riemann_tensor`, index \f$((\mu d + \nu)d + \kappa)d + \lambda\f$
+
+        // ========== Views of tensors (pointing into contiguous storage) ========== 
         real **metric;                  //!<metric tensor \f$g_{\mu\nu}\f$
         real ***christoffel_symbols;    //!<Christoffel symbols \f$\Gamma^{\mu}_{\kappa\lambda}\f$
         real ****riemann_tensor;        //!<Riemann tensor \f$R^{\mu}_{\nu\kappa\lambda}\f$
 
+        std::vector<ChristoffelEntry> christoffel_sparsity; //!<nonzero Christoffel symbols (empty if not known)
+
         real *y_m;                      //!<position where `metric` is calculated
         real *y_c;                      //!<position where `christoffel_symbols`is calculated
         real *y_r;                      //!<position where `riemann_tensor`is calculated
@@ -41,6 +64,19 @@ namespace gr2
          * @return false if calculation is not necessary
          */
         bool necessary_calculate(const real *y, real *&y_save, const int& n);
+
+        /**
+         * @brief Set Christoffel symbols, which can be nonzero.
+         * 
+         * Every entry \f$(\mu, \kappa, \lambda)\f$ represents both
+         * \f$\tensor{\Gamma}{^\mu_\kappa_\lambda}\f$ and
+         * \f$\tensor{\Gamma}{^\mu_\lambda_\kappa}\f$. All other symbols
+         * have to stay zero. If sparsity is set, `function` contracts only
+         * over given symbols.
+         * 
+         * @param entries vector of indices \f$(\mu, \kappa, \lambda)\f$
+         */
+        void set_christoffel_sparsity(const std::vector<std::array<int, 3>> &entries);
     public:
         // ========== Constructors & destructors ========== 
         /**
@@ -51,12 +87,26 @@ namespace gr2
          */
         GeoMotion(const int &dim, const int &n);
 
+        GeoMotion(const GeoMotion&) = delete;
+        GeoMotion& operator=(const GeoMotion&) = delete;
+
         /**
          * @brief Destroy the GeoMotion object.
          * 
          */
         virtual ~GeoMotion();
 
+        /**
+         * @brief Create independent copy of the object.
+         * 
+         * Copy has the same parameters, but its own metric, Christoffel
+         * symbols, Riemann tensor and all auxiliary values. Therefore the copy
+         * can be used in different thread than the original.
+         * 
+         * @return pointer to new object
+         */
+        virtual GeoMotion* clone() const = 0;
+
         // ========== Calculate ========== 
 
         /**
@@ -138,6 +188,46 @@ namespace gr2
          */
         real ****get_riemann_tensor() const;
 
+        /**
+         * @brief Get metric tensor stored in contiguous array.
+         * 
+         * Component \f$g_{\mu\nu}\f$ has index \f$\mu d + \nu\f$, where \f$d\f$
+         * is dimension of space(-time).
+         * 
+         * @return array of components of metric tensor
+         */
+        real *get_metric_data() const;
+
+        /**
+         * @brief Get Christoffel symbols stored in contiguous array.
+         * 
+         * Component \f$\tensor{\Gamma}{^\mu_\kappa_\lambda}\f$ has index
+         * \f$(\mu d + \kappa)d + \lambda\f$, where \f$d\f$ is dimension of
+         * space(-time).
+         * 
+         * @return array of Christoffel symbols
+         */
+        real *get_christoffel_symbols_data() const;
+
+        /**
+         * @brief Get Riemann tensor stored in contiguous array.
+         * 
+         * Component \f$\tensor{R}{^\mu_\nu_\kappa_\lambda}\f$ has index
+         * \f$((\mu d + \nu)d + \kappa)d + \lambda\f$, where \f$d\f$ is
+         * dimension of space(-time).
+         * 
+         * @return array of components of Riemann tensor
+         */
+        real *get_riemann_tensor_data() const;
+
+        /**
+         * @brief Get nonzero Christoffel symbols.
+         * 
+         * @return vector of nonzero Christoffel symbols (empty if all symbols
+         * can be nonzero)
+         */
+        const std::vector<ChristoffelEntry> &get_christoffel_sparsity() const;
+
         // ========== Function ========== 
 
         /**
@@ -151,6 +241,10 @@ namespace gr2
          * \f[
          * \dv{\vec{y}}{t} = \left(u^\mu, -\tensor{\Gamma}{^\mu_\kappa_\lambda}u^\kappa u^\lambda\right).
          * \f]
+         * Symmetry \f$\tensor{\Gamma}{^\mu_\kappa_\lambda} = 
+         * \tensor{\Gamma}{^\mu_\lambda_\kappa}\f$ is used, only components
+         * with \f$\kappa \leq \lambda\f$ are read. If sparsity of Christoffel
+         * symbols is set, only nonzero symbols are read.
          * 
          * @param t time variable
          * @param y state vector
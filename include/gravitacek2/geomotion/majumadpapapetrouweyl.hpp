@@ -42,6 +42,13 @@ namespace gr2
         real N_inv_rhoz;    //!<value of \f$N^{-1}_{,\rho z}\f$
         real N_inv_zz;      //!<value of \f$N^{-1}_{,zz}\f$
 
+        int jet_order;      //!<highest order of cached derivatives of \f$N^{-1}\f$ (-1 if cache is empty)
+        real jet_rho;       //!<value of \f$\rho\f$ for cached values
+        real jet_z;         //!<value of \f$z\f$ for cached values
+        real jet[6];        //!<cached values of \f$N^{-1}\f$ and its derivatives
+
+        std::vector<real> batch_N_inv;  //!<values of \f$N^{-1}, N^{-1}_{,\rho}, N^{-1}_{,z}\f$ of lanes (used by function_batch())
+
     public:
         static const int T = 0;         //!<index of coordinate \f$t\f$
         static const int PHI = 1;       //!<index of coordinate \f$\phi\f$
@@ -64,6 +71,8 @@ namespace gr2
          */
         virtual ~MajumdarPapapetrouWeyl();
 
+        virtual MajumdarPapapetrouWeyl* clone() const override = 0;
+
         /**
          * @brief Calculate value of \f$N^{-1}\f$.
          * 
@@ -86,6 +95,17 @@ namespace gr2
          */
         virtual void calculate_N_inv2(const real* y) = 0;
 
+        /**
+         * @brief Calculate value of \f$N^{-1}\f$ and its derivatives up to
+         * given order.
+         * 
+         * Values are cached for the last position (see Weyl::evaluate()).
+         * 
+         * @param y coordinate values
+         * @param order highest order of derivatives (0, 1 or 2)
+         */
+        void evaluate(const real* y, const int &order);
+
         /**
          * @brief Get value of \f$N^{-1}\f$.
          * 
@@ -133,6 +153,22 @@ namespace gr2
         virtual void calculate_metric(const real *y) override;
         virtual void calculate_christoffel_symbols(const real *y) override;
         virtual void calculate_riemann_tensor(const real *y) override;
+
+        // ========== Function ========== 
+
+        /**
+         * @brief Calculate derivatives of more independent states at once.
+         *
+         * Lapse function is evaluated lane by lane, geodesic equations are
+         * then evaluated with explicit Christoffel symbols in one loop over
+         * lanes, which can be vectorised by compiler.
+         *
+         * @param lanes number of lanes
+         * @param t time value of each lane
+         * @param y coordinate values of all lanes
+         * @param dydt array for returning derivatives of all lanes
+         */
+        void function_batch(const int &lanes, const real t[], const real y[], real dydt[]) override;
     };
 
     /**
@@ -159,6 +195,15 @@ namespace gr2
         CombinedMPW(std::vector<std::shared_ptr<MajumdarPapapetrouWeyl>> sources);
         ~CombinedMPW();
 
+        /**
+         * @brief Create independent copy of the object.
+         * 
+         * Individual sources are copied as well.
+         * 
+         * @return pointer to new object
+         */
+        virtual CombinedMPW* clone() const override;
+
         virtual void calculate_N_inv(const real* y) override;
         virtual void calculate_N_inv1(const real* y) override;
         virtual void calculate_N_inv2(const real* y) override;
@@ -0,0 +1,154 @@
+/**
+ * @file reducedgeomotion.hpp
+ * @author Karel Kraus
+ * @brief Geodesic motion in stationary axially symmetric space-times reduced
+ * by integrals of motion.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/integrator/odesystem.hpp"
+#include "gravitacek2/geomotion/geomotion.hpp"
+#include "gravitacek2/geomotion/weyl.hpp"
+#include "gravitacek2/geomotion/majumadpapapetrouweyl.hpp"
+
+#include <memory>
+
+namespace gr2
+{
+    /**
+     * @brief Geodesic motion in meridional plane given by energy and angular
+     * momentum.
+     *
+     * In stationary axially symmetric space-times with diagonal metric
+     * (Weyl and MajumdarPapapetrouWeyl) coordinates \f$t\f$ and \f$\phi\f$
+     * are cyclic and covariant components of four-velocity
+     * \f$u_t = -E\f$ and \f$u_\phi = L\f$ are conserved. Remaining components
+     * of four-velocity are given as
+     * \f[
+     * u^t = -\frac{E}{g_{tt}}, \quad u^\phi = \frac{L}{g_{\phi\phi}}
+     * \f]
+     * and only equations for \f$\rho\f$, \f$z\f$, \f$u^\rho\f$, \f$u^z\f$
+     * (and \f$\lambda\f$, if Weyl space-time calculates it by
+     * differentiation) are integrated. Energy and angular momentum are
+     * conserved exactly.
+     *
+     * Coordinates \f$t\f$ and \f$\phi\f$ can be reconstructed by quadrature,
+     * they are then integrated as the last two variables.
+     */
+    class ReducedGeoMotion : public OdeSystem
+    {
+    protected:
+        std::shared_ptr<GeoMotion> spt; //!<space-time of the geodesic motion
+        std::shared_ptr<Weyl> weyl;     //!<space-time as Weyl space-time (nullptr for other space-times)
+        std::shared_ptr<MajumdarPapapetrouWeyl> mpw;    //!<space-time as Majumdar-Papapetrou space-time (nullptr for other space-times)
+        real E;                         //!<energy \f$E = -u_t\f$
+        real L;                         //!<angular momentum \f$L = u_\phi\f$
+
+        int lambda_index;   //!<index of \f$\lambda\f$ in reduced variables (-1 if it is not integrated)
+        int t_index;        //!<index of \f$t\f$ in reduced variables (-1 without quadrature)
+        int phi_index;      //!<index of \f$\phi\f$ in reduced variables (-1 without quadrature)
+
+        real *y_full;       //!<values of all variables of space-time
+
+        /**
+         * @brief Fill position (and \f$\lambda\f$) of all variables from
+         * reduced variables.
+         *
+         * @param y reduced variables
+         */
+        void fill_position(const real y[]);
+
+    public:
+        static const int RHO = 0;   //!<index of coordinate \f$\rho\f$
+        static const int Z = 1;     //!<index of coordinate \f$z\f$
+        static const int URHO = 2;  //!<index of four-velocity \f$u^\rho\f$
+        static const int UZ = 3;    //!<index of four-velocity \f$u^z\f$
+
+        /**
+         * @brief Construct a new ReducedGeoMotion object.
+         *
+         * @param spt space-time (Weyl or MajumdarPapapetrouWeyl)
+         * @param E energy
+         * @param L angular momentum
+         * @param quadrature true if \f$t\f$ and \f$\phi\f$ should be integrated
+         */
+        ReducedGeoMotion(std::shared_ptr<GeoMotion> spt, const real &E, const real &L, const bool &quadrature=false);
+
+        /**
+         * @brief Construct a new ReducedGeoMotion object with energy and
+         * angular momentum given by initial values.
+         *
+         * @param spt space-time (Weyl or MajumdarPapapetrouWeyl)
+         * @param y_full initial values of all variables of space-time
+         * @param quadrature true if \f$t\f$ and \f$\phi\f$ should be integrated
+         */
+        ReducedGeoMotion(std::shared_ptr<GeoMotion> spt, const real y_full[], const bool &quadrature=false);
+
+        ReducedGeoMotion(const ReducedGeoMotion&) = delete;
+        ReducedGeoMotion& operator=(const ReducedGeoMotion&) = delete;
+
+        /**
+         * @brief Destroy the ReducedGeoMotion object.
+         *
+         */
+        ~ReducedGeoMotion();
+
+        /**
+         * @brief Get energy.
+         *
+         * @return value of \f$E\f$
+         */
+        real get_E() const;
+
+        /**
+         * @brief Get angular momentum.
+         *
+         * @return value of \f$L\f$
+         */
+        real get_L() const;
+
+        /**
+         * @brief Get index of \f$\lambda\f$ in reduced variables.
+         *
+         * @return index of \f$\lambda\f$ (-1 if it is not integrated)
+         */
+        int get_lambda_index() const;
+
+        /**
+         * @brief Get index of \f$t\f$ in reduced variables.
+         *
+         * @return index of \f$t\f$ (-1 without quadrature)
+         */
+        int get_t_index() const;
+
+        /**
+         * @brief Get index of \f$\phi\f$ in reduced variables.
+         *
+         * @return index of \f$\phi\f$ (-1 without quadrature)
+         */
+        int get_phi_index() const;
+
+        /**
+         * @brief Calculate reduced variables from all variables of space-time.
+         *
+         * @param y_full all variables of space-time
+         * @param y array for storing reduced variables
+         */
+        void reduce(const real y_full[], real y[]) const;
+
+        /**
+         * @brief Calculate all variables of space-time from reduced variables.
+         *
+         * Without quadrature \f$t\f$ and \f$\phi\f$ are set to zero.
+         *
+         * @param y reduced variables
+         * @param y_full array for storing all variables of space-time
+         */
+        void reconstruct(const real y[], real y_full[]);
+
+        virtual void function(const real &t, const real y[], real dydt[]) override;
+    };
+}
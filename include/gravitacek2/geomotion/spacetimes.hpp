@@ -51,6 +51,8 @@ namespace gr2
          */
         Schwarzschild(real M = 1);
 
+        virtual Schwarzschild* clone() const override;
+
         virtual void calculate_metric(const real *y) override;
         virtual void calculate_christoffel_symbols(const real *y) override;
         virtual void calculate_riemann_tensor(const real *y) override;
@@ -91,6 +93,8 @@ namespace gr2
             LambdaEvaluation init=LambdaEvaluation::exact, 
             LambdaEvaluation run=LambdaEvaluation::diff);
 
+        virtual WeylSchwarzschild* clone() const override;
+
         virtual void calculate_lambda_init(const real* y) override;
         virtual void calculate_lambda_run(const real* y) override;
 
@@ -133,6 +137,8 @@ namespace gr2
             LambdaEvaluation init=LambdaEvaluation::integral, 
             LambdaEvaluation run=LambdaEvaluation::diff);
 
+        virtual BachWeylRing* clone() const override;
+
         virtual void calculate_lambda_init(const real* y) override;
         virtual void calculate_lambda_run(const real* y) override;
 
@@ -192,6 +198,8 @@ namespace gr2
             LambdaEvaluation run=LambdaEvaluation::diff);
         ~InvertedKuzminToomreDisk();
 
+        virtual InvertedKuzminToomreDisk* clone() const override;
+
         virtual void calculate_lambda_init(const real* y) override;
         virtual void calculate_lambda_run(const real* y) override;
 
@@ -243,8 +251,10 @@ namespace gr2
         real *C;    //!<constants for calculating potential
         real *P0;   //!<values of Legendre polynomials
         real *P1;   //!<values of derivatives of Legendre polynomials
+        real *P2;   //!<values of second derivatives of Legendre polynomials
         real *Q0;   //!<values of special function Q
         real *Q1;   //!<values of derivatives of special function Q
+        real *Q2;   //!<values of second derivatives of special function Q
 
         virtual void calculate_lambda_integral(const real* y);
     public:
@@ -262,6 +272,8 @@ namespace gr2
             LambdaEvaluation run=LambdaEvaluation::diff);
         ~InvertedMorganMorganDisk();
 
+        virtual InvertedMorganMorganDisk* clone() const override;
+
         virtual void calculate_lambda_init(const real* y) override;
         virtual void calculate_lambda_run(const real* y) override;
 
@@ -293,6 +305,8 @@ namespace gr2
         ReissnerNordstromMPW(const real& M);
         ~ReissnerNordstromMPW();
 
+        virtual ReissnerNordstromMPW* clone() const override;
+
         virtual void calculate_N_inv(const real* y) override;
         virtual void calculate_N_inv1(const real* y) override;
         virtual void calculate_N_inv2(const real* y) override;
@@ -327,6 +341,8 @@ namespace gr2
         MajumdarPapapetrouRing(const real& M, const real &b);
         ~MajumdarPapapetrouRing();
 
+        virtual MajumdarPapapetrouRing* clone() const override;
+
         virtual void calculate_N_inv(const real* y) override;
         virtual void calculate_N_inv1(const real* y) override;
         virtual void calculate_N_inv2(const real* y) override;
@@ -73,6 +73,13 @@ namespace gr2
         real lambda_rhoz;   //!<value of \f$\lambda_{,\rho z}\f$
         real lambda_zz;     //!<value of \f$\lambda_{,zz}\f$
 
+        int jet_order;      //!<highest order of cached derivatives of \f$\nu\f$ (-1 if cache is empty)
+        real jet_rho;       //!<value of \f$\rho\f$ for cached values
+        real jet_z;         //!<value of \f$z\f$ for cached values
+        real jet[6];        //!<cached values of \f$\nu\f$ and its derivatives
+
+        std::vector<real> batch_nu; //!<values of \f$\nu, \nu_{,\rho}, \nu_{,z}, \lambda\f$ of lanes (used by function_batch())
+
         /**
          * @brief Calculate value of \f$\lambda\f$ by integrating from \f$z =
          * \infty\f$ to \f$z = z_0\f$.
@@ -123,6 +130,8 @@ namespace gr2
          */
         virtual ~Weyl();
 
+        virtual Weyl* clone() const override = 0;
+
         /**
          * @brief Calculate value of \f$\nu\f$.
          * 
@@ -145,6 +154,19 @@ namespace gr2
          */
         virtual void calculate_nu2(const real *y) = 0;
 
+        /**
+         * @brief Calculate value of \f$\nu\f$ and its derivatives up to given
+         * order.
+         * 
+         * Values are cached for the last position, so metric, Christoffel
+         * symbols and Riemann tensor in the same point share one evaluation
+         * of the potential (lower order is taken from higher order).
+         * 
+         * @param y coordinate values
+         * @param order highest order of derivatives (0, 1 or 2)
+         */
+        void evaluate(const real *y, const int &order);
+
         /**
          * @brief Get value of \f$\nu\f$.
          * 
@@ -230,6 +252,20 @@ namespace gr2
 
         // ========== Function ========== 
         void function(const real &t, const real y[], real dydt[]) override;
+
+        /**
+         * @brief Calculate derivatives of more independent states at once.
+         *
+         * Potential and \f$\lambda\f$ are evaluated lane by lane, geodesic
+         * equations are then evaluated with explicit Christoffel symbols in
+         * one loop over lanes, which can be vectorised by compiler.
+         *
+         * @param lanes number of lanes
+         * @param t time value of each lane
+         * @param y coordinate values of all lanes
+         * @param dydt array for returning derivatives of all lanes
+         */
+        void function_batch(const int &lanes, const real t[], const real y[], real dydt[]) override;
     };
 
     /**
@@ -260,6 +296,147 @@ namespace gr2
         CombinedWeyl(std::vector<std::shared_ptr<Weyl>> sources);
         ~CombinedWeyl();
 
+        /**
+         * @brief Create independent copy of the object.
+         * 
+         * Individual sources are copied as well.
+         * 
+         * @return pointer to new object
+         */
+        virtual CombinedWeyl* clone() const override;
+
+        virtual void calculate_lambda_init(const real* y) override;
+        virtual void calculate_lambda_run(const real* y) override;
+
+        virtual void calculate_nu(const real* y) override;
+        virtual void calculate_nu1(const real* y) override;
+        virtual void calculate_nu2(const real* y) override;
+    };
+
+    /**
+     * @brief Bicubic patch of surrogate potential (or node of quadtree).
+     * 
+     * On the patch \f$[\rho_0, \rho_0 + h_\rho]\times[z_0, z_0 + h_z]\f$
+     * potential is approximated by polynomial
+     * \f[
+     * \nu \approx \sum_{i,j=0}^{3} a_{ij} u^i v^j, \quad
+     * u = \frac{\rho - \rho_0}{h_\rho}, \quad v = \frac{z - z_0}{h_z}.
+     * \f]
+     */
+    struct SurrogatePatch
+    {
+        real rho0;      //!<lower boundary in \f$\rho\f$
+        real z0;        //!<lower boundary in \f$z\f$
+        real h_rho;     //!<size in \f$\rho\f$
+        real h_z;       //!<size in \f$z\f$
+        int child;      //!<index of first of four children (-1 for leaf)
+        real a[16];     //!<coefficients \f$a_{ij}\f$ stored as `a[4*i + j]`
+    };
+
+    /**
+     * @brief GeoMotion class replacing expensive Weyl potential by precomputed
+     * surrogate.
+     * 
+     * Potential of the source is tabulated on region \f$\rho \in
+     * [\rho_\text{min}, \rho_\text{max}]\f$, \f$|z| \le
+     * z_\text{max}\f$ (source has to be symmetric with respect to equatorial
+     * plane, symmetry is checked on the grid of root patches and
+     * std::invalid_argument is thrown if it is broken by more than
+     * tolerance). Region is divided into uniform grid of patches and every patch
+     * is recursively divided into four until bicubic Hermite interpolation
+     * (from \f$\nu\f$, \f$\nu_{,\rho}\f$, \f$\nu_{,z}\f$ and
+     * \f$\nu_{,\rho z}\f$ in corners, mixed derivative is obtained by
+     * central difference, so only calculate_nu1() of the source is used)
+     * agrees with the source in the center
+     * and in the middles of edges of the patch within tolerance (for
+     * \f$\nu\f$ and its first derivatives). Patches never cross the
+     * equatorial plane, so discontinuities of derivatives on discs are
+     * respected. Largest difference found in these sample points is available
+     * by get_sampled_error(). It is only a sampled estimate, not a bound:
+     * error between sample points can be larger and error of the mixed
+     * derivative (difference step \f$10^{-5}\max(\rho, 1)\f$) is not
+     * checked.
+     * 
+     * Derivatives are derivatives of the interpolating polynomial, so first
+     * derivatives converge as \f$h^3\f$ and second derivatives as
+     * \f$h^2\f$. Outside of the region the source is used directly.
+     * 
+     * Clones share the table (it is not changed after construction).
+     */
+    class SurrogateWeyl : public Weyl
+    {
+    protected:
+        std::shared_ptr<Weyl> source;   //!<original space-time
+        real rho_min;                   //!<lower boundary of region in \f$\rho\f$
+        real rho_max;                   //!<upper boundary of region in \f$\rho\f$
+        real z_max;                     //!<upper boundary of region in \f$|z|\f$
+        int n_rho;                      //!<number of root patches in \f$\rho\f$
+        int n_z;                        //!<number of root patches in \f$z\f$
+        real sampled_error;             //!<largest difference found in sample points during construction
+        std::shared_ptr<const std::vector<SurrogatePatch>> patches; //!<quadtrees of patches (root patches first)
+
+        /**
+         * @brief Construct a new SurrogateWeyl object sharing table.
+         * 
+         * @param source original space-time
+         * @param other object with table
+         */
+        SurrogateWeyl(std::shared_ptr<Weyl> source, const SurrogateWeyl &other);
+
+        /**
+         * @brief Find leaf patch containing point.
+         * 
+         * @param rho coordinate \f$\rho\f$
+         * @param abs_z absolute value of coordinate \f$z\f$
+         * @return pointer to patch or nullptr if point is outside of the region
+         */
+        const SurrogatePatch* find_patch(const real &rho, const real &abs_z) const;
+
+    public:
+        /**
+         * @brief Construct a new SurrogateWeyl object.
+         * 
+         * @param source original space-time (symmetric with respect to equatorial plane)
+         * @throws std::invalid_argument if region is invalid or source is not
+         * symmetric with respect to equatorial plane
+         * @param rho_min lower boundary of region in \f$\rho\f$
+         * @param rho_max upper boundary of region in \f$\rho\f$
+         * @param z_max upper boundary of region in \f$|z|\f$
+         * @param tol tolerance for \f$\nu\f$ and its first derivatives
+         * @param n_rho number of root patches in \f$\rho\f$
+         * @param n_z number of root patches in \f$z\f$
+         * @param max_depth maximal number of divisions of root patch
+         */
+        SurrogateWeyl(std::shared_ptr<Weyl> source, const real &rho_min, const real &rho_max, const real &z_max, const real &tol, const int &n_rho = 16, const int &n_z = 16, const int &max_depth = 10);
+        ~SurrogateWeyl();
+
+        /**
+         * @brief Create independent copy of the object.
+         * 
+         * Source is copied, table is shared.
+         * 
+         * @return pointer to new object
+         */
+        virtual SurrogateWeyl* clone() const override;
+
+        /**
+         * @brief Get largest difference between surrogate and source found
+         * in sample points during construction.
+         * 
+         * Differences are sampled in centers and middles of edges of leaf
+         * patches, so this is an estimate, not a bound of error.
+         * 
+         * @return sampled error of \f$\nu\f$ and its first derivatives
+         */
+        real get_sampled_error() const;
+
+        /**
+         * @brief Get number of patches (including inner nodes of quadtrees).
+         * 
+         * @return number of patches
+         */
+        int get_number_of_patches() const;
+
         virtual void calculate_lambda_init(const real* y) override;
         virtual void calculate_lambda_run(const real* y) override;
 
@@ -0,0 +1,226 @@
+/**
+ * @file batchintegrator.hpp
+ * @author Karel Kraus
+ * @brief Integrator for solving many independent trajectories in lockstep.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/integrator/odesystem.hpp"
+#include "gravitacek2/integrator/stepperbase.hpp"
+#include "gravitacek2/integrator/stepcontrollerbase.hpp"
+#include "gravitacek2/integrator/event.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+
+namespace gr2
+{
+    /**
+     * @brief System of ODEs consisting of independent copies of one system.
+     *
+     * Values are stored in structure-of-arrays layout: variable `i` of lane
+     * `l` has index `i*lanes + l`. Every lane has its own time \f$t_l\f$ and
+     * step size \f$h_l\f$. System is integrated in time \f$\tau\f$ and lane
+     * evaluates
+     * \f[
+     * \dv{\vec{y}_l}{\tau} = h_l \vec{f}(t_l + h_l\tau, \vec{y}_l),
+     * \f]
+     * so one step of length 1 in \f$\tau\f$ is step of length \f$h_l\f$ in
+     * every lane. Lanes with zero step size do not change and they are not
+     * evaluated at all (finished lane can stop in a state where right side
+     * is not defined), other lanes are compacted and evaluated by one call of
+     * OdeSystem::function_batch().
+     */
+    class BatchOdeSystem : public OdeSystem
+    {
+    protected:
+        std::shared_ptr<OdeSystem> ode; //!<system solved in every lane
+        int lanes;                      //!<number of lanes
+        int m;                          //!<number of equations in one lane
+
+        real *t_lane;       //!<time at the beginning of the step for each lane
+        real *h_lane;       //!<step size for each lane
+        real *t_eval;       //!<time of evaluation for each active lane
+        int *active;        //!<indices of active lanes
+        real *y_active;     //!<values of active lanes
+        real *dydt_active;  //!<derivatives of active lanes
+
+    public:
+        /**
+         * @brief Construct a new BatchOdeSystem object.
+         *
+         * @param ode system solved in every lane
+         * @param lanes number of lanes
+         */
+        BatchOdeSystem(std::shared_ptr<OdeSystem> ode, const int &lanes);
+
+        /**
+         * @brief Destroy the BatchOdeSystem object.
+         *
+         */
+        ~BatchOdeSystem();
+
+        /**
+         * @brief Set time and step size of lane.
+         *
+         * @param lane index of lane
+         * @param t time at the beginning of the step
+         * @param h step size (zero for inactive lane)
+         */
+        void set_lane(const int &lane, const real &t, const real &h);
+
+        /**
+         * @brief Get number of lanes.
+         *
+         * @return number of lanes
+         */
+        int get_lanes() const;
+
+        virtual void function(const real &tau, const real y[], real dydt[]) override;
+    };
+
+    /**
+     * @brief State of trajectory in BatchIntegrator.
+     */
+    enum class LaneState
+    {
+        running,    //!<trajectory is being integrated
+        finished,   //!<trajectory reached final time
+        terminated, //!<trajectory was stopped by terminal event
+        failed,     //!<optimal step size was not found
+    };
+
+    /**
+     * @brief Integrator for solving many trajectories of one ODE system at once.
+     *
+     * All trajectories (lanes) are advanced by one step of the stepper applied
+     * to BatchOdeSystem. Every lane has its own step size, step size control
+     * and events. Lanes with rejected step are not changed and try again with
+     * smaller step in the next step of the batch, lanes which finished are
+     * masked out.
+     *
+     * Only data events are supported, they are called without stepper (dense
+     * output is not available).
+     */
+    class BatchIntegrator
+    {
+    protected:
+        // ========== Components of integrator ==========
+        std::shared_ptr<OdeSystem> ode;         //!<system solved in every lane
+        std::shared_ptr<BatchOdeSystem> batch;  //!<system of all lanes
+        StepperBase *stepper;                   //!<stepper used for integration
+        StepControllerBase *stepcontroller;     //!<step controller (shared by lanes)
+
+        int lanes;  //!<number of lanes
+        int n;      //!<number of equations in one lane
+
+        // ========== Events ==========
+        std::vector<std::vector<std::shared_ptr<Event>>> events;   //!<data events of each lane
+
+        // ========== State of lanes ==========
+        real *t;            //!<current time of each lane
+        real *h;            //!<current step size of each lane
+        real *h_step;       //!<step size used in current step of each lane
+        int *rejections;    //!<number of consecutive rejected steps of each lane
+        LaneState *state;   //!<state of each lane
+
+        // ========== Values in structure-of-arrays layout ==========
+        real *yt;       //!<current values of \f$\vec{y}\f$
+        real *yt2;      //!<values of \f$\vec{y}\f$ for trying next step
+        real *f;        //!<current values of \f$\frac{\mathrm{d} \vec{y}}{\mathrm{d} t}\f$
+        real *dydt_in;  //!<derivatives with respect to \f$\tau\f$ at the beginning of the step
+        real *dydt_out; //!<derivatives with respect to \f$\tau\f$ at the end of the step
+        real *err;      //!<estimates of error
+
+        // ========== Values of one lane ==========
+        real *y_lane;   //!<state vector of one lane
+        real *f_lane;   //!<derivative of state vector of one lane
+        real *err_lane; //!<error of one lane
+
+        /**
+         * @brief Copy values of one lane from structure-of-arrays layout.
+         *
+         * @param lane index of lane
+         * @param from array in structure-of-arrays layout
+         * @param to array of one lane
+         * @param factor multiplication factor
+         */
+        void gather(const int &lane, const real from[], real to[], const real &factor = 1) const;
+
+        /**
+         * @brief Copy values of one lane into structure-of-arrays layout.
+         *
+         * @param lane index of lane
+         * @param from array of one lane
+         * @param to array in structure-of-arrays layout
+         */
+        void scatter(const int &lane, const real from[], real to[]) const;
+
+    public:
+        /**
+         * @brief Construct a new BatchIntegrator object.
+         *
+         * Step size is controlled by StepControllerNR (as in Integrator).
+         *
+         * @param ode ODEs solved in every lane
+         * @param lanes number of trajectories
+         * @param stepper_name name of stepper
+         * @param atol absolute error tolerance
+         * @param rtol relative error tolerance
+         */
+        BatchIntegrator(std::shared_ptr<OdeSystem> ode, const int &lanes, const std::string& stepper_name, const real &atol, const real &rtol);
+
+        /**
+         * @brief Destroy the BatchIntegrator object.
+         *
+         */
+        ~BatchIntegrator();
+
+        /**
+         * @brief Add data event for one lane.
+         *
+         * @param lane index of lane
+         * @param event data event
+         */
+        void add_event(const int &lane, std::shared_ptr<Event> event);
+
+        /**
+         * @brief Integrate all trajectories.
+         *
+         * @param y initial values, `y[l*n + i]` is variable `i` of lane `l`
+         * (on return final values)
+         * @param t_start initial time
+         * @param t_end final time
+         * @param h_start initial time step
+         */
+        void integrate(real y[], const real &t_start, const real &t_end, const real &h_start);
+
+        /**
+         * @brief Get number of lanes.
+         *
+         * @return number of lanes
+         */
+        int get_lanes() const;
+
+        /**
+         * @brief Get time of lane.
+         *
+         * @param lane index of lane
+         * @return time reached by the lane
+         */
+        real get_t(const int &lane) const;
+
+        /**
+         * @brief Get state of lane.
+         *
+         * @param lane index of lane
+         * @return state of lane
+         */
+        LaneState get_state(const int &lane) const;
+    };
+}
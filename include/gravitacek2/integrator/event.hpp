@@ -35,14 +35,16 @@ namespace gr2
     protected:
         EventType type; //!<type of event
         bool terminal;  //!<is event terminal for integration
+        bool dense;     //!<does event use dense output of stepper
     public:
          /**
           * @brief Construct a new Event object.
           * 
           * @param type type of event
           * @param terminal true if event should stop the itnegration
+          * @param dense true if event uses dense output of stepper in apply
           */
-        Event(const EventType& type, const bool &terminal=false);
+        Event(const EventType& type, const bool &terminal=false, const bool &dense=false);
 
         /**
          * @brief Get type of event.
@@ -56,6 +58,12 @@ namespace gr2
         */
         bool get_terminal() const;
 
+       /**
+        * @brief Get if the event uses dense output of stepper.
+        * 
+        */
+        bool get_dense() const;
+
         /**
          * @brief Return value of internal function of the event.
          * 
@@ -84,5 +92,20 @@ namespace gr2
          * @param dydt derivate of coordinate \f$\vec{y}\f$ with respect to \f$t\f$
          */
         virtual void apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[]) = 0;
+
+        /**
+         * @brief Get hyperplane of the event.
+         * 
+         * If the event is triggered on hyperplane \f$y_k = c\f$, Integrator
+         * lands on it by one step with \f$y_k\f$ as independent variable
+         * (Hénon's trick) instead of root finding. Default implementation
+         * returns false.
+         * 
+         * @param y coordinate variables at the beginning of the step
+         * @param index index \f$k\f$ of coordinate
+         * @param value value \f$c\f$ of coordinate on hyperplane
+         * @return true if the event is given by hyperplane
+         */
+        virtual bool get_section(const real y[], int &index, real &value);
     };
 }
\ No newline at end of file
@@ -16,9 +16,42 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <limits>
 
 namespace gr2
 {
+    /**
+     * @brief Statistics of one integration collected by Integrator.
+     */
+    struct IntegratorStatistics
+    {
+        long rhs_evaluations;       //!<number of evaluations of right side of ODEs
+        long accepted_steps;        //!<number of accepted steps
+        long rejected_steps;        //!<number of rejected steps (including steps discarded by drift of conserved quantity)
+        long hadjust_iterations;    //!<number of calls of step controller
+        long event_iterations;      //!<number of iterations of root finding in solve_event (on dense output and by steps)
+        long event_steps;           //!<number of steps taken by solve_event
+        long events;                //!<number of applied modifying events
+        long promotions;            //!<number of promotions of tolerance
+        real h_min;                 //!<minimal length of accepted step
+        real h_max;                 //!<maximal length of accepted step
+        double time_events;         //!<wall time spent in modifying events (root finding and application) in seconds
+        double time_total;          //!<wall time of integration in seconds
+
+        /**
+         * @brief Set all values to zero.
+         */
+        void reset();
+
+        /**
+         * @brief Write statistics into one line of text.
+         *
+         * @return text with statistics
+         */
+        std::string to_string() const;
+    };
+
     /**
      * @brief Integrator for solving ODEs.
      * 
@@ -72,6 +105,26 @@ namespace gr2
         real *err2;     //!<array for calculating error when trying new step
         real *err3;     //!<array for calculating error in event
 
+        // ========== Promotion of tolerance ==========
+        StepControllerBase *stepcontroller_fine;        //!<step controller with tighter tolerance (nullptr if promotion is not used)
+        std::function<real(const real y[])> quantity;   //!<monitored conserved quantity
+        real quantity_limit;        //!<maximal drift of monitored quantity from reference value
+        real quantity_reference;    //!<reference value of monitored quantity (NaN for value at the beginning of integration)
+        int demotion_steps;         //!<number of steps with tighter tolerance before returning to basic tolerance (0 for never)
+        real promotion_time;        //!<time of first promotion during last integration (NaN if tolerance was not promoted)
+
+        // ========== Statistics ==========
+        bool statistics_enabled;                        //!<true if statistics are collected
+        IntegratorStatistics statistics;                //!<statistics of last integration
+        std::shared_ptr<CountingOdeSystem> counting_ode; //!<system counting evaluations (nullptr if statistics are not collected)
+
+        // ========== Sections (Hénon's trick) ==========
+        std::string stepper_name;                   //!<name of stepper
+        StepperBase *stepper_section;               //!<stepper for landing on hyperplane (nullptr if not used yet)
+        std::shared_ptr<HenonOdeSystem> henon_ode;  //!<system with coordinate as independent variable
+        real *y_section;                            //!<values of \f$\vec{y}\f$ and \f$t\f$ for landing on hyperplane
+        real *err_section;                          //!<error of landing on hyperplane
+
         // ========== Other variables ==========
         bool dense; //!<true if dense output should be used
 
@@ -90,14 +143,54 @@ namespace gr2
         void init_stepper(const std::string& stepper_name);
         //TODO: This should be done using enum
 
+        /**
+         * @brief Land on hyperplane of event by one step with coordinate as
+         * independent variable (Hénon's trick).
+         * 
+         * Values are saved to `yt3`, `dydt3`, `err3`, `t3` and `h3`. If the
+         * error is not accepted by step controller, the interval of
+         * coordinate is divided into more steps. Landing is not used if the
+         * coordinate is not monotonous within the last step (grazing
+         * crossing) or if the error is still too large, root is then found
+         * on dense output.
+         * 
+         * @param index index of coordinate
+         * @param value value of coordinate on hyperplane
+         * @param controller step controller of current step (nullptr if error is not checked)
+         * @return true if the hyperplane was reached within the last step
+         */
+        bool solve_section(const int &index, const real &value, StepControllerBase *controller);
+
         /**
          * @brief Try to trigger the event.
          * 
+         * Events given by hyperplane (Event::get_section) are solved by
+         * solve_section.
+         * 
+         * Root of the event is found on dense output of the last step
+         * (Illinois method) and only one step is taken to land on it. If the
+         * event is not precise enough after this step, root is refined by
+         * secant method with repeated steps.
+         * 
+         * Stepper has to contain the last step calculated with dense output.
+         * 
          * @param event event that we study
          * @param previous_value_of_event previous value of given event
+         * @param controller step controller of current step (nullptr if error is not checked)
          * @return true if event is triggered, else false
          */
-        bool solve_event(std::shared_ptr<Event> event, const real& previous_value_of_event);
+        bool solve_event(std::shared_ptr<Event> event, const real& previous_value_of_event, StepControllerBase *controller);
+
+        /**
+         * @brief Integrate ordinary differential equation (without
+         * finalization of statistics).
+         *
+         * @param y_start initial coordinate values
+         * @param t_start intial time
+         * @param t_end final time
+         * @param h_start initial time step
+         */
+        void integrate_steps(const real y_start[], const real &t_start, const real &t_end, const real &h_start);
 
     public:
         /**
@@ -133,10 +226,76 @@ namespace gr2
         /**
          * @brief Add event for integration.
          * 
+         * If the event uses dense output, steps are calculated with dense
+         * output.
+         * 
          * @param event event for integration
          */
         void add_event(std::shared_ptr<Event> event);
 
+        /**
+         * @brief Use tighter tolerance while conserved quantity drifts.
+         *
+         * After every accepted step, `quantity` is compared with its
+         * reference value. If it differs by more than `limit`, the step is
+         * discarded and integration returns to the checkpoint, the last
+         * accepted point (no events are called for the discarded step).
+         *
+         * - With basic tolerance, tolerance is promoted to `atol_fine` and
+         *   `rtol_fine` and the step is repeated.
+         * - With tighter tolerance, the step is repeated with half step size.
+         *   If the drift can not be kept under `limit` even by
+         *   `MAX_ITERATIONS_HADJUST` halvings, std::runtime_error is thrown.
+         *
+         * After `demotion_steps` accepted steps with tighter tolerance,
+         * integration returns to basic tolerance. If the trajectory is still
+         * in sensitive region, the next step is discarded again and tolerance
+         * is promoted again.
+         *
+         * Only tolerance is promoted, precision of arithmetic (gr2::real) is
+         * given at compile time and it is the same for both tolerances.
+         *
+         * Requires integrator with step controller.
+         *
+         * @param quantity conserved quantity as a function of \f$\vec{y}\f$
+         * @param limit maximal drift of quantity from reference value
+         * @param atol_fine absolute error tolerance after promotion
+         * @param rtol_fine relative error tolerance after promotion
+         * @param reference reference value of quantity (e.g. \f$E_0\f$ or \f$L_0\f$), if it is NaN, value at the beginning of integration is used
+         * @param demotion_steps number of steps with tighter tolerance before returning to basic tolerance (0 for never)
+         */
+        void set_tolerance_promotion(std::function<real(const real y[])> quantity, const real &limit, const real &atol_fine, const real &rtol_fine, const real &reference = std::numeric_limits<real>::quiet_NaN(), const int &demotion_steps = 100);
+
+        /**
+         * @brief Get time, when tolerance was promoted for the first time
+         * during last integration.
+         *
+         * @return time of first promotion (NaN if tolerance was not promoted)
+         */
+        real get_promotion_time() const;
+
+        /**
+         * @brief Enable or disable collection of statistics.
+         *
+         * When statistics are disabled (default), integration is not
+         * influenced. When enabled, stepper evaluates ODEs through
+         * CountingOdeSystem and integrate() measures time of events and of
+         * the whole integration.
+         *
+         * @param enable true if statistics should be collected
+         */
+        void enable_statistics(const bool &enable = true);
+
+        /**
+         * @brief Get statistics of last integration.
+         *
+         * Statistics are available also if the integration was stopped by an
+         * exception.
+         *
+         * @return statistics of last integration
+         */
+        const IntegratorStatistics& get_statistics() const;
+
         /**
          * @brief Integrate ordinary differential equation
          * 
@@ -29,6 +29,9 @@ namespace gr2
     {
     protected:
         int n; //!<number of ordinary differential equations
+
+        std::vector<real> batch_y;      //!<state vector of one lane (used by function_batch())
+        std::vector<real> batch_dydt;   //!<derivative of state vector of one lane (used by function_batch())
     public:
         /**
          * @brief Construct a new OdeSystem object
@@ -57,6 +60,21 @@ namespace gr2
          * with respect to \f$t\f$
          */
         virtual void function(const real &t, const real y[], real dydt[]) = 0;
+
+        /**
+         * @brief Calculate derivatives of more independent states at once.
+         *
+         * Values are stored in structure-of-arrays layout: variable `i` of
+         * lane `l` has index `i*lanes + l`. Default implementation calls
+         * function() for every lane. Systems can override it with loops over
+         * lanes, which can be vectorised by compiler.
+         *
+         * @param lanes number of lanes
+         * @param t time value of each lane
+         * @param y coordinate values of all lanes
+         * @param dydt array for returning derivatives of all lanes
+         */
+        virtual void function_batch(const int &lanes, const real t[], const real y[], real dydt[]);
     };
 
     /**
@@ -85,4 +103,84 @@ namespace gr2
         CombinedOdeSystem(std::vector<std::shared_ptr<OdeSystem>> odes);
         void function(const real &t, const real y[], real dydt[]) override;
     };
-}
\ No newline at end of file
+
+    /**
+     * @brief OdeSystem counting evaluations of another OdeSystem.
+     *
+     * Every call of function() is passed to the wrapped system and counted.
+     */
+    class CountingOdeSystem : public OdeSystem
+    {
+    protected:
+        std::shared_ptr<OdeSystem> ode; //!<wrapped system
+        long evaluations;               //!<number of evaluations
+
+    public:
+        /**
+         * @brief Construct a new CountingOdeSystem object.
+         *
+         * @param ode wrapped system
+         */
+        CountingOdeSystem(std::shared_ptr<OdeSystem> ode);
+
+        /**
+         * @brief Get number of evaluations.
+         *
+         * @return number of calls of function()
+         */
+        long get_evaluations() const;
+
+        /**
+         * @brief Set number of evaluations to zero.
+         */
+        void reset_evaluations();
+
+        void function(const real &t, const real y[], real dydt[]) override;
+    };
+
+    /**
+     * @brief OdeSystem with one coordinate as independent variable (Hénon's
+     * trick).
+     *
+     * System \f$\dv{\vec{y}}{t} = \vec{f}(t, \vec{y})\f$ is rewritten
+     * with coordinate \f$s = y_k\f$ as independent variable
+     * \f[
+     * \dv{\vec{y}}{s} = \frac{\vec{f}}{f_k}, \quad \dv{t}{s} = \frac{1}{f_k}.
+     * \f]
+     * Time \f$t\f$ is the last variable, so the system has \f$n+1\f$
+     * equations. One step of length \f$\Delta s\f$ lands exactly on the
+     * hyperplane \f$y_k = s + \Delta s\f$. If \f$f_k\f$ vanishes,
+     * std::domain_error is thrown.
+     */
+    class HenonOdeSystem : public OdeSystem
+    {
+    protected:
+        std::shared_ptr<OdeSystem> ode; //!<original system
+        int index;                      //!<index \f$k\f$ of coordinate used as independent variable
+
+    public:
+        /**
+         * @brief Construct a new HenonOdeSystem object.
+         *
+         * @param ode original system
+         * @param index index of coordinate used as independent variable
+         */
+        HenonOdeSystem(std::shared_ptr<OdeSystem> ode, const int &index);
+
+        /**
+         * @brief Get original system.
+         *
+         * @return original system
+         */
+        std::shared_ptr<OdeSystem> get_ode() const;
+
+        /**
+         * @brief Set index of coordinate used as independent variable.
+         *
+         * @param index index of coordinate
+         */
+        void set_index(const int &index);
+
+        void function(const real &s, const real y[], real dydt[]) override;
+    };
+}
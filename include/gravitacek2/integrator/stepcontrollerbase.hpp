@@ -27,6 +27,12 @@ namespace gr2
          */
         StepControllerBase(const int &n);
 
+        /**
+         * @brief Destroy the StepControllerBase object.
+         * 
+         */
+        virtual ~StepControllerBase();
+
         /**
          * @brief Calculate new step size.
          * 
@@ -43,6 +43,8 @@ namespace gr2
         real t_in;  //!<value of time variable at the beginning of the step
         real h;     //!<length of the time step
         int n;      //!<number of differential equations
+
+        bool dense_pending; //!<true if the last step was calculated for dense output, which was not prepared yet
     public:
         /**
          * @brief Construct a new StepperBase object.
@@ -65,6 +67,13 @@ namespace gr2
          */
         virtual void set_OdeSystem(std::shared_ptr<OdeSystem> ode);
 
+        /**
+         * @brief Get ODE of stepper.
+         * 
+         * @return integrated OdeSystem
+         */
+        std::shared_ptr<OdeSystem> get_OdeSystem() const;
+
         /**
          * @brief Calculate next step.
          * 
@@ -125,6 +134,9 @@ namespace gr2
 
         /**
          * @brief Prepare stepper for dense output.
+         * 
+         * Dense output is prepared automatically on the first request after
+         * the step, calling this method is not necessary.
          */
         virtual void prepare_dense();
 
@@ -139,6 +151,26 @@ namespace gr2
          */
         virtual real dense_out(const int& i, const real &t);
 
+        /**
+         * @brief Return dense output of all coordinates.
+         * 
+         * Interpolation polynomial is evaluated for all coordinates at once.
+         * 
+         * @param t time for evaluation
+         * @param y array of length \f$n\f$ for storing values of coordinates
+         */
+        virtual void dense_out_all(const real &t, real y[]);
+
+        /**
+         * @brief Return dense output of all coordinates for several times.
+         * 
+         * @param m number of times
+         * @param ts times for evaluation
+         * @param Y arrays of length \f$n\f$ for storing values, `Y[k][i]`
+         * is value of i-th coordinate given the time `ts[k]`
+         */
+        virtual void dense_out_many(const int &m, const real ts[], real *Y[]);
+
         /**
          * @brief Get order of precision for stepper.
          * 
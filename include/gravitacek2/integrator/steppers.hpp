@@ -101,5 +101,7 @@ namespace gr2
         virtual int get_err_order() const override;
         virtual void prepare_dense() override;
         virtual real dense_out(const int& i, const real &t) override;
+        virtual void dense_out_all(const real &t, real y[]) override;
+        virtual void dense_out_many(const int &m, const real ts[], real *Y[]) override;
     };
 }
\ No newline at end of file
@@ -84,7 +84,7 @@ namespace gr2
 
             // ========== Checking precision ==========
             if (j >= std::max(JMIN - 1, K + 1))
-                if (fabsl(R[K - 1][j] - R[K - 1][j - 1]) < eps * (fabsl(R[K - 1][j - 1]) + 1))
+                if (std::abs(R[K - 1][j] - R[K - 1][j - 1]) < eps * (std::abs(R[K - 1][j - 1]) + 1))
                     return R[K - 1][j];
         }
         // ========== Throw error ==========
@@ -133,6 +133,27 @@ namespace gr2
     */
     void legendre_polynomials1(const real& x, const int& n, real* p0, real* p1);
 
+    /**
+     * @brief Calculate \f$n\f$ Legendre polynomials and their first and second
+     * derivatives.
+     * 
+     * Values and first derivatives are calculated as in
+     * legendre_polynomials1(). Second derivatives are calculated using
+     * reccurent expression:
+     * \f{align*}
+     * P_0''(x) &= 0,\\
+     * P_1''(x) &= 0, \\
+     * P_{n+1}''(x) &= (n+2)P_n'(x) + x P_n''(x).
+     * \f}
+     * 
+     * @param x argument for Legendre polynomials
+     * @param n number of calculated Legendre polynomials
+     * @param p0 array for saving Legendre polynomials
+     * @param p1 array for saving first derivatives of Legendre polynomials
+     * @param p2 array for saving second derivatives of Legendre polynomials
+     */
+    void legendre_polynomials2(const real& x, const int& n, real* p0, real* p1, real* p2);
+
     /**
      * @brief Calculate n values of special function \f$\mathcal{Q}_{2n}\f$.
      * 
@@ -180,6 +201,106 @@ namespace gr2
      */
     void special_function_Q2n1(const real& x, const int& n, real* q0, real* q1);
 
+    /**
+     * @brief Calculate n values of special function \f$\mathcal{Q}_{2n}\f$ and
+     * its first and second derivatives.
+     * 
+     * Definition of the function is the same as in special_function_Q2n1(),
+     * second derivatives are obtained by differentiating the reccurent
+     * expression once more.
+     * 
+     * @param x argument for special function
+     * @param n number of calculated values
+     * @param q0 array for saving values
+     * @param q1 array for saving first derivatives
+     * @param q2 array for saving second derivatives
+     */
+    void special_function_Q2n2(const real& x, const int& n, real* q0, real* q1, real* q2);
+
+    /**
+     * @brief Calculate potential of a rod and its first and second
+     * derivatives.
+     * 
+     * Potential of rod with half-length \f$M\f$ (and mass \f$M\f$) placed on
+     * the axis between \f$z=-M\f$ and \f$z=M\f$ is
+     * \f[
+     * \Phi = \frac{1}{2}\ln\frac{d_1 + d_2 - 2M}{d_1 + d_2 + 2M}, \qquad
+     * d_{1,2} = \sqrt{\rho^2 + (z\mp M)^2}.
+     * \f]
+     * Derivatives are obtained by chain rule through \f$s = d_1 + d_2\f$.
+     * The kernel contains no branches or loops.
+     * 
+     * @param rho coordinate \f$\rho\f$
+     * @param z coordinate \f$z\f$
+     * @param M half-length of the rod
+     * @param f array for saving \f$\Phi, \Phi_{,\rho}, \Phi_{,z},
+     * \Phi_{,\rho\rho}, \Phi_{,\rho z}, \Phi_{,zz}\f$
+     */
+    void rod_potential2(const real& rho, const real& z, const real& M, real* f);
+
+    /**
+     * @brief Calculate potential of a ring and its first and second
+     * derivatives.
+     * 
+     * Potential of ring with unit mass and radius \f$b\f$ placed in the
+     * equatorial plane is
+     * \f[
+     * \Phi = -\frac{2K(k)}{\pi l_2}, \qquad k = \sqrt{\frac{4\rho b}{l_2^2}},
+     * \qquad l_{1,2} = \sqrt{(\rho\mp b)^2 + z^2}.
+     * \f]
+     * Derivatives of elliptic integrals are eliminated using
+     * \f$\dv*{E}{k} = (E - K)/k\f$ and \f$\Phi_{,\rho\rho}\f$ is obtained from
+     * Laplace equation. Differences \f$(K - E)/k^2\f$ and
+     * \f$((2 - k^2)K - 2E)/k^4\f$ are summed by AGM, so
+     * \f$\Phi_{,\rho}/\rho\f$ is evaluated without cancellation and all
+     * derivatives stay finite on the axis \f$\rho = 0\f$.
+     * 
+     * @param rho coordinate \f$\rho\f$
+     * @param z coordinate \f$z\f$
+     * @param b radius of the ring
+     * @param f array for saving \f$\Phi, \Phi_{,\rho}, \Phi_{,z},
+     * \Phi_{,\rho\rho}, \Phi_{,\rho z}, \Phi_{,zz}\f$
+     */
+    void ring_potential2(const real& rho, const real& z, const real& b, real* f);
+
+    /**
+     * @brief Calculate potential of a ring and its first derivatives.
+     * 
+     * See ring_potential2().
+     * 
+     * @param rho coordinate \f$\rho\f$
+     * @param z coordinate \f$z\f$
+     * @param b radius of the ring
+     * @param f array for saving \f$\Phi, \Phi_{,\rho}, \Phi_{,z}\f$
+     */
+    void ring_potential1(const real& rho, const real& z, const real& b, real* f);
+
+    /**
+     * @brief Calculate eigenvalues of general real 4x4 matrix.
+     *
+     * Matrix is reduced to upper Hessenberg form by Householder reflections
+     * and eigenvalues are found by Francis double shift QR iteration. The
+     * matrix is copied to a fixed-size array, so no memory is allocated and
+     * the routine is suitable for matrices evaluated many times.
+     *
+     * @param a matrix \f$4\times 4\f$ stored by rows
+     * @param re array for saving real parts of eigenvalues
+     * @param im array for saving imaginary parts of eigenvalues
+     */
+    void eigenvalues_nonsymm4(const real* a, real* re, real* im);
+
+    /**
+     * @brief Calculate eigenvalues of real symmetric matrix.
+     *
+     * Cyclic Jacobi method is used. Matrix is overwritten and no memory is
+     * allocated.
+     *
+     * @param n size of matrix
+     * @param a symmetric matrix \f$n\times n\f$ stored by rows (overwritten)
+     * @param eig array for saving eigenvalues
+     */
+    void eigenvalues_symm(const int& n, real* a, real* eig);
+
     /**
      * @brief Numerically differentiate function. 
      * 
@@ -219,7 +340,7 @@ namespace gr2
 
             // ========== Checking precision ==========
             if (j >= std::max(JMIN - 1, K + 1))
-                if (fabsl(R[K - 1][j] - R[K - 1][j - 1]) < eps * (fabsl(R[K - 1][j - 1]) + 1))
+                if (std::abs(R[K - 1][j] - R[K - 1][j - 1]) < eps * (std::abs(R[K - 1][j - 1]) + 1))
                     return R[K - 1][j];
 
         }
@@ -266,7 +387,7 @@ namespace gr2
 
             // ========== Checking precision ==========
             if (j >= std::max(JMIN - 1, K + 1))
-                if (fabsl(R[K - 1][j] - R[K - 1][j - 1]) < eps * (fabsl(R[K - 1][j - 1]) + 1))
+                if (std::abs(R[K - 1][j] - R[K - 1][j - 1]) < eps * (std::abs(R[K - 1][j - 1]) + 1))
                     return R[K - 1][j];
 
         }
@@ -8,7 +8,13 @@ namespace gr2
 {
 // ========== Types ========== 
 
+#ifdef GR2_REAL_DOUBLE
+typedef double real;                    //!<type for real numbers (build with GR2_PRECISION=double)
+#define GR2_SCN_REAL "lf"               //!<scanf conversion for real
+#else
 typedef long double real;               //!<default type for real numbers
+#define GR2_SCN_REAL "Lf"               //!<scanf conversion for real
+#endif
 typedef real (*realfunction)(real);     //!<type of real function
 
 
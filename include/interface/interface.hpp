@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 
+#include "interface/parallelsweep.hpp"
 #include "gravitacek2/setup.hpp"
 #include "gravitacek2/geomotion/geomotion.hpp"
 #include "gravitacek2/geomotion/weyl.hpp"
@@ -20,6 +21,10 @@ protected:
     std::vector<std::string> help_name; //!<vector of help names
     std::vector<std::string> help_text; //!<vector of texts for help
 
+    // ==================== Settings ==================== 
+    bool print_statistics;  //!<true if statistics of integrator are printed for every trajectory
+    gr2::real promotion_tolerance;  //!<basic tolerance of integrator with promotion of tolerance on drift of E and L (0 if promotion is not used)
+
     /**
      * @brief Substitute text using macros.
      * 
@@ -99,6 +104,25 @@ protected:
      */
     void help(std::string text);
 
+    /**
+     * @brief Switch printing of integrator statistics for every trajectory.
+     * 
+     * @param text `on` or `off`
+     */
+    void set_statistics(std::string text);
+
+    /**
+     * @brief Switch promotion of tolerance on drift of E and L.
+     * 
+     * When promotion is on, trajectories are integrated with given basic
+     * tolerance and the usual tolerance of the command is used only while
+     * drift of E or L exceeds half of the limit for stopping the
+     * trajectory (see gr2::Integrator::set_tolerance_promotion()).
+     * 
+     * @param text basic tolerance or `off`
+     */
+    void set_promotion(std::string text);
+
     // ==================== Functions ==================== 
 
     /**
@@ -184,11 +208,29 @@ protected:
      */
     // void solve_ode_system(std::string text);
 
+    /**
+     * @brief Evaluate map in plane \f$\rho z\f$ in parallel.
+     * 
+     * Progress is printed on standard output, evaluation can be cancelled
+     * by `Ctrl+C` (points finished before are kept in output).
+     * 
+     * @param n_rho number of points in \f$\rho\f$
+     * @param n_z number of points in \f$z\f$
+     * @param n_threads number of threads (all hardware threads if not positive)
+     * @param create_worker function creating worker for given thread
+     * @param out output stream for data
+     */
+    void evaluate_map(int n_rho, int n_z, int n_threads, std::function<MapPointTask(int)> create_worker, std::ostream &out);
+
     /**
      * @brief Calculate values of local expansion for Weyl spacetime.
      * 
      * Argument should be in form:
-     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file)
+     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for local_expansions_weyl
      */
@@ -198,7 +240,11 @@ protected:
      * @brief Calculate values of local expansion for Weyl spacetime.
      * 
      * Argument should be in form:
-     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file)
+     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for local_expansions_mp
      */
@@ -208,7 +254,11 @@ protected:
      * @brief Calculate values of normg growth for Weyl spacetime.
      * 
      * Argument should be in form: 
-     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file)
+     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for norm_growth_weyl
      */
@@ -218,7 +268,11 @@ protected:
      * @brief Calculate values of normg growth for Majumdar-Papapetrou spacetime.
      *
      * Argument should be in form: 
-     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file)
+     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),angles,file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for norm_growth_mp
      */
@@ -228,7 +282,11 @@ protected:
      * @brief Calculate norm squared of velocity in plane \f$\rho z\f$.
      * 
      * Argument should be in form:
-     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),file)
+     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for rest_norm2_weyl
      */
@@ -238,7 +296,11 @@ protected:
      * @brief Calculate norm squared of velocity in plane \f$\rho z\f$.
      * 
      * Argument should be in form:
-     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),file)
+     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(z_min,z_max,n_z),file[,threads])
+     * 
+     * Points are evaluated in parallel on `threads` threads (all hardware
+     * threads if not given), values are written in the same order as in
+     * serial calculation.
      * 
      * @param text arguments for rest_norm2_mp
      */
@@ -268,7 +330,11 @@ protected:
      * @brief Calculate poincare section.
      * 
      * Argument should be in form:
-     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),angles,tmax,file)
+     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),angles,tmax,file[,threads])
+     * 
+     * Trajectories are integrated in parallel on `threads` threads (all
+     * hardware threads if not given), points of section are written in
+     * the same order as in serial calculation.
      * 
      * @param text arguments for poincare_section_weyl
      */
@@ -278,12 +344,48 @@ protected:
      * @brief Calculate poincare section.
      * 
      * Argument should be in form:
-     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),angles,tmax,file)
+     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),angles,tmax,file[,threads])
+     * 
+     * Trajectories are integrated in parallel on `threads` threads (all
+     * hardware threads if not given), points of section are written in
+     * the same order as in serial calculation.
      * 
      * @param text arguments for poincare_section_weyl
      */
     void poincare_section_mp(std::string text);
 
+    /**
+     * @brief Calculate map of chaos indicators (MEGNO, FLI, SALI).
+     *
+     * Argument should be in form:
+     * (weyl_spacetime(weyl_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(u_min,u_max,n_u),tmax,file[,threads])
+     *
+     * Orbits start in equatorial plane with \f$u^\rho\f$ given as fraction
+     * `u` of rest velocity. Integration stops when MEGNO classifies the
+     * orbit (not sooner than in tmax/10). Every line of output is
+     * `rho;u;megno;fli;sali;t_end;class`, where class is 0 (undecided),
+     * 1 (regular) or 2 (chaotic).
+     *
+     * @param text arguments for chaos_indicators_weyl
+     */
+    void chaos_indicators_weyl(std::string text);
+
+    /**
+     * @brief Calculate map of chaos indicators (MEGNO, FLI, SALI).
+     *
+     * Argument should be in form:
+     * (mp_spacetime(mp_spacetimes_params),E,L,(rho_min,rho_max,n_rho),(u_min,u_max,n_u),tmax,file[,threads])
+     *
+     * Orbits start in equatorial plane with \f$u^\rho\f$ given as fraction
+     * `u` of rest velocity. Integration stops when MEGNO classifies the
+     * orbit (not sooner than in tmax/10). Every line of output is
+     * `rho;u;megno;fli;sali;t_end;class`, where class is 0 (undecided),
+     * 1 (regular) or 2 (chaotic).
+     *
+     * @param text arguments for chaos_indicators_mp
+     */
+    void chaos_indicators_mp(std::string text);
+
     /**
      * @brief Calculate numerical expansions for Weyl spacetime.
      * 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <ostream>
+#include <atomic>
+
+/**
+ * @brief Result of one task of parallel sweep.
+ */
+struct SweepResult
+{
+    std::string data;   //!<text written into output (in order of tasks)
+    std::string log;    //!<text written on standard output (in order of completion)
+};
+
+/**
+ * @brief Task of parallel sweep. Argument is index of task.
+ */
+typedef std::function<SweepResult(int)> SweepTask;
+
+/**
+ * @brief Solve independent tasks on several threads.
+ *
+ * Every thread gets its own worker created by `create_worker` (called
+ * serially before threads are started), so workers do not have to share
+ * any state. Threads take indices of tasks from common queue, so long
+ * tasks do not block other threads. Data of tasks are written into `out`
+ * in order of indices, independently on number of threads.
+ *
+ * @param n_tasks number of tasks
+ * @param n_threads number of threads (if not positive, number of hardware threads is used)
+ * @param create_worker function creating worker for given thread
+ * @param out output stream for data
+ */
+void parallel_sweep(int n_tasks, int n_threads, std::function<SweepTask(int)> create_worker, std::ostream &out);
+
+/**
+ * @brief Task of parallel map. Arguments are indices of point in the grid,
+ * returned text is written into output (it can be empty).
+ */
+typedef std::function<std::string(int, int)> MapPointTask;
+
+/**
+ * @brief Progress of parallel map. Arguments are number of evaluated points
+ * and number of all points.
+ */
+typedef std::function<void(long, long)> MapProgress;
+
+/**
+ * @brief Evaluate function on 2D grid on several threads.
+ *
+ * Grid `n_rows` x `n_cols` is divided into square tiles, which are taken by
+ * threads from common queue. Every thread gets its own worker created by
+ * `create_worker` (called serially before threads are started). Results are
+ * written into `out` row by row (point `(i,j)` before `(i,j+1)` and
+ * `(i+1,0)`), i.e. in the same order as in serial double loop, as soon as
+ * the whole row of tiles is finished.
+ *
+ * Evaluation stops when `cancel` is set, everything finished before is
+ * already written. `progress` is called (from one thread at a time) after
+ * every finished tile.
+ *
+ * @param n_rows number of rows of the grid
+ * @param n_cols number of columns of the grid
+ * @param n_threads number of threads (if not positive, number of hardware threads is used)
+ * @param create_worker function creating worker for given thread
+ * @param out output stream for data
+ * @param cancel flag for cancellation of evaluation (can be null)
+ * @param progress function reporting progress (can be empty)
+ * @param tile_size size of side of tile
+ * @return true if the whole grid was evaluated
+ * @return false if evaluation was cancelled
+ */
+bool parallel_map(int n_rows, int n_cols, int n_threads, std::function<MapPointTask(int)> create_worker, std::ostream &out, const std::atomic<bool> *cancel = nullptr, MapProgress progress = nullptr, int tile_size = 16);
+
+/**
+ * @brief Get number of threads from optional argument.
+ *
+ * @param text argument (empty string means all hardware threads)
+ * @return number of threads
+ */
+int number_of_threads(const std::string &text);
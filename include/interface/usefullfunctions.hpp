@@ -62,6 +62,14 @@ public:
         return (y[gr2::Weyl::Z]+sign*this->z);
     }
 
+    virtual bool get_section(const gr2::real y[], int &index, gr2::real &value) override
+    {
+        int sign = y[gr2::Weyl::UZ]>0?1:-1;
+        index = gr2::Weyl::Z;
+        value = -sign*this->z;
+        return true;
+    }
+
     virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
     {
         if (poincare)
@@ -92,6 +100,14 @@ public:
         return (y[gr2::Weyl::Z]+sign*this->z);
     }
 
+    virtual bool get_section(const gr2::real y[], int &index, gr2::real &value) override
+    {
+        int sign = y[gr2::Weyl::UZ]>0?1:-1;
+        index = gr2::Weyl::Z;
+        value = -sign*this->z;
+        return true;
+    }
+
     virtual void apply(gr2::StepperBase* stepper, gr2::real &dt, gr2::real &t, gr2::real y[], gr2::real dydt[]) override
     {
         if (poincare)
@@ -170,7 +186,7 @@ public:
     {
         spt->calculate_metric(y);
         E_ = - spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]*y[gr2::Weyl::UT];
-        return abs(E_-E)/E < eps?1:0;
+        return std::abs(E_-E)/E < eps?1:0;
     }
 
     virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
@@ -196,7 +212,7 @@ public:
     {
         spt->calculate_metric(y);
         L_ = spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI]*y[gr2::Weyl::UPHI];
-        return abs(L_-L)/L < eps?1:0;
+        return std::abs(L_-L)/L < eps?1:0;
     }
 
     virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
@@ -206,6 +222,25 @@ public:
     }
 };
 
+template<class T>
+class ConservationDrift
+{
+public:
+    std::shared_ptr<T> spt;
+    gr2::real E, L;
+
+    ConservationDrift(std::shared_ptr<T> spt, gr2::real E, gr2::real L):spt(spt), E(E), L(L)
+    {}
+
+    gr2::real operator()(const gr2::real y[])
+    {
+        spt->calculate_metric(y);
+        gr2::real E_ = - spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]*y[gr2::Weyl::UT];
+        gr2::real L_ = spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI]*y[gr2::Weyl::UPHI];
+        return std::max(std::abs(E_-E)/E, std::abs(L_-L)/L);
+    }
+};
+
 class RenormalizationOfSecondParticleWeyl : public gr2::Event
 {
 protected:
@@ -234,7 +269,7 @@ public:
             gr2::real dy = y[i]-y_[i];
             norm2 += dy*dy;
         }
-        gr2::real norm = sqrtl(norm2);
+        gr2::real norm = std::sqrt(norm2);
         gr2::real factor = target_norm/norm;
 
         // Change y (pos, vels, lambda)
@@ -245,7 +280,7 @@ public:
         spt->function(t, y_, dydt+n);
 
         // Save normalization
-        this->log_norm += -log(factor);
+        this->log_norm += -std::log(factor);
     }
 };
 
@@ -272,7 +307,7 @@ public:
 
     bool test;
 
-    NumericalExpansions(std::shared_ptr<T> spt, gr2::real rho_min, gr2::real rho_max, int n_rho, gr2::real z_min, gr2::real z_max, int n_z, gr2::real *log_norm):gr2::Event(gr2::EventType::data, false), spt(spt), dt(dt), rho_min(rho_min), rho_max(rho_max), n_rho(n_rho), z_min(z_min), z_max(z_max), n_z(n_z), log_norm(log_norm), t_prev(0), test(false)
+    NumericalExpansions(std::shared_ptr<T> spt, gr2::real rho_min, gr2::real rho_max, int n_rho, gr2::real z_min, gr2::real z_max, int n_z, gr2::real *log_norm):gr2::Event(gr2::EventType::data, false, true), spt(spt), dt(dt), rho_min(rho_min), rho_max(rho_max), n_rho(n_rho), z_min(z_min), z_max(z_max), n_z(n_z), log_norm(log_norm), t_prev(0), test(false)
     {
         delta_rho = (rho_max-rho_min)/n_rho;
         delta_z = (z_max-z_min)/n_z;
@@ -323,9 +358,9 @@ public:
         int uz_index = gr2::Weyl::UZ;
 
         // prepare iteration
-        gr2::real urho = std::max(abs(stepper->dense_out(urho_index, t_last_step)), abs(stepper->dense_out(rho_index, t)));
-        gr2::real uz = std::max(abs(stepper->dense_out(uz_index, t_last_step)), abs(stepper->dense_out(uz_index, t)));
-        gr2::real dt = std::min(delta_rho, delta_z)/sqrtl(urho*urho + uz*uz)/10; // estimate time step for rho direction
+        gr2::real urho = std::max(std::abs(stepper->dense_out(urho_index, t_last_step)), std::abs(stepper->dense_out(rho_index, t)));
+        gr2::real uz = std::max(std::abs(stepper->dense_out(uz_index, t_last_step)), std::abs(stepper->dense_out(uz_index, t)));
+        gr2::real dt = std::min(delta_rho, delta_z)/std::sqrt(urho*urho + uz*uz)/10; // estimate time step for rho direction
         int iters = int((t-t_last_step)/dt) + 2;
 
         // iterate
@@ -380,8 +415,7 @@ public:
                 t_event = std::max(t_event_rho, t_event_z);
 
                 // get position
-                for (int j = 0; j < N; j++)
-                    y_[j] = stepper->dense_out(j, t_event);
+                stepper->dense_out_all(t_event, y_);
                 spt->calculate_metric(y_);
                 spt->calculate_christoffel_symbols(y_);
 
@@ -415,7 +449,7 @@ public:
                         norm_of_sep2 += (spt->get_metric()[j][k]+u_down_indices[j]*u_down_indices[k])*dyj*dyk;
                         norm_of_sep2 += (spt->get_metric()[j][k]+u_down_indices[j]*u_down_indices[k])*dvj*dvk;
                     }
-                gr2::real log_norm_of_sep = 0.5*log(norm_of_sep2);
+                gr2::real log_norm_of_sep = 0.5*std::log(norm_of_sep2);
 
                 // save result to array
                 // std::cout << (log_norm_of_sep + *(this->log_norm) - log_norm_prev) << std::endl;
@@ -449,7 +483,7 @@ public:
     gr2::real h;
     std::vector<gr2::real> times;
     std::vector<std::array<gr2::real, N>> data;
-    ConstantStepDataMonitoring(gr2::real t_init, gr2::real h) : gr2::Event(gr2::EventType::data), times(), data()
+    ConstantStepDataMonitoring(gr2::real t_init, gr2::real h) : gr2::Event(gr2::EventType::data, false, true), times(), data(), rows()
     {
         t = t_init;
         this->h = h;
@@ -460,16 +494,27 @@ public:
     }
     virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
     {
+        // times of samples in the last step
+        std::size_t first = times.size();
         while (this->t<t)
         {
             times.push_back(this->t);
-            std::array<gr2::real, N> y_val;
-            for (int i = 0; i<N; i++)
-            {
-                y_val[i] = stepper->dense_out(i, this->t);
-            }
-            data.push_back(y_val);
             this->t += h;
         }
+        int m = times.size() - first;
+        if (m == 0)
+            return;
+
+        // all samples are evaluated at once (rows have to hold all equations)
+        if (stepper->get_OdeSystem()->get_n() != N)
+            throw std::invalid_argument("number of values in ConstantStepDataMonitoring differs from number of equations");
+        data.resize(first + m);
+        rows.resize(m);
+        for (int k = 0; k < m; k++)
+            rows[k] = data[first + k].data();
+        stepper->dense_out_many(m, times.data() + first, rows.data());
     };
+
+private:
+    std::vector<gr2::real*> rows;   // rows of data filled in one step
 };
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include <stdexcept>
+#include <cmath>
+
+#include "gravitacek2/chaos/chaos_indicators.hpp"
+
+namespace gr2
+{
+    // ========== ChaosIndicator ==========
+
+    ChaosIndicator::ChaosIndicator(std::shared_ptr<VariationalGeoMotion> ode, const bool &early_termination) : Event(EventType::data, false), ode(ode), early_termination(early_termination), orbit_class(OrbitClass::undecided), t_last(0)
+    {}
+
+    void ChaosIndicator::decide(const OrbitClass &orbit_class)
+    {
+        this->orbit_class = orbit_class;
+        if (early_termination)
+            this->terminal = true;
+    }
+
+    OrbitClass ChaosIndicator::get_orbit_class() const
+    {
+        return orbit_class;
+    }
+
+    real ChaosIndicator::get_time() const
+    {
+        return t_last;
+    }
+
+    void ChaosIndicator::reset()
+    {
+        this->orbit_class = OrbitClass::undecided;
+        this->terminal = false;
+        this->t_last = 0;
+    }
+
+    real ChaosIndicator::value(const real &t, const real &dt, const real y[], const real dydt[])
+    {
+        return 0;
+    }
+
+    // ========== MEGNO ==========
+
+    MEGNO::MEGNO(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &regular_tol, const real &chaotic_limit, const bool &early_termination, const real &regular_window) : ChaosIndicator(ode, early_termination), t_min(t_min), regular_tol(regular_tol), chaotic_limit(chaotic_limit), regular_window(regular_window), t_band(-1), megno(0), mean_megno(0)
+    {
+        if (ode->get_megno_index() < 0)
+            throw std::invalid_argument("variational equations do not integrate MEGNO");
+        if (regular_window < 1)
+            throw std::invalid_argument("window for regular orbits has to be at least 1");
+    }
+
+    real MEGNO::get_value() const
+    {
+        return mean_megno;
+    }
+
+    real MEGNO::get_megno() const
+    {
+        return megno;
+    }
+
+    void MEGNO::reset()
+    {
+        ChaosIndicator::reset();
+        this->megno = this->mean_megno = 0;
+        this->t_band = -1;
+    }
+
+    void MEGNO::apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[])
+    {
+        if (t <= 0)
+            return;
+        int index = ode->get_megno_index();
+        this->megno = 2*y[index]/t;
+        this->mean_megno = y[index+1]/t;
+        this->t_last = t;
+
+        // time since which mean MEGNO is close to 2
+        if (std::abs(mean_megno - 2) >= regular_tol)
+            this->t_band = -1;
+        else if (t_band < 0)
+            this->t_band = t;
+
+        // classification
+        if (orbit_class != OrbitClass::undecided || t < t_min)
+            return;
+        if (mean_megno > chaotic_limit)
+            this->decide(OrbitClass::chaotic);
+        else if (t_band > 0 && t >= regular_window*t_band)
+            this->decide(OrbitClass::regular);
+    }
+
+    // ========== FLI ==========
+
+    FLI::FLI(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &chaotic_limit, const int &index, const bool &early_termination, const real &regular_slope, const real &regular_window) : ChaosIndicator(ode, early_termination), index(index), t_min(t_min), chaotic_limit(chaotic_limit), regular_slope(regular_slope), regular_window(regular_window), t_band(-1), fli_band(0), log_norm(0), fli(0)
+    {
+        if (index < 0 || index >= ode->get_k())
+            throw std::invalid_argument("invalid index of deviation vector for FLI");
+        if (regular_window <= 1)
+            throw std::invalid_argument("window for regular orbits has to be larger than 1");
+    }
+
+    real FLI::get_value() const
+    {
+        return fli;
+    }
+
+    void FLI::reset()
+    {
+        ChaosIndicator::reset();
+        this->log_norm = this->fli = this->fli_band = 0;
+        this->t_band = -1;
+    }
+
+    void FLI::apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[])
+    {
+        this->log_norm += ode->normalize(index, y, dydt);
+        this->fli = std::max(fli, log_norm);
+        this->t_last = t;
+        if (t <= 0)
+            return;
+
+        // growth of FLI over the window
+        bool log_growth = false;
+        if (t_band < 0)
+        {
+            this->t_band = t;
+            this->fli_band = fli;
+        }
+        else if (t >= regular_window*t_band)
+        {
+            log_growth = fli - fli_band <= regular_slope*std::log(t/t_band);
+            this->t_band = t;
+            this->fli_band = fli;
+        }
+
+        // classification
+        if (orbit_class != OrbitClass::undecided)
+            return;
+        if (fli > chaotic_limit)
+            this->decide(OrbitClass::chaotic);
+        else if (log_growth && t >= t_min)
+            this->decide(OrbitClass::regular);
+    }
+
+    // ========== SALI ==========
+
+    SALI::SALI(std::shared_ptr<VariationalGeoMotion> ode, const real &t_min, const real &chaotic_limit, const int &index1, const int &index2, const bool &early_termination, const real &regular_limit, const real &regular_window) : ChaosIndicator(ode, early_termination), index1(index1), index2(index2), t_min(t_min), chaotic_limit(chaotic_limit), regular_limit(regular_limit), regular_window(regular_window), t_band(-1), sali(std::sqrt(real(2)))
+    {
+        if (index1 < 0 || index1 >= ode->get_k() || index2 < 0 || index2 >= ode->get_k() || index1 == index2)
+            throw std::invalid_argument("invalid indices of deviation vectors for SALI");
+        if (regular_window < 1)
+            throw std::invalid_argument("window for regular orbits has to be at least 1");
+    }
+
+    real SALI::get_value() const
+    {
+        return sali;
+    }
+
+    void SALI::reset()
+    {
+        ChaosIndicator::reset();
+        this->sali = std::sqrt(real(2));
+        this->t_band = -1;
+    }
+
+    void SALI::apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[])
+    {
+        ode->normalize(index1, y, dydt);
+        ode->normalize(index2, y, dydt);
+        const real *w1 = y + ode->get_deviation_index(index1);
+        const real *w2 = y + ode->get_deviation_index(index2);
+        real plus2 = 0, minus2 = 0;
+        for (int l = 0; l < 2*ode->get_spacetime()->get_dim(); l++)
+        {
+            plus2 += (w1[l] + w2[l])*(w1[l] + w2[l]);
+            minus2 += (w1[l] - w2[l])*(w1[l] - w2[l]);
+        }
+        this->sali = std::sqrt(std::min(plus2, minus2));
+        this->t_last = t;
+        if (t <= 0)
+            return;
+
+        // time since which SALI is above the limit for regular orbits
+        if (sali <= regular_limit)
+            this->t_band = -1;
+        else if (t_band < 0)
+            this->t_band = t;
+
+        // classification
+        if (orbit_class != OrbitClass::undecided)
+            return;
+        if (sali < chaotic_limit)
+            this->decide(OrbitClass::chaotic);
+        else if (t_band > 0 && t >= regular_window*std::max(t_band, t_min))
+            this->decide(OrbitClass::regular);
+    }
+}
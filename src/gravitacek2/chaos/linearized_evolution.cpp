@@ -1,6 +1,9 @@
 #include <stdexcept>
+#include <cmath>
+#include <algorithm>
 
 #include "gravitacek2/chaos/linearized_evolution.hpp"
+#include "gravitacek2/mymath.hpp"
 
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_eigen.h>
@@ -12,6 +15,34 @@
 
 namespace gr2
 {
+    // contraction A[i][j] = -R^i_{kjl} u^k u^l of Riemann tensor of 4-dimensional space-time
+    static void tidal_contraction(const real *riemann, const real *u, real *A)
+    {
+        const int dim = 4;
+        for (int i = 0; i < dim; i++)
+            for (int j = 0; j < dim; j++)
+            {
+                gr2::real value = 0;
+                for (int k = 0; k < dim; k++)
+                {
+                    const real *R = riemann + ((i*dim + k)*dim + j)*dim;
+                    gr2::real value_k = 0;
+                    for (int l = 0; l < dim; l++)
+                        value_k += R[l]*u[l];
+                    value -= value_k*u[k];
+                }
+                A[i*dim + j] = value;
+            }
+    }
+
+    void tidal_matrix(GeoMotion* spt, const real *y, real *A)
+    {
+        if (spt->get_dim() != 4)
+            throw std::invalid_argument("tidal matrix is implemented only for 4-dimensional space-times");
+        spt->calculate_riemann_tensor(y);
+        tidal_contraction(spt->get_riemann_tensor_data(), y + 4, A);
+    }
+
     gsl_matrix *matrix_H(GeoMotion* spt, const real *y)
     {
         gsl_matrix *matrix;
@@ -52,28 +83,16 @@ namespace gr2
 
     real expected_growth(GeoMotion* spt, const real *y)
     {
-        gsl_matrix *H;
-        gsl_vector_complex *eig_vals;
-        gsl_eigen_nonsymm_workspace *work_space;
-
-        // calculate matrix H
-        H = gr2::matrix_H(spt, y);
-        gsl_matrix_transpose(H);
-        eig_vals = gsl_vector_complex_alloc(8);
-        work_space = gsl_eigen_nonsymm_alloc(8);
-
-        // calculate eigen values
-        int i = gsl_eigen_nonsymm(H, eig_vals, work_space);
+        // H = [[0, I], [A, 0]], so eigenvalues of H are square roots of
+        // eigenvalues of the tidal matrix A
+        real A[16], re[4], im[4];
+        tidal_matrix(spt, y, A);
+        gr2::eigenvalues_nonsymm4(A, re, im);
 
-        // find greates real part
-        gr2::real value=0;
-        for (int i = 0; i < work_space->n_evals; i++)
-            value = std::max((double)value, GSL_REAL(gsl_vector_complex_get(eig_vals, i)));
-
-        // free the matrix
-        gsl_matrix_free(H);
-        gsl_vector_complex_free(eig_vals);
-        gsl_eigen_nonsymm_free(work_space);
+        // find greatest real part of square roots
+        gr2::real value = 0;
+        for (int i = 0; i < 4; i++)
+            value = std::max(value, std::sqrt(0.5*(std::hypot(re[i], im[i]) + re[i])));
 
         return value;
     }
@@ -189,152 +208,110 @@ namespace gr2
     //     }   
     // };
 
-    gr2::real max_norm_growth(GeoMotion *spt, const real *y)
+    real max_norm_growth(GeoMotion *spt, const real *y)
     {
-        // constants
-        int dim = spt->get_dim();
-        int n = 2*dim;
-
-        // arrays and special constants
-        gsl_matrix *H, *gH, *g, *gHT;   // matrix H
-        gsl_matrix *mod_g;              // modified metric
-        gsl_matrix *P;                  // projector
-        gsl_matrix *matrix;             // final matrix
-        gsl_matrix *tmp;                // temporary matrix for multiplication
-        gr2::real u_up[4]{}, u_down[4]{};
-
-        gsl_vector *eig_vals;
-        gsl_eigen_symm_workspace *work_space;
+        real value;
+        max_norm_growth(spt, y, 1, y + spt->get_dim(), &value);
+        return value;
+    }
 
-        try
+    void max_norm_growth(GeoMotion *spt, const real *y, const int &n, const real *u, real *values)
+    {
+        const int dim = 4;
+        if (spt->get_dim() != dim)
+            throw std::invalid_argument("max norm growth is implemented only for 4-dimensional space-times");
+
+        // ========== Quantities independent of velocity ==========
+        spt->calculate_metric(y);
+        spt->calculate_riemann_tensor(y);
+        real g[dim][dim];
+        for (int i = 0; i < dim; i++)
+            for (int j = 0; j < dim; j++)
+                g[i][j] = spt->get_metric()[i][j];
+        const real *riemann = spt->get_riemann_tensor_data();
+
+        for (int a = 0; a < n; a++)
         {
-            // calculate H
-            H = matrix_H(spt, y);
+            const real *u_up = u + a*dim;
+            real u_down[dim], A[dim][dim], M[dim][dim], L[dim][dim], W[dim][dim], MW[dim][dim], B[dim][dim], C[dim*dim], eig[dim];
 
-            tmp = gsl_matrix_alloc(n, n);
+            // lower index of velocity
+            for (int i = 0; i < dim; i++)
+            {
+                u_down[i] = 0;
+                for (int j = 0; j < dim; j++)
+                    u_down[i] += g[i][j]*u_up[j];
+            }
 
-            // calculate g (done)
-            spt->calculate_metric(y);
-            g = gsl_matrix_alloc(n, n);
-            gsl_matrix_set_zero(g);
+            // symmetrized g*H is [[0, M^T], [M, 0]] with M = g*A + g
+            tidal_contraction(riemann, u_up, &A[0][0]);
             for (int i = 0; i < dim; i++)
                 for (int j = 0; j < dim; j++)
                 {
-                    gsl_matrix_set(g, i, j, spt->get_metric()[i][j]);
-                    gsl_matrix_set(g, dim+i, dim+j, spt->get_metric()[i][j]);
+                    M[i][j] = g[i][j];
+                    for (int k = 0; k < dim; k++)
+                        M[i][j] += g[i][k]*A[k][j];
                 }
 
-            // calculate gH
-            gH = gsl_matrix_alloc(n, n);
-            gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, g, H, 0, gH);
-            
-            // calculate (gH).T
-            gHT = gsl_matrix_alloc(n, n);
-            gsl_matrix_transpose_memcpy(gHT, gH);
-
-            // sum gH and (gH).T to gH
-            gsl_matrix_add(gH, gHT);
+            // Cholesky decomposition L*L^T of modified metric g + 2 u u
+            for (int j = 0; j < dim; j++)
+            {
+                real sum = g[j][j] + 2*u_down[j]*u_down[j];
+                for (int k = 0; k < j; k++)
+                    sum -= L[j][k]*L[j][k];
+                if (sum <= 0)
+                    throw std::invalid_argument("modified metric is not positive definite");
+                L[j][j] = std::sqrt(sum);
+                for (int i = j+1; i < dim; i++)
+                {
+                    sum = g[i][j] + 2*u_down[i]*u_down[j];
+                    for (int k = 0; k < j; k++)
+                        sum -= L[i][k]*L[j][k];
+                    L[i][j] = sum/L[j][j];
+                }
+            }
 
-            // TODO: Calculate velocities
+            // W = P*L^-T, where P = 1 + u u is projector (rows of W are
+            // solutions of L*w = p)
             for (int i = 0; i < dim; i++)
-                u_up[i] = y[i+dim];
+                for (int j = 0; j < dim; j++)
+                {
+                    real sum = (i == j) + u_up[i]*u_down[j];
+                    for (int k = 0; k < j; k++)
+                        sum -= L[j][k]*W[i][k];
+                    W[i][j] = sum/L[j][j];
+                }
 
+            // B = W^T*M*W
             for (int i = 0; i < dim; i++)
-            {
-                u_down[i] = 0;
                 for (int j = 0; j < dim; j++)
-                    u_down[i] += spt->get_metric()[i][j]*u_up[j];
-            }
-
-            // TODO: Calculate projector
-            P = gsl_matrix_alloc(n, n);
-            gsl_matrix_set_zero(P);
-            for (int i = 0; i< dim; i++)
-                for (int j = 0; j< dim; j++)
                 {
-                    if (i == j)
-                    {
-                        gsl_matrix_set(P, i, j, 1+u_up[i]*u_down[j]);
-                        gsl_matrix_set(P, i+dim, j+dim, 1+u_up[i]*u_down[j]);
-                    }
-                    else
-                    {
-                        gsl_matrix_set(P, i, j, u_up[i]*u_down[j]);
-                        gsl_matrix_set(P, i+dim, j+dim, u_up[i]*u_down[j]);
-                    }
+                    MW[i][j] = 0;
+                    for (int k = 0; k < dim; k++)
+                        MW[i][j] += M[i][k]*W[k][j];
                 }
-
-            // TODO: Calculate modified metric
-            mod_g = gsl_matrix_alloc(n, n);
-            gsl_matrix_set_zero(mod_g);
-            for (int i = 0; i< dim; i++)
-                for (int j = 0; j< dim; j++)
+            for (int i = 0; i < dim; i++)
+                for (int j = 0; j < dim; j++)
                 {
-                    gsl_matrix_set(mod_g, i, j, spt->get_metric()[i][j] + 2*u_down[i]*u_down[j]);
-                    gsl_matrix_set(mod_g, i+4, j+4, spt->get_metric()[i][j] + 2*u_down[i]*u_down[j]);
+                    B[i][j] = 0;
+                    for (int k = 0; k < dim; k++)
+                        B[i][j] += W[k][i]*MW[k][j];
                 }
 
-            // TODO: Calculate Cholesky decomposition
-            gsl_linalg_cholesky_decomp1(mod_g);
-
-            // delete upper diagonal
-            for (int i = 0; i < n; i++)
-                for (int j = i+1; j < n; j++)
-                    gsl_matrix_set(mod_g, i, j, 0);
-
-            // TODO: Calculate inverse of L
-            gsl_linalg_tri_invert(CblasLower, CblasNonUnit, mod_g);
-
-            // save P*L^-1 to P
-            gsl_blas_dgemm(CblasNoTrans, CblasTrans, 1.0, P, mod_g, 0.0, tmp);
-            gsl_matrix_memcpy(P, tmp);
-
-            // TODO:Calculate resulting matrix
-            matrix = gsl_matrix_alloc(n, n);
-            gsl_matrix_set_identity(matrix);
-            gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1.0, P, gH, 0.0, tmp);
-            gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, tmp, P, 0.0, matrix);
-
-            // TODO: calculate value
-            // calculate matrix H
-            eig_vals = gsl_vector_alloc(8);
-            work_space = gsl_eigen_symm_alloc(8);
-
-            // calculate eigen values
-            int status = gsl_eigen_symm(matrix, eig_vals, work_space);
-            gr2::real value=0;
-            for (int i = 0; i < 8; i++)
-                value = std::max((double)value, gsl_vector_get(eig_vals, i));
-
-            // delete matrices
-            gsl_matrix_free(H);
-            gsl_matrix_free(gH);
-            gsl_matrix_free(g);
-            gsl_matrix_free(gHT);
-            gsl_matrix_free(mod_g);
-            gsl_matrix_free(P);
-            gsl_matrix_free(tmp);
-            gsl_matrix_free(matrix);
-            gsl_vector_free(eig_vals);
-            gsl_eigen_symm_free(work_space);
-
-            // return
-            return value*0.5;
-        }
-        catch(const std::exception& e)
-        {
-            gsl_matrix_free(H);
-            gsl_matrix_free(gH);
-            gsl_matrix_free(g);
-            gsl_matrix_free(gHT);
-            gsl_matrix_free(mod_g);
-            gsl_matrix_free(P);
-            gsl_matrix_free(tmp);
-            gsl_matrix_free(matrix);
-            gsl_vector_free(eig_vals);
-            gsl_eigen_symm_free(work_space);
-            throw e;
+            // eigenvalues of [[0, B^T], [B, 0]] are singular values of B
+            for (int i = 0; i < dim; i++)
+                for (int j = i; j < dim; j++)
+                {
+                    real sum = 0;
+                    for (int k = 0; k < dim; k++)
+                        sum += B[k][i]*B[k][j];
+                    C[i*dim + j] = C[j*dim + i] = sum;
+                }
+            gr2::eigenvalues_symm(dim, C, eig);
+            real value = 0;
+            for (int i = 0; i < dim; i++)
+                value = std::max(value, eig[i]);
+            values[a] = 0.5*std::sqrt(value);
         }
-        
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,210 @@
+#include <stdexcept>
+#include <cmath>
+
+#include "gravitacek2/chaos/variational_equations.hpp"
+
+namespace gr2
+{
+    // ========== VariationalGeoMotion ==========
+
+    VariationalGeoMotion::VariationalGeoMotion(std::shared_ptr<GeoMotion> spt, const int &k, const bool &megno) : OdeSystem(spt->get_n() + 2*spt->get_dim()*k), spt(spt), dim(spt->get_dim()), k(k)
+    {
+        if (k < 1 || k > 2*dim)
+            throw std::invalid_argument("number of deviation vectors has to be between 1 and 2*dim");
+        this->megno_index = -1;
+        if (megno)
+        {
+            this->megno_index = this->n;
+            this->n += 2;
+        }
+        this->G = new real[dim*dim];
+        this->A = new real[dim*dim];
+    }
+
+    VariationalGeoMotion::~VariationalGeoMotion()
+    {
+        delete[] G;
+        delete[] A;
+    }
+
+    std::shared_ptr<GeoMotion> VariationalGeoMotion::get_spacetime() const
+    {
+        return spt;
+    }
+
+    int VariationalGeoMotion::get_k() const
+    {
+        return k;
+    }
+
+    int VariationalGeoMotion::get_deviation_index(const int &i) const
+    {
+        return spt->get_n() + 2*dim*i;
+    }
+
+    int VariationalGeoMotion::get_megno_index() const
+    {
+        return megno_index;
+    }
+
+    void VariationalGeoMotion::init_deviations(real y[]) const
+    {
+        // generic vectors (coordinate directions can span invariant
+        // subspaces given by symmetries of space-time)
+        for (int i = 0; i < k; i++)
+        {
+            real *v = y + this->get_deviation_index(i);
+            for (int j = 0; j < 2*dim; j++)
+                v[j] = (i == j) + 0.5*std::sin(real((i + 1)*(j + 2)));
+        }
+        real *log_norms = new real[k]{};
+        this->orthonormalize(y, log_norms);
+        delete[] log_norms;
+
+        if (megno_index >= 0)
+            y[megno_index] = y[megno_index+1] = 0;
+    }
+
+    void VariationalGeoMotion::orthonormalize(real y[], real log_norms[]) const
+    {
+        int m = 2*dim;
+        for (int i = 0; i < k; i++)
+        {
+            real *v = y + this->get_deviation_index(i);
+
+            // remove projections to previous vectors
+            for (int j = 0; j < i; j++)
+            {
+                const real *w = y + this->get_deviation_index(j);
+                real dot = 0;
+                for (int l = 0; l < m; l++)
+                    dot += v[l]*w[l];
+                for (int l = 0; l < m; l++)
+                    v[l] -= dot*w[l];
+            }
+
+            // normalize
+            real norm2 = 0;
+            for (int l = 0; l < m; l++)
+                norm2 += v[l]*v[l];
+            real norm = std::sqrt(norm2);
+            for (int l = 0; l < m; l++)
+                v[l] /= norm;
+            log_norms[i] += std::log(norm);
+        }
+    }
+
+    real VariationalGeoMotion::normalize(const int &i, real y[], real dydt[]) const
+    {
+        int m = 2*dim, index = this->get_deviation_index(i);
+        real norm2 = 0;
+        for (int l = 0; l < m; l++)
+            norm2 += y[index+l]*y[index+l];
+        real norm = std::sqrt(norm2);
+        for (int l = 0; l < m; l++)
+            y[index+l] /= norm;
+        if (dydt)
+            for (int l = 0; l < m; l++)
+                dydt[index+l] /= norm;
+        return std::log(norm);
+    }
+
+    void VariationalGeoMotion::function(const real &t, const real y[], real dydt[])
+    {
+        // ========== Geodesic motion ==========
+        spt->function(t, y, dydt);
+
+        // ========== Matrices of linearized evolution ==========
+        spt->calculate_riemann_tensor(y);
+        spt->calculate_christoffel_symbols(y);
+        const real *gamma = spt->get_christoffel_symbols_data();
+        const real *riemann = spt->get_riemann_tensor_data();
+        const real *u = y + dim;
+        for (int mu = 0; mu < dim; mu++)
+            for (int nu = 0; nu < dim; nu++)
+            {
+                real value_G = 0, value_A = 0;
+                for (int alpha = 0; alpha < dim; alpha++)
+                {
+                    value_G += gamma[(mu*dim + alpha)*dim + nu]*u[alpha];
+                    const real *R = riemann + ((mu*dim + alpha)*dim + nu)*dim;
+                    real value = 0;
+                    for (int beta = 0; beta < dim; beta++)
+                        value += R[beta]*u[beta];
+                    value_A -= value*u[alpha];
+                }
+                G[mu*dim + nu] = value_G;
+                A[mu*dim + nu] = value_A;
+            }
+
+        // ========== Deviation vectors ==========
+        for (int i = 0; i < k; i++)
+        {
+            int index = this->get_deviation_index(i);
+            const real *xi = y + index, *eta = xi + dim;
+            real *dxi = dydt + index, *deta = dxi + dim;
+            for (int mu = 0; mu < dim; mu++)
+            {
+                const real *G_mu = G + mu*dim, *A_mu = A + mu*dim;
+                real value_xi = eta[mu], value_eta = 0;
+                for (int nu = 0; nu < dim; nu++)
+                {
+                    value_xi -= G_mu[nu]*xi[nu];
+                    value_eta += A_mu[nu]*xi[nu] - G_mu[nu]*eta[nu];
+                }
+                dxi[mu] = value_xi;
+                deta[mu] = value_eta;
+            }
+        }
+
+        // ========== Quadratures of MEGNO ==========
+        if (megno_index >= 0)
+        {
+            int index = this->get_deviation_index(0);
+            real w_dw = 0, w_w = 0;
+            for (int l = 0; l < 2*dim; l++)
+            {
+                w_dw += y[index+l]*dydt[index+l];
+                w_w += y[index+l]*y[index+l];
+            }
+            dydt[megno_index] = t*w_dw/w_w;
+            dydt[megno_index+1] = t != 0 ? 2*y[megno_index]/t : 0;
+        }
+    }
+
+    // ========== LyapunovSpectrum ==========
+
+    LyapunovSpectrum::LyapunovSpectrum(std::shared_ptr<VariationalGeoMotion> ode, const real &period, const real &t_start) : Event(EventType::data, false), ode(ode), period(period), t_start(t_start), t_last(t_start)
+    {
+        this->log_norms = new real[ode->get_k()]{};
+    }
+
+    LyapunovSpectrum::~LyapunovSpectrum()
+    {
+        delete[] log_norms;
+    }
+
+    void LyapunovSpectrum::get_exponents(real exponents[]) const
+    {
+        real dt = t_last - t_start;
+        for (int i = 0; i < ode->get_k(); i++)
+            exponents[i] = dt > 0 ? log_norms[i]/dt : 0;
+    }
+
+    real LyapunovSpectrum::get_time() const
+    {
+        return t_last;
+    }
+
+    real LyapunovSpectrum::value(const real &t, const real &dt, const real y[], const real dydt[])
+    {
+        return t - t_last >= period ? 0 : 1;
+    }
+
+    void LyapunovSpectrum::apply(StepperBase* stepper, real &t, real &dt, real y[], real dydt[])
+    {
+        ode->orthonormalize(y, log_norms);
+        ode->function(t, y, dydt);
+        this->t_last = t;
+    }
+}
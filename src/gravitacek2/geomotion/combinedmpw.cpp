@@ -14,6 +14,14 @@ namespace gr2
 
     };
 
+    CombinedMPW* CombinedMPW::clone() const
+    {
+        std::vector<std::shared_ptr<MajumdarPapapetrouWeyl>> sources_clone;
+        for (auto s : this->sources)
+            sources_clone.push_back(std::shared_ptr<MajumdarPapapetrouWeyl>(s->clone()));
+        return new CombinedMPW(sources_clone);
+    };
+
     void CombinedMPW::calculate_N_inv(const real* y)
     {
         this->N_inv = 1;
@@ -20,6 +20,16 @@ namespace gr2
 
     };
 
+    CombinedWeyl* CombinedWeyl::clone() const
+    {
+        std::vector<std::shared_ptr<Weyl>> sources_clone;
+        for (auto s : this->sources)
+            sources_clone.push_back(std::shared_ptr<Weyl>(s->clone()));
+        CombinedWeyl* spt = new CombinedWeyl(sources_clone);
+        spt->set_lambda_index(this->lambda_index);
+        return spt;
+    };
+
     void CombinedWeyl::calculate_lambda_init(real const* y)
     {
         switch (this->lambda_eval_init)
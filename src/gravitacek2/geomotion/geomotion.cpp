@@ -1,3 +1,6 @@
+#include <stdexcept>
+#include <algorithm>
+
 #include "gravitacek2/geomotion/geomotion.hpp"
 
 namespace gr2
@@ -20,41 +23,66 @@ namespace gr2
         return test;
     }
 
+    void GeoMotion::set_christoffel_sparsity(const std::vector<std::array<int, 3>> &entries)
+    {
+        this->christoffel_sparsity.clear();
+        for (auto e : entries)
+        {
+            for (int i = 0; i < 3; i++)
+                if (e[i] < 0 || e[i] >= dim)
+                    throw std::invalid_argument("index of Christoffel symbol is out of range");
+            
+            int kappa = std::min(e[1], e[2]);
+            int lambda = std::max(e[1], e[2]);
+            ChristoffelEntry entry{e[0], kappa, lambda, (e[0]*dim + kappa)*dim + lambda, real(kappa==lambda?1:2)};
+            
+            // skip duplicate entries
+            bool duplicate = false;
+            for (auto &s : this->christoffel_sparsity)
+                if (s.index == entry.index)
+                    duplicate = true;
+            if (!duplicate)
+                this->christoffel_sparsity.push_back(entry);
+        }
+    }
+
     GeoMotion::GeoMotion(const int &dim, const int &n) : OdeSystem(n)
     {
         // dimension
         this->dim = dim;
 
+        // contiguous storage
+        this->metric_data = new real[dim*dim]{};
+        this->christoffel_symbols_data = new real[dim*dim*dim]{};
+        this->riemann_tensor_data = new real[dim*dim*dim*dim]{};
+
         // metric
         this->metric = new real*[dim];
         for (int i = 0; i < dim; i++)
-        {
-            metric[i] = new real[dim]{};
-        }
+            this->metric[i] = this->metric_data + i*dim;
 
         // christoffel symbols
         this->christoffel_symbols = new real**[dim];
+        this->christoffel_symbols[0] = new real*[dim*dim];
         for (int i = 0; i < dim; i++)
         {
-            this->christoffel_symbols[i] = new real*[dim];
+            this->christoffel_symbols[i] = this->christoffel_symbols[0] + i*dim;
             for (int j = 0; j < dim; j++)
-            {
-                this->christoffel_symbols[i][j] = new real[dim]{};
-            }
+                this->christoffel_symbols[i][j] = this->christoffel_symbols_data + (i*dim + j)*dim;
         }
 
         // riemann tensor
         this->riemann_tensor = new real***[dim];
+        this->riemann_tensor[0] = new real**[dim*dim];
+        this->riemann_tensor[0][0] = new real*[dim*dim*dim];
         for (int i = 0; i < dim; i++)
         {
-            this->riemann_tensor[i] = new real**[dim];
+            this->riemann_tensor[i] = this->riemann_tensor[0] + i*dim;
             for (int j = 0; j < dim; j++)
             {
-                this->riemann_tensor[i][j] = new real*[dim];
+                this->riemann_tensor[i][j] = this->riemann_tensor[0][0] + (i*dim + j)*dim;
                 for (int k = 0; k < dim; k++)
-                {
-                    this->riemann_tensor[i][j][k] = new real[dim]{};
-                }
+                    this->riemann_tensor[i][j][k] = this->riemann_tensor_data + ((i*dim + j)*dim + k)*dim;
             }
         }
 
@@ -67,32 +95,19 @@ namespace gr2
     GeoMotion::~GeoMotion()
     {
         // metric
-        for (int i = 0; i < dim; i++)
-        {
-            delete[] metric[i];
-        }
         delete[] metric;
+        delete[] metric_data;
 
         // christoffel symbols
-        for (int i = 0; i < dim; i++)
-        {
-            for (int j = 0; j < dim; j++)
-                delete[] christoffel_symbols[i][j];
-            delete[] christoffel_symbols[i];
-        }
+        delete[] christoffel_symbols[0];
         delete[] christoffel_symbols;
+        delete[] christoffel_symbols_data;
 
         // riemann tensor
-        for (int i = 0; i < dim; i++)
-        {
-            for (int j = 0; j < dim; j++)
-            {
-                for (int k = 0; k < dim; k++)
-                    delete[] riemann_tensor[i][j][k];
-                delete[] riemann_tensor[i][j];
-            }
-            delete[] riemann_tensor[i];
-        }
+        delete[] riemann_tensor[0][0];
+        delete[] riemann_tensor[0];
+        delete[] riemann_tensor;
+        delete[] riemann_tensor_data;
 
         // coordinates
         delete[] y_c;
@@ -120,21 +135,59 @@ namespace gr2
         return riemann_tensor;
     }
 
+    real *GeoMotion::get_metric_data() const
+    {
+        return metric_data;
+    }
+
+    real *GeoMotion::get_christoffel_symbols_data() const
+    {
+        return christoffel_symbols_data;
+    }
+
+    real *GeoMotion::get_riemann_tensor_data() const
+    {
+        return riemann_tensor_data;
+    }
+
+    const std::vector<ChristoffelEntry> &GeoMotion::get_christoffel_sparsity() const
+    {
+        return christoffel_sparsity;
+    }
+
     void GeoMotion::function(const real &t, const real y[], real dydt[])
     {
         this->calculate_christoffel_symbols(y);
+        const real *u = y + dim;
         
         // ========== Derivation of position ========== 
         for (int i = 0; i < dim; i++)
-            dydt[i] = y[dim+i];
+            dydt[i] = u[i];
+
+        // ========== Derivation of velocity (sparse) ========== 
+        if (!christoffel_sparsity.empty())
+        {
+            for (int i = 0; i < dim; i++)
+                dydt[dim + i] = 0;
+            for (auto &e : christoffel_sparsity)
+                dydt[dim + e.mu] -= e.factor*christoffel_symbols_data[e.index]*u[e.kappa]*u[e.lambda];
+            return;
+        }
 
-        // ========== Derivation of velocity ========== 
+        // ========== Derivation of velocity (dense) ========== 
         for (int i = 0; i < dim; i++)
         {
-            dydt[dim + i] = 0;
+            const real *gamma = christoffel_symbols_data + i*dim*dim;
+            real value = 0;
             for (int j = 0; j < dim; j++)
-                for (int k = 0; k < dim; k++)
-                    dydt[dim + i] += -christoffel_symbols[i][j][k]*y[dim+j]*y[dim+k];
+            {
+                const real *gamma_j = gamma + j*dim;
+                real value_j = 0.5*gamma_j[j]*u[j];
+                for (int k = j+1; k < dim; k++)
+                    value_j += gamma_j[k]*u[k];
+                value += value_j*u[j];
+            }
+            dydt[dim + i] = -2*value;
         }
     }
 }
\ No newline at end of file
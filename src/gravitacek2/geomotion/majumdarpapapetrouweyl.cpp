@@ -1,6 +1,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 #include "gravitacek2/geomotion/majumadpapapetrouweyl.hpp"
 
@@ -8,7 +9,18 @@ namespace gr2
 {
     MajumdarPapapetrouWeyl::MajumdarPapapetrouWeyl() : GeoMotion(4, 8)
     {
-
+        // nonzero Christoffel symbols
+        this->set_christoffel_sparsity({
+            {T, T, RHO}, {T, T, Z},
+            {PHI, PHI, RHO}, {PHI, PHI, Z},
+            {RHO, T, T}, {RHO, PHI, PHI}, {RHO, RHO, RHO}, {RHO, RHO, Z}, {RHO, Z, Z},
+            {Z, T, T}, {Z, PHI, PHI}, {Z, RHO, RHO}, {Z, RHO, Z}, {Z, Z, Z}
+        });
+
+        // empty cache of lapse function
+        this->N_inv = this->N_inv_rho = this->N_inv_z = 0;
+        this->N_inv_rhorho = this->N_inv_rhoz = this->N_inv_zz = 0;
+        this->jet_order = -1;
     }
 
     MajumdarPapapetrouWeyl::~MajumdarPapapetrouWeyl()
@@ -46,6 +58,45 @@ namespace gr2
         return this->N_inv_zz;
     }
 
+    void MajumdarPapapetrouWeyl::evaluate(const real* y, const int &order)
+    {
+        // use cached values
+        if (jet_order >= order && y[RHO] == jet_rho && y[Z] == jet_z)
+        {
+            N_inv = jet[0];
+            N_inv_rho = jet[1];
+            N_inv_z = jet[2];
+            N_inv_rhorho = jet[3];
+            N_inv_rhoz = jet[4];
+            N_inv_zz = jet[5];
+            return;
+        }
+
+        switch (order)
+        {
+        case 0:
+            this->calculate_N_inv(y);
+            break;
+        case 1:
+            this->calculate_N_inv1(y);
+            break;
+        default:
+            this->calculate_N_inv2(y);
+            break;
+        }
+
+        // save values
+        jet_order = std::min(order, 2);
+        jet_rho = y[RHO];
+        jet_z = y[Z];
+        jet[0] = N_inv;
+        jet[1] = N_inv_rho;
+        jet[2] = N_inv_z;
+        jet[3] = N_inv_rhorho;
+        jet[4] = N_inv_rhoz;
+        jet[5] = N_inv_zz;
+    }
+
     void MajumdarPapapetrouWeyl::calculate_metric(const real *y)
     {
         if(!necessary_calculate(y, y_m, dim))
@@ -56,7 +107,7 @@ namespace gr2
         real rho = y[RHO];
         real z = y[Z];
 
-        this->calculate_N_inv(y);
+        this->evaluate(y, 0);
         real N = 1.0/N_inv;
 
         metric[T][T] = -N*N;
@@ -75,7 +126,7 @@ namespace gr2
         real rho = y[RHO];
         real z = y[Z];
 
-        this->calculate_N_inv1(y);
+        this->evaluate(y, 1);
         real N = 1.0/N_inv;
 
         christoffel_symbols[T][T][RHO] = -N_inv_rho*N;
@@ -110,7 +161,7 @@ namespace gr2
         real rho = y[RHO];
         real z = y[Z];
 
-        this->calculate_N_inv2(y);
+        this->evaluate(y, 2);
         real N = 1.0/N_inv;
         real N2 = N*N;
         real N6 = N*N*N*N*N*N;
@@ -157,4 +208,46 @@ namespace gr2
         riemann_tensor[Z][RHO][RHO][Z] = ((N_inv_rhorho + N_inv_zz)*N_inv - N_inv_rho*N_inv_rho - N_inv_z*N_inv_z)*N2;
         riemann_tensor[Z][RHO][Z][RHO] = -riemann_tensor[Z][RHO][RHO][Z];
     }
+
+    void MajumdarPapapetrouWeyl::function_batch(const int &lanes, const real t[], const real y[], real dydt[])
+    {
+        // ========== Lapse function of each lane ==========
+        batch_y.resize(n);
+        batch_N_inv.resize(3*lanes);
+        real *N_inv_l = batch_N_inv.data();
+        real *N_inv_rho_l = N_inv_l + lanes;
+        real *N_inv_z_l = N_inv_rho_l + lanes;
+        for (int l = 0; l < lanes; l++)
+        {
+            for (int i = 0; i < n; i++)
+                batch_y[i] = y[i*lanes + l];
+            this->evaluate(batch_y.data(), 1);
+            N_inv_l[l] = N_inv;
+            N_inv_rho_l[l] = N_inv_rho;
+            N_inv_z_l[l] = N_inv_z;
+        }
+
+        // ========== Derivation of position ==========
+        for (int i = 0; i < dim*lanes; i++)
+            dydt[i] = y[dim*lanes + i];
+
+        // ========== Derivation of velocity ==========
+        const real *rho = y + RHO*lanes;
+        const real *ut = y + UT*lanes, *uphi = y + UPHI*lanes, *urho = y + URHO*lanes, *uz = y + UZ*lanes;
+        real *at = dydt + UT*lanes, *aphi = dydt + UPHI*lanes, *arho = dydt + URHO*lanes, *az = dydt + UZ*lanes;
+        for (int l = 0; l < lanes; l++)
+        {
+            real N = 1/N_inv_l[l];
+            real N4 = (N*N)*(N*N);
+            real p = N_inv_rho_l[l]*N;
+            real q = N_inv_z_l[l]*N;
+            real urho2_uz2 = urho[l]*urho[l] - uz[l]*uz[l];
+            real urho_uz = urho[l]*uz[l];
+
+            at[l] = 2*ut[l]*(p*urho[l] + q*uz[l]);
+            aphi[l] = -2*uphi[l]*((p + 1/rho[l])*urho[l] + q*uz[l]);
+            arho[l] = p*N4*ut[l]*ut[l] + rho[l]*(rho[l]*p + 1)*uphi[l]*uphi[l] - p*urho2_uz2 - 2*q*urho_uz;
+            az[l] = q*N4*ut[l]*ut[l] + rho[l]*rho[l]*q*uphi[l]*uphi[l] + q*urho2_uz2 - 2*p*urho_uz;
+        }
+    }
 }
\ No newline at end of file
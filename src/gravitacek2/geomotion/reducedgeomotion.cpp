@@ -0,0 +1,164 @@
+#include <stdexcept>
+#include <cmath>
+
+#include "gravitacek2/geomotion/reducedgeomotion.hpp"
+
+namespace gr2
+{
+    // Weyl and MajumdarPapapetrouWeyl use the same indices of variables
+    static_assert(Weyl::T == MajumdarPapapetrouWeyl::T && Weyl::PHI == MajumdarPapapetrouWeyl::PHI);
+    static_assert(Weyl::RHO == MajumdarPapapetrouWeyl::RHO && Weyl::Z == MajumdarPapapetrouWeyl::Z);
+    static_assert(Weyl::UT == MajumdarPapapetrouWeyl::UT && Weyl::UPHI == MajumdarPapapetrouWeyl::UPHI);
+    static_assert(Weyl::URHO == MajumdarPapapetrouWeyl::URHO && Weyl::UZ == MajumdarPapapetrouWeyl::UZ);
+
+    ReducedGeoMotion::ReducedGeoMotion(std::shared_ptr<GeoMotion> spt, const real &E, const real &L, const bool &quadrature) : OdeSystem(4), spt(spt), E(E), L(L)
+    {
+        this->weyl = std::dynamic_pointer_cast<Weyl>(spt);
+        this->mpw = std::dynamic_pointer_cast<MajumdarPapapetrouWeyl>(spt);
+        if (!weyl && !mpw)
+            throw std::invalid_argument("reduced geodesic motion requires Weyl or Majumdar-Papapetrou space-time");
+
+        // indices of additional variables
+        this->lambda_index = this->t_index = this->phi_index = -1;
+        if (weyl && spt->get_n() > 8)
+            this->lambda_index = this->n++;
+        if (quadrature)
+        {
+            this->t_index = this->n++;
+            this->phi_index = this->n++;
+        }
+
+        this->y_full = new real[spt->get_n()]{};
+    }
+
+    ReducedGeoMotion::ReducedGeoMotion(std::shared_ptr<GeoMotion> spt, const real y_full[], const bool &quadrature) : ReducedGeoMotion(spt, 0, 0, quadrature)
+    {
+        spt->calculate_metric(y_full);
+        this->E = -spt->get_metric()[Weyl::T][Weyl::T]*y_full[Weyl::UT];
+        this->L = spt->get_metric()[Weyl::PHI][Weyl::PHI]*y_full[Weyl::UPHI];
+    }
+
+    ReducedGeoMotion::~ReducedGeoMotion()
+    {
+        delete[] y_full;
+    }
+
+    real ReducedGeoMotion::get_E() const
+    {
+        return E;
+    }
+
+    real ReducedGeoMotion::get_L() const
+    {
+        return L;
+    }
+
+    int ReducedGeoMotion::get_lambda_index() const
+    {
+        return lambda_index;
+    }
+
+    int ReducedGeoMotion::get_t_index() const
+    {
+        return t_index;
+    }
+
+    int ReducedGeoMotion::get_phi_index() const
+    {
+        return phi_index;
+    }
+
+    void ReducedGeoMotion::fill_position(const real y[])
+    {
+        y_full[Weyl::T] = t_index >= 0 ? y[t_index] : 0;
+        y_full[Weyl::PHI] = phi_index >= 0 ? y[phi_index] : 0;
+        y_full[Weyl::RHO] = y[RHO];
+        y_full[Weyl::Z] = y[Z];
+        y_full[Weyl::URHO] = y[URHO];
+        y_full[Weyl::UZ] = y[UZ];
+        if (lambda_index >= 0)
+            y_full[weyl->get_lambda_index()] = y[lambda_index];
+    }
+
+    void ReducedGeoMotion::reduce(const real y_full[], real y[]) const
+    {
+        y[RHO] = y_full[Weyl::RHO];
+        y[Z] = y_full[Weyl::Z];
+        y[URHO] = y_full[Weyl::URHO];
+        y[UZ] = y_full[Weyl::UZ];
+        if (lambda_index >= 0)
+            y[lambda_index] = y_full[weyl->get_lambda_index()];
+        if (t_index >= 0)
+        {
+            y[t_index] = y_full[Weyl::T];
+            y[phi_index] = y_full[Weyl::PHI];
+        }
+    }
+
+    void ReducedGeoMotion::reconstruct(const real y[], real y_full[])
+    {
+        this->fill_position(y);
+        spt->calculate_metric(this->y_full);
+        this->y_full[Weyl::UT] = -E/spt->get_metric()[Weyl::T][Weyl::T];
+        this->y_full[Weyl::UPHI] = L/spt->get_metric()[Weyl::PHI][Weyl::PHI];
+        for (int i = 0; i < spt->get_n(); i++)
+            y_full[i] = this->y_full[i];
+    }
+
+    void ReducedGeoMotion::function(const real &t, const real y[], real dydt[])
+    {
+        // Christoffel symbols in current position
+        this->fill_position(y);
+        spt->calculate_christoffel_symbols(y_full);
+
+        // four-velocity (Christoffel symbols may be reused from cache, so
+        // potential is evaluated explicitly, which is cached in the same point)
+        real u[4];
+        real rho2 = y[RHO]*y[RHO];
+        if (weyl)
+        {
+            weyl->evaluate(y_full, 1);
+            real exp_2nu = std::exp(2*weyl->get_nu());
+            u[Weyl::T] = E/exp_2nu;
+            u[Weyl::PHI] = L*exp_2nu/rho2;
+        }
+        else
+        {
+            mpw->evaluate(y_full, 1);
+            real N_inv2 = mpw->get_N_inv()*mpw->get_N_inv();
+            u[Weyl::T] = E*N_inv2;
+            u[Weyl::PHI] = L/(rho2*N_inv2);
+        }
+        u[Weyl::RHO] = y[URHO];
+        u[Weyl::Z] = y[UZ];
+
+        // ========== Derivation of position ==========
+        dydt[RHO] = y[URHO];
+        dydt[Z] = y[UZ];
+
+        // ========== Derivation of velocity ==========
+        // (metric is diagonal, so only diagonal terms in t and phi contribute)
+        real ***gamma = spt->get_christoffel_symbols();
+        dydt[URHO] = -gamma[Weyl::RHO][Weyl::T][Weyl::T]*u[Weyl::T]*u[Weyl::T] - gamma[Weyl::RHO][Weyl::PHI][Weyl::PHI]*u[Weyl::PHI]*u[Weyl::PHI]
+            - gamma[Weyl::RHO][Weyl::RHO][Weyl::RHO]*u[Weyl::RHO]*u[Weyl::RHO] - 2*gamma[Weyl::RHO][Weyl::RHO][Weyl::Z]*u[Weyl::RHO]*u[Weyl::Z]
+            - gamma[Weyl::RHO][Weyl::Z][Weyl::Z]*u[Weyl::Z]*u[Weyl::Z];
+        dydt[UZ] = -gamma[Weyl::Z][Weyl::T][Weyl::T]*u[Weyl::T]*u[Weyl::T] - gamma[Weyl::Z][Weyl::PHI][Weyl::PHI]*u[Weyl::PHI]*u[Weyl::PHI]
+            - gamma[Weyl::Z][Weyl::RHO][Weyl::RHO]*u[Weyl::RHO]*u[Weyl::RHO] - 2*gamma[Weyl::Z][Weyl::RHO][Weyl::Z]*u[Weyl::RHO]*u[Weyl::Z]
+            - gamma[Weyl::Z][Weyl::Z][Weyl::Z]*u[Weyl::Z]*u[Weyl::Z];
+
+        // ========== Derivation of lambda ==========
+        if (lambda_index >= 0)
+        {
+            real rho = y[RHO];
+            real nu_rho = weyl->get_nu_rho(), nu_z = weyl->get_nu_z();
+            dydt[lambda_index] = rho*(nu_rho*nu_rho - nu_z*nu_z)*y[URHO] + 2*rho*nu_rho*nu_z*y[UZ];
+        }
+
+        // ========== Quadrature of t and phi ==========
+        if (t_index >= 0)
+        {
+            dydt[t_index] = u[Weyl::T];
+            dydt[phi_index] = u[Weyl::PHI];
+        }
+    }
+}
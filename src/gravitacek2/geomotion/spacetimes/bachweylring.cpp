@@ -17,6 +17,13 @@ namespace gr2
         this->b = b;
     }
 
+    BachWeylRing* BachWeylRing::clone() const
+    {
+        BachWeylRing* spt = new BachWeylRing(this->M, this->b, this->lambda_eval_init, this->lambda_eval_run);
+        spt->set_lambda_index(this->lambda_index);
+        return spt;
+    }
+
     void BachWeylRing::calculate_lambda_init(real const* y)
     {
         switch (this->lambda_eval_init)
@@ -47,9 +54,9 @@ namespace gr2
     {
         real rho = y[RHO], z = y[Z];
         real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
+        real l1 = std::sqrt((rho-b)*(rho-b) + z*z);
+        real l2 = std::sqrt((rho+b)*(rho+b) + z*z);
+        real k = std::sqrt(4*rho*b/(l2*l2));
         elliptic_KE(k, K, E);
         
         this->nu = -2*M*K/(pi*l2);
@@ -57,69 +64,27 @@ namespace gr2
 
     void BachWeylRing::calculate_nu1(const real* y)
     {
-        real rho = y[RHO], z = y[Z];
-        real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
-        elliptic_KE(k, K, E);
-        
-        this->nu = -2*M*K/(pi*l2);
-        this->nu_rho = M*(l1*l1*K-(b*b + z*z - rho*rho)*E)/(pi*rho*l1*l1*l2);
-        this->nu_z = 2*M*E*z/(pi*l1*l1*l2);
+        // Potential of ring with unit mass and its derivatives
+        real f[3];
+        ring_potential1(y[RHO], y[Z], b, f);
+
+        this->nu = M*f[0];
+        this->nu_rho = M*f[1];
+        this->nu_z = M*f[2];
     }
 
     void BachWeylRing::calculate_nu2(const real* y)
     {
-        // Coordinates 
-        real rho = y[RHO], z = y[Z];
-
-        // Second derivatives of potential - functions
-        auto nu_rho_func = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_rho();
-        };
-
-        auto nu_z_func = [&rho, this](real z)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        auto nu_z_func_rho = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        // Second derivatives of potential
-        this->nu_rhorho = gr2::richder<5>(nu_rho_func, rho, 0.1, 1e-10);
-        this->nu_zz = gr2::richder<5>(nu_z_func, z, 0.1, 1e-10);
-        this->nu_rhoz = gr2::richder<5>(nu_z_func_rho, rho, 0.1, 1e-10);
-
-        // Prepare calculation
-        real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
-        elliptic_KE(k, K, E);
-        
-        // Potential
-        this->nu = -2*M*K/(pi*l2);
+        // Potential of ring with unit mass and its derivatives
+        real f[6];
+        ring_potential2(y[RHO], y[Z], b, f);
 
-        // First derivatives of potential
-        this->nu_rho = M*(l1*l1*K-(b*b + z*z - rho*rho)*E)/(pi*rho*l1*l1*l2);
-        this->nu_z = 2*M*E*z/(pi*l1*l1*l2);
+        this->nu = M*f[0];
+        this->nu_rho = M*f[1];
+        this->nu_z = M*f[2];
+        this->nu_rhorho = M*f[3];
+        this->nu_rhoz = M*f[4];
+        this->nu_zz = M*f[5];
     }
 
 }
\ No newline at end of file
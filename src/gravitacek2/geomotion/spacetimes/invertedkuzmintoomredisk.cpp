@@ -25,8 +25,8 @@ namespace gr2
 
         // create arrays
         this->B = new real[n+1];
-        this->P0 = new real[n+1];
-        this->P1 = new real[n+1];
+        this->P0 = new real[n+3];
+        this->P1 = new real[n+3];
 
         // calculate normalization
         real factorial = 1;
@@ -75,6 +75,13 @@ namespace gr2
         delete[] P1;
     }
 
+    InvertedKuzminToomreDisk* InvertedKuzminToomreDisk::clone() const
+    {
+        InvertedKuzminToomreDisk* spt = new InvertedKuzminToomreDisk(this->n, this->M, this->b, this->lambda_eval_init, this->lambda_eval_run);
+        spt->set_lambda_index(this->lambda_index);
+        return spt;
+    }
+
     void InvertedKuzminToomreDisk::calculate_lambda_init(real const* y)
     {
         switch (this->lambda_eval_init)
@@ -105,7 +112,7 @@ namespace gr2
     {
         real rho = y[RHO], z = y[Z];
         real abs_z = z>0? z:-z;
-        real rb = sqrtl(rho*rho + (abs_z+b)*(abs_z+b));
+        real rb = std::sqrt(rho*rho + (abs_z+b)*(abs_z+b));
         real P_arg = (abs_z + b)/rb;
 
         this->nu = 0;
@@ -130,7 +137,7 @@ namespace gr2
         real rho2 = rho*rho;
         int sign_z = z>0? 1:-1;
         real abs_z = sign_z*z;
-        real rb = sqrtl(rho*rho + (abs_z+b)*(abs_z+b));
+        real rb = std::sqrt(rho*rho + (abs_z+b)*(abs_z+b));
         real P_arg = (abs_z + b)/rb;
 
         nu = nu_rho = nu_z = 0;
@@ -158,69 +165,46 @@ namespace gr2
 
     void InvertedKuzminToomreDisk::calculate_nu2(const real* y)
     {
-        // Coordinates
+        // Every term is axial multipole f_k = P_k(cos theta)/r_b^(k+1) with
+        // respect to point z = -b, so derivatives along the axis are
+        // d/dz f_k = -(k+1) f_(k+1), d^2/dz^2 f_k = (k+1)(k+2) f_(k+2).
         real rho = y[RHO], z = y[Z];
-
-        // Second derivatives of potential - functions
-        auto nu_rho_func = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_rho();
-        };
-
-        auto nu_z_func = [&rho, this](real z)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        auto nu_z_func_rho = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        // Second derivatives of potential
-        this->nu_rhorho = gr2::richder<5>(nu_rho_func, rho, 0.1, 1e-10);
-        this->nu_zz = gr2::richder<5>(nu_z_func, z, 0.1, 1e-10);
-        this->nu_rhoz = gr2::richder<5>(nu_z_func_rho, rho, 0.1, 1e-10);
-
-        // Calculate potential and derivatives
         real rho2 = rho*rho;
         int sign_z = z>0? 1:-1;
         real abs_z = sign_z*z;
-        real rb = sqrtl(rho*rho + (abs_z+b)*(abs_z+b));
+        real rb = std::sqrt(rho*rho + (abs_z+b)*(abs_z+b));
         real P_arg = (abs_z + b)/rb;
 
-        nu = nu_rho = nu_z = 0;
+        // nu_rho/rho is summed separately, so that it has finite limit on the axis
+        real nu_rho_over_rho = 0;
+        nu = nu_z = nu_rhoz = nu_zz = 0;
         real b_pow = 1;
         real inv_rb = 1.0/rb;
         real inv_rb_pows = inv_rb;
         real inv_rb_pows2 = inv_rb*inv_rb*inv_rb;
 
-        legendre_polynomials1(P_arg, n+1, this->P0, this->P1);
+        legendre_polynomials1(P_arg, n+3, this->P0, this->P1);
 
         for (int k = 0; k <= n; k++)
         {
             nu += B[k]*b_pow*inv_rb_pows*P0[k];
-            nu_rho += B[k]*b_pow*inv_rb_pows2*rho*((k+1)*P0[k]+P_arg*P1[k]);
+            nu_rho_over_rho += B[k]*b_pow*inv_rb_pows2*((k+1)*P0[k]+P_arg*P1[k]);
             nu_z += B[k]*b_pow*inv_rb_pows2*((k+1)*(abs_z+b)*P0[k]-rho2*inv_rb*P1[k]);
+            nu_zz += B[k]*b_pow*inv_rb_pows2*(k+1)*(k+2)*P0[k+2];
+            nu_rhoz += B[k]*b_pow*inv_rb_pows2*inv_rb*(k+1)*rho*((k+2)*P0[k+1]+P_arg*P1[k+1]);
 
             b_pow *= -b;
             inv_rb_pows *= inv_rb;
             inv_rb_pows2 *= inv_rb;
         }
         nu *= N;
-        nu_rho *= -N;
+        nu_rho_over_rho *= -N;
+        nu_rho = rho*nu_rho_over_rho;
         nu_z *= -N*sign_z;
+        nu_zz *= N;
+        nu_rhoz *= N*sign_z;
+
+        // Laplace equation
+        nu_rhorho = -nu_zz - nu_rho_over_rho;
     }
 }
\ No newline at end of file
@@ -7,6 +7,55 @@
 
 namespace gr2
 {
+    // ========== Derivatives of composed functions ==========
+
+    /**
+     * @brief Value of function of \f$(\rho, z)\f$ with its first and second
+     * derivatives.
+     */
+    struct Jet2
+    {
+        real v;     //!<value
+        real r;     //!<derivative with respect to \f$\rho\f$
+        real z;     //!<derivative with respect to \f$z\f$
+        real rr;    //!<second derivative with respect to \f$\rho\f$
+        real rz;    //!<mixed second derivative
+        real zz;    //!<second derivative with respect to \f$z\f$
+    };
+
+    static Jet2 jet_mul(const Jet2 &a, const Jet2 &b)
+    {
+        return {a.v*b.v, a.r*b.v + a.v*b.r, a.z*b.v + a.v*b.z,
+            a.rr*b.v + 2*a.r*b.r + a.v*b.rr,
+            a.rz*b.v + a.r*b.z + a.z*b.r + a.v*b.rz,
+            a.zz*b.v + 2*a.z*b.z + a.v*b.zz};
+    }
+
+    static Jet2 jet_add(const Jet2 &a, const Jet2 &b, const real &c = 1)
+    {
+        return {a.v + c*b.v, a.r + c*b.r, a.z + c*b.z, a.rr + c*b.rr, a.rz + c*b.rz, a.zz + c*b.zz};
+    }
+
+    static Jet2 jet_scale(const Jet2 &a, const real &c)
+    {
+        return {c*a.v, c*a.r, c*a.z, c*a.rr, c*a.rz, c*a.zz};
+    }
+
+    // f(a) for function with value f0 and derivatives f1, f2 at a.v
+    static Jet2 jet_apply(const Jet2 &a, const real &f0, const real &f1, const real &f2)
+    {
+        return {f0, f1*a.r, f1*a.z,
+            f2*a.r*a.r + f1*a.rr,
+            f2*a.r*a.z + f1*a.rz,
+            f2*a.z*a.z + f1*a.zz};
+    }
+
+    static Jet2 jet_sqrt(const Jet2 &a)
+    {
+        real s = std::sqrt(a.v);
+        return jet_apply(a, s, 0.5/s, -0.25/(s*a.v));
+    }
+
     void InvertedMorganMorganDisk::calculate_lambda_integral(const real* y)
     {
         calculate_lambda_from_inf_to_z(y, 1e-15);
@@ -23,15 +72,19 @@ namespace gr2
         this->C = nullptr;
         this->P0 = nullptr;
         this->P1 = nullptr;
+        this->P2 = nullptr;
         this->Q0 = nullptr;
         this->Q1 = nullptr;
+        this->Q2 = nullptr;
 
         // create arrays
         C = new real[n+1];
         P0 = new real[2*n+1];
         P1 = new real[2*n+1];
+        P2 = new real[2*n+1];
         Q0 = new real[n+1];
         Q1 = new real[n+1];
+        Q2 = new real[n+1];
 
         // calculate normalization
         real pow2 = 2;
@@ -64,8 +117,17 @@ namespace gr2
         delete[] C;
         delete[] P0;
         delete[] P1;
+        delete[] P2;
         delete[] Q0;
         delete[] Q1;
+        delete[] Q2;
+    }
+
+    InvertedMorganMorganDisk* InvertedMorganMorganDisk::clone() const
+    {
+        InvertedMorganMorganDisk* spt = new InvertedMorganMorganDisk(this->n, this->M, this->b, this->lambda_eval_init, this->lambda_eval_run);
+        spt->set_lambda_index(this->lambda_index);
+        return spt;
     }
 
     void InvertedMorganMorganDisk::calculate_lambda_init(real const* y)
@@ -98,10 +160,10 @@ namespace gr2
     {
         real rho = y[RHO], z = std::max<gr2::real>(std::abs(y[Z]),1e-6);
         real alpha = rho*rho + z*z - b*b;
-        real help_term = sqrtl(alpha*alpha + 4*(z*z)*(b*b));
-        real x = sqrtl(alpha + help_term)/(sqrtl(2)*b);
-        real y_ = sqrtl(-alpha + help_term)/(sqrtl(2)*b);
-        help_term = sqrtl(x*x - y_*y_ + 1);
+        real help_term = std::sqrt(alpha*alpha + 4*(z*z)*(b*b));
+        real x = std::sqrt(alpha + help_term)/(std::sqrt(real(2))*b);
+        real y_ = std::sqrt(-alpha + help_term)/(std::sqrt(real(2))*b);
+        help_term = std::sqrt(x*x - y_*y_ + 1);
         real Y = y_/help_term;
         real X = x/help_term;
 
@@ -120,10 +182,10 @@ namespace gr2
     {
         real rho = y[RHO], z = std::max<gr2::real>(std::abs(y[Z]),1e-6);
         real alpha = rho*rho + z*z - b*b;
-        real help_term1 = sqrtl(alpha*alpha + 4*(z*z)*(b*b));
-        real x = sqrtl(alpha + help_term1)/(sqrtl(2)*b);
-        real y_ = sqrtl(-alpha + help_term1)/(sqrtl(2)*b);
-        real help_term2 = sqrtl(x*x - y_*y_ + 1);
+        real help_term1 = std::sqrt(alpha*alpha + 4*(z*z)*(b*b));
+        real x = std::sqrt(alpha + help_term1)/(std::sqrt(real(2))*b);
+        real y_ = std::sqrt(-alpha + help_term1)/(std::sqrt(real(2))*b);
+        real help_term2 = std::sqrt(x*x - y_*y_ + 1);
         real Y = y_/help_term2;
         real X = x/help_term2;
         real x_rho = x*rho/help_term1;
@@ -165,85 +227,38 @@ namespace gr2
 
     void InvertedMorganMorganDisk::calculate_nu2(const real *y)
     {
-        // Coordinates
+        // Coordinates (derivatives are propagated through all substitutions)
         real rho = y[RHO], z = std::max<gr2::real>(std::abs(y[Z]),1e-6);
-
-        // Second derivatives of potential - functions
-        auto nu_rho_func = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_rho();
-        };
-
-        auto nu_z_func = [&rho, this](real z)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        auto nu_z_func_rho = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_nu1(y);
-            return this->get_nu_z();
-        };
-
-        // Second derivatives of potential
-        this->nu_rhorho = gr2::richder<5>(nu_rho_func, rho, 0.1, 1e-10);
-        this->nu_zz = gr2::richder<5>(nu_z_func, z, 0.1, 1e-10);
-        this->nu_rhoz = gr2::richder<5>(nu_z_func_rho, rho, 0.1, 1e-10);
-
-        // Calculation of the rest
-        real alpha = rho*rho + z*z - b*b;
-        real help_term1 = sqrtl(alpha*alpha + 4*(z*z)*(b*b));
-        real x = sqrtl(alpha + help_term1)/(sqrtl(2)*b);
-        real y_ = sqrtl(-alpha + help_term1)/(sqrtl(2)*b);
-        real help_term2 = sqrtl(x*x - y_*y_ + 1);
-        real Y = y_/help_term2;
-        real X = x/help_term2;
-        real x_rho = x*rho/help_term1;
-        real y_rho = -y_*rho/help_term1;
-        real x_z = z*(alpha + 2*b*b + help_term1)/(2*b*b*x*help_term1);
-        real y_z = z*(alpha + 2*b*b - help_term1)/(2*b*b*y_*help_term1);
-        real X_rho = ((1-y_*y_)*x_rho + x*y_*y_rho)/(help_term2*help_term2*help_term2);
-        real Y_rho = (-x*y_*x_rho + (x*x+1)*y_rho)/(help_term2*help_term2*help_term2);
-        real X_z = ((1-y_*y_)*x_z + x*y_*y_z)/(help_term2*help_term2*help_term2);
-        real Y_z = (-x*y_*x_z + (x*x+1)*y_z)/(help_term2*help_term2*help_term2);
-
-        legendre_polynomials1(X, 2*n + 1, P0, P1);
-        special_function_Q2n1(Y, n + 1, Q0, Q1);
-
-        nu = 0;
-        nu_rho = 0;
-        nu_z = 0;
+        Jet2 z_jet = {z, 0, 1, 0, 0, 0};
+        Jet2 r2 = {rho*rho + z*z, 2*rho, 2*z, 2, 0, 2};
+        Jet2 alpha = jet_add(r2, {b*b, 0, 0, 0, 0, 0}, -1);
+        Jet2 help_term1 = jet_sqrt(jet_add(jet_mul(alpha, alpha), jet_mul(z_jet, z_jet), 4*b*b));
+        Jet2 x = jet_scale(jet_sqrt(jet_add(help_term1, alpha)), 1/(std::sqrt(real(2))*b));
+        Jet2 y_ = jet_scale(jet_sqrt(jet_add(help_term1, alpha, -1)), 1/(std::sqrt(real(2))*b));
+        Jet2 help_term2 = jet_scale(jet_sqrt(r2), 1/b);
+        real h = help_term2.v;
+        Jet2 help_term2_inv = jet_apply(help_term2, 1/h, -1/(h*h), 2/(h*h*h));
+        Jet2 X = jet_mul(x, help_term2_inv);
+        Jet2 Y = jet_mul(y_, help_term2_inv);
+
+        legendre_polynomials2(X.v, 2*n + 1, P0, P1, P2);
+        special_function_Q2n2(Y.v, n + 1, Q0, Q1, Q2);
+
+        Jet2 sum = {0, 0, 0, 0, 0, 0};
         for (int m = 0; m<= n; m++)
         {
-            nu += C[m]*Q0[m]*P0[2*m];
-
-            nu_rho += C[m]*Q1[m]*P0[2*m]*Y_rho;
-            nu_rho += C[m]*Q0[m]*P1[2*m]*X_rho;
-
-            nu_z += C[m]*Q1[m]*P0[2*m]*Y_z;
-            nu_z += C[m]*Q0[m]*P1[2*m]*X_z;
+            Jet2 Q = jet_apply(Y, Q0[m], Q1[m], Q2[m]);
+            Jet2 P = jet_apply(X, P0[2*m], P1[2*m], P2[2*m]);
+            sum = jet_add(sum, jet_mul(Q, P), C[m]);
         }
-
-        nu_rho += -rho*nu/(b*b)/(help_term2*help_term2);
-        nu_z += -z*nu/(b*b)/(help_term2*help_term2);
-
-        nu *= N/help_term2;
-        nu_rho *= N/help_term2;
-        nu_z *= N/help_term2;
-
-        if (y[Z] <0)
-            nu_z *= -1;
+        Jet2 potential = jet_scale(jet_mul(sum, help_term2_inv), N);
+
+        int sign_z = y[Z] < 0 ? -1 : 1;
+        nu = potential.v;
+        nu_rho = potential.r;
+        nu_z = sign_z*potential.z;
+        nu_rhorho = potential.rr;
+        nu_rhoz = sign_z*potential.rz;
+        nu_zz = potential.zz;
     }
-}
-
+}
\ No newline at end of file
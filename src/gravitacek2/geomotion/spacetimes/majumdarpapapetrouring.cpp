@@ -16,13 +16,18 @@ namespace gr2
 
     };
 
+    MajumdarPapapetrouRing* MajumdarPapapetrouRing::clone() const
+    {
+        return new MajumdarPapapetrouRing(this->M, this->b);
+    }
+
     void MajumdarPapapetrouRing::calculate_N_inv(const real* y)
     {
         real rho = y[RHO], z = y[Z];
         real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
+        real l1 = std::sqrt((rho-b)*(rho-b) + z*z);
+        real l2 = std::sqrt((rho+b)*(rho+b) + z*z);
+        real k = std::sqrt(4*rho*b/(l2*l2));
         elliptic_KE(k, K, E);
 
         this->N_inv = 1 + 2*M*K/(pi*l2);
@@ -31,63 +36,27 @@ namespace gr2
 
     void MajumdarPapapetrouRing::calculate_N_inv1(const real* y)
     {
-        real rho = y[RHO], z = y[Z];
-        real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
-        elliptic_KE(k, K, E);
+        // Potential of ring with unit mass and its derivatives
+        real f[3];
+        ring_potential1(y[RHO], y[Z], b, f);
 
-        this->N_inv = 1 + 2*M*K/(pi*l2);
-        this->N_inv_rho = -M*(l1*l1*K-(b*b + z*z - rho*rho)*E)/(pi*rho*l1*l1*l2);
-        this->N_inv_z = -2*M*E*z/(pi*l1*l1*l2);
+        this->N_inv = 1 - M*f[0];
+        this->N_inv_rho = -M*f[1];
+        this->N_inv_z = -M*f[2];
     };
 
 
     void MajumdarPapapetrouRing::calculate_N_inv2(const real* y)
     {
-        real rho = y[RHO], z = y[Z];
-
-        auto N_inv_rho_func = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_N_inv1(y);
-            return this->get_N_inv_rho();
-        };
-        
-        auto N_inv_z_func = [&rho, this](real z)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_N_inv1(y);
-            return this->get_N_inv_z();
-        };
-
-        auto N_inv_z_func_rho = [&z, this](real rho)
-        {
-            real y[] = {0, 0, 0, 0};
-            y[RHO] = rho;
-            y[Z] = z;
-            this->calculate_N_inv1(y);
-            return this->get_N_inv_z();
-        };
-
-        // Second derivatives of N_inv
-        this->N_inv_rhorho = gr2::richder<5>(N_inv_rho_func, rho, 0.1, 1e-10);
-        this->N_inv_zz = gr2::richder<5>(N_inv_z_func, z, 0.1, 1e-10);
-        this->N_inv_rhoz = gr2::richder<5>(N_inv_z_func_rho, rho, 0.1, 1e-10);
-
-        real K, E;
-        real l1 = sqrtl((rho-b)*(rho-b) + z*z);
-        real l2 = sqrtl((rho+b)*(rho+b) + z*z);
-        real k = sqrtl(4*rho*b/(l2*l2));
-        elliptic_KE(k, K, E);
-
-        this->N_inv = 1 + 2*M*K/(pi*l2);
-        this->N_inv_rho = -M*(l1*l1*K-(b*b + z*z - rho*rho)*E)/(pi*rho*l1*l1*l2);
-        this->N_inv_z = -2*M*E*z/(pi*l1*l1*l2);
+        // Potential of ring with unit mass and its derivatives
+        real f[6];
+        ring_potential2(y[RHO], y[Z], b, f);
+
+        this->N_inv = 1 - M*f[0];
+        this->N_inv_rho = -M*f[1];
+        this->N_inv_z = -M*f[2];
+        this->N_inv_rhorho = -M*f[3];
+        this->N_inv_rhoz = -M*f[4];
+        this->N_inv_zz = -M*f[5];
     };
 }
\ No newline at end of file
@@ -16,12 +16,17 @@ namespace gr2
 
     };
 
+    ReissnerNordstromMPW* ReissnerNordstromMPW::clone() const
+    {
+        return new ReissnerNordstromMPW(this->M);
+    }
+
     void ReissnerNordstromMPW::calculate_N_inv(const real* y) 
     {
         // coordinates
         real rho = y[RHO];
         real z = y[Z];
-        real d = sqrtl(rho*rho + z*z);
+        real d = std::sqrt(rho*rho + z*z);
         real d_inv = 1.0/d;
 
         // lapse
@@ -33,7 +38,7 @@ namespace gr2
         // coordinates
         real rho = y[RHO];
         real z = y[Z];
-        real d = sqrtl(rho*rho + z*z);
+        real d = std::sqrt(rho*rho + z*z);
         real d_inv = 1.0/d;
         real M_d_inv = 1.0/(M+d);
 
@@ -50,7 +55,7 @@ namespace gr2
         // coordinates
         real rho = y[RHO];
         real z = y[Z];
-        real d = sqrtl(rho*rho + z*z);
+        real d = std::sqrt(rho*rho + z*z);
         real d_inv = 1.0/d;
         real M_d_inv = 1.0/(M+d);
         real d_inv5 = d_inv*d_inv*d_inv*d_inv*d_inv;
@@ -7,6 +7,19 @@ namespace gr2
     Schwarzschild::Schwarzschild(real M) : GeoMotion(4, 8)
     {
         this->M = M;
+
+        // nonzero Christoffel symbols
+        this->set_christoffel_sparsity({
+            {T, T, R},
+            {R, T, T}, {R, R, R}, {R, THETA, THETA}, {R, PHI, PHI},
+            {THETA, R, THETA}, {THETA, PHI, PHI},
+            {PHI, R, PHI}, {PHI, THETA, PHI}
+        });
+    }
+
+    Schwarzschild* Schwarzschild::clone() const
+    {
+        return new Schwarzschild(this->M);
     }
 
     void Schwarzschild::calculate_metric(const real *y)
@@ -19,7 +32,7 @@ namespace gr2
         real theta = y[THETA];
         real phi = y[PHI];
 
-        real sin_val = sinl(theta);
+        real sin_val = std::sin(theta);
 
         metric[T][T] = -(1 - 2 * M / r);
         metric[R][R] = 1.0 / (1 - 2.0 * M / r);
@@ -37,8 +50,8 @@ namespace gr2
         real theta = y[THETA];
         real phi = y[PHI];
 
-        real sin_val = sinl(theta);
-        real cos_val = cosl(theta);
+        real sin_val = std::sin(theta);
+        real cos_val = std::cos(theta);
 
         // ========== Christoffels symbols =========
         christoffel_symbols[T][T][R] = M / (r*(r - 2 * M));
@@ -66,8 +79,8 @@ namespace gr2
         real theta = y[THETA];
         real phi = y[PHI];
 
-        real sin_val = sinl(theta);
-        real cos_val = cosl(theta);
+        real sin_val = std::sin(theta);
+        real cos_val = std::cos(theta);
 
         // ========== Riemann tensor ========== 
         riemann_tensor[T][R][T][R] = 2*M/(r*r*(r-2*M));
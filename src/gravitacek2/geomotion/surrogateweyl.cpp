@@ -0,0 +1,347 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "gravitacek2/geomotion/weyl.hpp"
+
+namespace gr2
+{
+    // ========== Construction of patches ==========
+
+    /**
+     * @brief Values of potential used for Hermite interpolation.
+     */
+    struct SurrogateSample
+    {
+        real nu;        //!<value of \f$\nu\f$
+        real nu_rho;    //!<value of \f$\nu_{,\rho}\f$
+        real nu_z;      //!<value of \f$\nu_{,z}\f$
+        real nu_rhoz;   //!<value of \f$\nu_{,\rho z}\f$
+    };
+
+    static SurrogateSample sample_source(Weyl &source, const real &rho, const real &z)
+    {
+        real y[] = {0, 0, 0, 0};
+        // one-sided limit z -> 0+ (derivatives can be discontinuous on equatorial plane)
+        y[Weyl::Z] = z > 0 ? z : std::numeric_limits<real>::min();
+
+        // mixed derivative by central difference (second derivatives of sources are often numerical)
+        real d = 1e-5*std::max(rho, (real)1);
+        real rho_minus = std::max(rho - d, (real)0);
+        y[Weyl::RHO] = rho + d;
+        source.calculate_nu1(y);
+        real nu_z_plus = source.get_nu_z();
+        y[Weyl::RHO] = rho_minus;
+        source.calculate_nu1(y);
+        real nu_z_minus = source.get_nu_z();
+
+        y[Weyl::RHO] = rho;
+        source.calculate_nu1(y);
+        return {source.get_nu(), source.get_nu_rho(), source.get_nu_z(), (nu_z_plus - nu_z_minus)/(rho + d - rho_minus)};
+    }
+
+    static void hermite_coefficients(SurrogatePatch &patch, const SurrogateSample corners[2][2])
+    {
+        static const real M[4][4] = {{1, 0, 0, 0}, {0, 0, 1, 0}, {-3, 3, -2, -1}, {2, -2, 1, 1}};
+
+        // values and scaled derivatives in corners
+        real F[4][4];
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++)
+            {
+                const SurrogateSample &s = corners[i][j];
+                F[i][j] = s.nu;
+                F[i][2+j] = patch.h_z*s.nu_z;
+                F[2+i][j] = patch.h_rho*s.nu_rho;
+                F[2+i][2+j] = patch.h_rho*patch.h_z*s.nu_rhoz;
+            }
+
+        // a = M F M^T
+        real MF[4][4];
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                MF[i][j] = 0;
+                for (int k = 0; k < 4; k++)
+                    MF[i][j] += M[i][k]*F[k][j];
+            }
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                patch.a[4*i+j] = 0;
+                for (int k = 0; k < 4; k++)
+                    patch.a[4*i+j] += MF[i][k]*M[j][k];
+            }
+    }
+
+    static void hermite_evaluate(const SurrogatePatch &patch, const real &u, const real &v, real values[6])
+    {
+        // powers and their derivatives
+        real U[4] = {1, u, u*u, u*u*u}, dU[4] = {0, 1, 2*u, 3*u*u}, ddU[4] = {0, 0, 2, 6*u};
+        real V[4] = {1, v, v*v, v*v*v}, dV[4] = {0, 1, 2*v, 3*v*v}, ddV[4] = {0, 0, 2, 6*v};
+
+        // contraction with coefficients in v
+        real aV[4], adV[4], addV[4];
+        for (int i = 0; i < 4; i++)
+        {
+            const real *a = patch.a + 4*i;
+            aV[i] = a[0]*V[0] + a[1]*V[1] + a[2]*V[2] + a[3]*V[3];
+            adV[i] = a[1]*dV[1] + a[2]*dV[2] + a[3]*dV[3];
+            addV[i] = a[2]*ddV[2] + a[3]*ddV[3];
+        }
+
+        real p = 0, p_u = 0, p_v = 0, p_uu = 0, p_uv = 0, p_vv = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            p += U[i]*aV[i];
+            p_u += dU[i]*aV[i];
+            p_v += U[i]*adV[i];
+            p_uu += ddU[i]*aV[i];
+            p_uv += dU[i]*adV[i];
+            p_vv += U[i]*addV[i];
+        }
+
+        values[0] = p;
+        values[1] = p_u/patch.h_rho;
+        values[2] = p_v/patch.h_z;
+        values[3] = p_uu/(patch.h_rho*patch.h_rho);
+        values[4] = p_uv/(patch.h_rho*patch.h_z);
+        values[5] = p_vv/(patch.h_z*patch.h_z);
+    }
+
+    static void build_patch(std::vector<SurrogatePatch> &patches, const int &index, Weyl &source, const SurrogateSample corners[2][2], const int &depth, const int &max_depth, const real &tol, real &error)
+    {
+        SurrogatePatch &patch = patches[index];
+        patch.child = -1;
+        hermite_coefficients(patch, corners);
+        real rho0 = patch.rho0, z0 = patch.z0, h_rho = patch.h_rho, h_z = patch.h_z;
+
+        // samples on 3x3 grid (corners are known)
+        SurrogateSample S[3][3];
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++)
+                S[2*i][2*j] = corners[i][j];
+
+        // compare interpolation with source in center and middles of edges
+        real patch_error = 0;
+        real values[6];
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+            {
+                if (i%2 == 0 && j%2 == 0)
+                    continue;
+                S[i][j] = sample_source(source, rho0 + 0.5*i*h_rho, z0 + 0.5*j*h_z);
+                hermite_evaluate(patch, 0.5*i, 0.5*j, values);
+                patch_error = std::max(patch_error, std::abs(values[0] - S[i][j].nu));
+                patch_error = std::max(patch_error, std::abs(values[1] - S[i][j].nu_rho));
+                patch_error = std::max(patch_error, std::abs(values[2] - S[i][j].nu_z));
+            }
+
+        // accept patch
+        if (!(patch_error > tol) || depth >= max_depth)
+        {
+            error = std::max(error, patch_error);
+            return;
+        }
+
+        // divide patch into four
+        int child = patches.size();
+        patches[index].child = child;
+        patches.resize(child + 4);
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++)
+            {
+                SurrogatePatch &c = patches[child + i + 2*j];
+                c.rho0 = rho0 + 0.5*i*h_rho;
+                c.z0 = z0 + 0.5*j*h_z;
+                c.h_rho = 0.5*h_rho;
+                c.h_z = 0.5*h_z;
+                SurrogateSample child_corners[2][2] = {{S[i][j], S[i][j+1]}, {S[i+1][j], S[i+1][j+1]}};
+                build_patch(patches, child + i + 2*j, source, child_corners, depth + 1, max_depth, tol, error);
+            }
+    }
+
+    // ========== SurrogateWeyl ==========
+
+    SurrogateWeyl::SurrogateWeyl(std::shared_ptr<Weyl> source, const real &rho_min, const real &rho_max, const real &z_max, const real &tol, const int &n_rho, const int &n_z, const int &max_depth) : Weyl(LambdaEvaluation::custom, LambdaEvaluation::diff), source(source)
+    {
+        if (!(rho_min >= 0 && rho_max > rho_min && z_max > 0))
+            throw std::invalid_argument("invalid region for SurrogateWeyl");
+        if (n_rho <= 0 || n_z <= 0 || max_depth < 0)
+            throw std::invalid_argument("invalid number of patches for SurrogateWeyl");
+
+        this->rho_min = rho_min;
+        this->rho_max = rho_max;
+        this->z_max = z_max;
+        this->n_rho = n_rho;
+        this->n_z = n_z;
+        this->sampled_error = 0;
+
+        // samples on grid of root patches
+        real h_rho = (rho_max - rho_min)/n_rho;
+        real h_z = z_max/n_z;
+        std::vector<SurrogateSample> grid((n_rho+1)*(n_z+1));
+        for (int i = 0; i <= n_rho; i++)
+            for (int j = 0; j <= n_z; j++)
+                grid[i + (n_rho+1)*j] = sample_source(*source, rho_min + i*h_rho, j*h_z);
+
+        // only z >= 0 is tabulated, source has to be symmetric
+        for (int i = 0; i <= n_rho; i++)
+            for (int j = 1; j <= n_z; j++)
+            {
+                const SurrogateSample &s = grid[i + (n_rho+1)*j];
+                real y[] = {0, 0, rho_min + i*h_rho, -j*h_z};
+                source->calculate_nu1(y);
+                if (std::abs(source->get_nu() - s.nu) > tol || std::abs(source->get_nu_rho() - s.nu_rho) > tol || std::abs(source->get_nu_z() + s.nu_z) > tol)
+                    throw std::invalid_argument("source of SurrogateWeyl is not symmetric with respect to equatorial plane");
+            }
+
+        // root patches and their quadtrees
+        auto table = std::make_shared<std::vector<SurrogatePatch>>(n_rho*n_z);
+        for (int i = 0; i < n_rho; i++)
+            for (int j = 0; j < n_z; j++)
+            {
+                SurrogatePatch &patch = (*table)[i + n_rho*j];
+                patch.rho0 = rho_min + i*h_rho;
+                patch.z0 = j*h_z;
+                patch.h_rho = h_rho;
+                patch.h_z = h_z;
+                SurrogateSample corners[2][2] = {
+                    {grid[i + (n_rho+1)*j], grid[i + (n_rho+1)*(j+1)]},
+                    {grid[i+1 + (n_rho+1)*j], grid[i+1 + (n_rho+1)*(j+1)]}
+                };
+                build_patch(*table, i + n_rho*j, *source, corners, 0, max_depth, tol, this->sampled_error);
+            }
+        this->patches = table;
+    }
+
+    SurrogateWeyl::SurrogateWeyl(std::shared_ptr<Weyl> source, const SurrogateWeyl &other) : Weyl(LambdaEvaluation::custom, LambdaEvaluation::diff), source(source)
+    {
+        this->rho_min = other.rho_min;
+        this->rho_max = other.rho_max;
+        this->z_max = other.z_max;
+        this->n_rho = other.n_rho;
+        this->n_z = other.n_z;
+        this->sampled_error = other.sampled_error;
+        this->patches = other.patches;
+    }
+
+    SurrogateWeyl::~SurrogateWeyl()
+    {
+
+    }
+
+    SurrogateWeyl* SurrogateWeyl::clone() const
+    {
+        SurrogateWeyl* spt = new SurrogateWeyl(std::shared_ptr<Weyl>(this->source->clone()), *this);
+        spt->set_lambda_index(this->lambda_index);
+        return spt;
+    }
+
+    real SurrogateWeyl::get_sampled_error() const
+    {
+        return this->sampled_error;
+    }
+
+    int SurrogateWeyl::get_number_of_patches() const
+    {
+        return this->patches->size();
+    }
+
+    const SurrogatePatch* SurrogateWeyl::find_patch(const real &rho, const real &abs_z) const
+    {
+        if (!(rho >= rho_min && rho <= rho_max && abs_z <= z_max))
+            return nullptr;
+
+        // root patch
+        const SurrogatePatch *root = this->patches->data();
+        int i = std::min((int)((rho - rho_min)/root->h_rho), n_rho - 1);
+        int j = std::min((int)(abs_z/root->h_z), n_z - 1);
+        const SurrogatePatch *patch = root + i + n_rho*j;
+
+        // descend in quadtree
+        while (patch->child >= 0)
+        {
+            int ci = rho >= patch->rho0 + 0.5*patch->h_rho ? 1 : 0;
+            int cj = abs_z >= patch->z0 + 0.5*patch->h_z ? 1 : 0;
+            patch = root + patch->child + ci + 2*cj;
+        }
+        return patch;
+    }
+
+    void SurrogateWeyl::calculate_lambda_init(real const* y)
+    {
+        this->source->calculate_lambda_init(y);
+        this->lambda = this->source->get_lambda();
+    }
+
+    void SurrogateWeyl::calculate_lambda_run(real const* y)
+    {
+        this->calculate_lambda_diff(y);
+    }
+
+    void SurrogateWeyl::calculate_nu(const real* y)
+    {
+        real rho = y[RHO], z = y[Z];
+        const SurrogatePatch *patch = this->find_patch(rho, std::abs(z));
+        if (!patch)
+        {
+            this->source->calculate_nu(y);
+            this->nu = this->source->get_nu();
+            return;
+        }
+
+        real values[6];
+        hermite_evaluate(*patch, (rho - patch->rho0)/patch->h_rho, (std::abs(z) - patch->z0)/patch->h_z, values);
+        this->nu = values[0];
+    }
+
+    void SurrogateWeyl::calculate_nu1(const real* y)
+    {
+        real rho = y[RHO], z = y[Z];
+        const SurrogatePatch *patch = this->find_patch(rho, std::abs(z));
+        if (!patch)
+        {
+            this->source->calculate_nu1(y);
+            this->nu = this->source->get_nu();
+            this->nu_rho = this->source->get_nu_rho();
+            this->nu_z = this->source->get_nu_z();
+            return;
+        }
+
+        real values[6];
+        real sign_z = z < 0 ? -1 : 1;
+        hermite_evaluate(*patch, (rho - patch->rho0)/patch->h_rho, (std::abs(z) - patch->z0)/patch->h_z, values);
+        this->nu = values[0];
+        this->nu_rho = values[1];
+        this->nu_z = sign_z*values[2];
+    }
+
+    void SurrogateWeyl::calculate_nu2(const real* y)
+    {
+        real rho = y[RHO], z = y[Z];
+        const SurrogatePatch *patch = this->find_patch(rho, std::abs(z));
+        if (!patch)
+        {
+            this->source->calculate_nu2(y);
+            this->nu = this->source->get_nu();
+            this->nu_rho = this->source->get_nu_rho();
+            this->nu_z = this->source->get_nu_z();
+            this->nu_rhorho = this->source->get_nu_rhorho();
+            this->nu_rhoz = this->source->get_nu_rhoz();
+            this->nu_zz = this->source->get_nu_zz();
+            return;
+        }
+
+        real values[6];
+        real sign_z = z < 0 ? -1 : 1;
+        hermite_evaluate(*patch, (rho - patch->rho0)/patch->h_rho, (std::abs(z) - patch->z0)/patch->h_z, values);
+        this->nu = values[0];
+        this->nu_rho = values[1];
+        this->nu_z = sign_z*values[2];
+        this->nu_rhorho = values[3];
+        this->nu_rhoz = sign_z*values[4];
+        this->nu_zz = values[5];
+    }
+}
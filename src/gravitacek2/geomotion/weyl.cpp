@@ -1,5 +1,6 @@
 #include <cmath>
 #include <stdexcept>
+#include <algorithm>
 
 #include "gravitacek2/geomotion/weyl.hpp"
 #include "gravitacek2/mymath.hpp"
@@ -30,7 +31,7 @@ namespace gr2
         for (i = 0; i < I_MAX; i++)
         {
             real val = integrated_function(a);
-            if (fabsl(val)*a < eps)
+            if (std::abs(val)*a < eps)
                 break;
             a *= 0.5;
         }
@@ -50,6 +51,19 @@ namespace gr2
 
         // index of lambda
         this->lambda_index = LAMBDA;
+
+        // empty cache of potential
+        this->nu = this->nu_rho = this->nu_z = 0;
+        this->nu_rhorho = this->nu_rhoz = this->nu_zz = 0;
+        this->jet_order = -1;
+
+        // nonzero Christoffel symbols
+        this->set_christoffel_sparsity({
+            {T, T, RHO}, {T, T, Z},
+            {PHI, PHI, RHO}, {PHI, PHI, Z},
+            {RHO, T, T}, {RHO, PHI, PHI}, {RHO, RHO, RHO}, {RHO, RHO, Z}, {RHO, Z, Z},
+            {Z, T, T}, {Z, PHI, PHI}, {Z, RHO, RHO}, {Z, RHO, Z}, {Z, Z, Z}
+        });
     }
 
     Weyl::~Weyl()
@@ -107,6 +121,45 @@ namespace gr2
         return this->lambda_index;
     }
 
+    void Weyl::evaluate(const real *y, const int &order)
+    {
+        // use cached values
+        if (jet_order >= order && y[RHO] == jet_rho && y[Z] == jet_z)
+        {
+            nu = jet[0];
+            nu_rho = jet[1];
+            nu_z = jet[2];
+            nu_rhorho = jet[3];
+            nu_rhoz = jet[4];
+            nu_zz = jet[5];
+            return;
+        }
+
+        switch (order)
+        {
+        case 0:
+            this->calculate_nu(y);
+            break;
+        case 1:
+            this->calculate_nu1(y);
+            break;
+        default:
+            this->calculate_nu2(y);
+            break;
+        }
+
+        // save values
+        jet_order = std::min(order, 2);
+        jet_rho = y[RHO];
+        jet_z = y[Z];
+        jet[0] = nu;
+        jet[1] = nu_rho;
+        jet[2] = nu_z;
+        jet[3] = nu_rhorho;
+        jet[4] = nu_rhoz;
+        jet[5] = nu_zz;
+    }
+
     void Weyl::calculate_metric(const real *y)
     {
         if(!necessary_calculate(y, y_m, dim))
@@ -118,11 +171,11 @@ namespace gr2
         real z = y[Z];
 
         this->calculate_lambda_run(y); 
-        this->calculate_nu(y);
+        this->evaluate(y, 0);
 
-        real exp_2nu = expl(2*nu);
-        real exp_2nu_inv = expl(-2*nu);
-        real exp_2lambda_2nu_inv = expl(2*lambda-2*nu);
+        real exp_2nu = std::exp(2*nu);
+        real exp_2nu_inv = std::exp(-2*nu);
+        real exp_2lambda_2nu_inv = std::exp(2*lambda-2*nu);
 
         metric[T][T] = -exp_2nu;
         metric[PHI][PHI] = rho*rho*exp_2nu_inv;
@@ -141,10 +194,10 @@ namespace gr2
         real z = y[Z];
 
         this->calculate_lambda_run(y);
-        this->calculate_nu1(y);
+        this->evaluate(y, 1);
 
-        real exp_4nu = expl(4*nu);
-        real exp_2lambda_inv = expl(-2*lambda);
+        real exp_4nu = std::exp(4*nu);
+        real exp_2lambda_inv = std::exp(-2*lambda);
         this->lambda_rho = rho*(nu_rho*nu_rho - nu_z*nu_z);
         this->lambda_z = 2*rho*nu_rho*nu_z;
 
@@ -181,10 +234,10 @@ namespace gr2
         real z = y[Z];
 
         this->calculate_lambda_run(y);
-        this->calculate_nu2(y);
+        this->evaluate(y, 2);
 
-        real exp_4nu = expl(4*nu);
-        real exp_2lambda_inv = expl(-2*lambda);
+        real exp_4nu = std::exp(4*nu);
+        real exp_2lambda_inv = std::exp(-2*lambda);
         real rho_inv = 1.0/rho;
 
         // First derivatives of lambda
@@ -246,4 +299,59 @@ namespace gr2
         if (this->lambda_eval_run == gr2::diff)
             dydt[this->lambda_index] = this->lambda_rho*y[URHO] + this->lambda_z*y[UZ];
     }
+
+    void Weyl::function_batch(const int &lanes, const real t[], const real y[], real dydt[])
+    {
+        // ========== Potential of each lane ==========
+        batch_y.resize(n);
+        batch_nu.resize(4*lanes);
+        real *nu_l = batch_nu.data();
+        real *nu_rho_l = nu_l + lanes;
+        real *nu_z_l = nu_rho_l + lanes;
+        real *lambda_l = nu_z_l + lanes;
+        for (int l = 0; l < lanes; l++)
+        {
+            for (int i = 0; i < n; i++)
+                batch_y[i] = y[i*lanes + l];
+            this->calculate_lambda_run(batch_y.data());
+            this->evaluate(batch_y.data(), 1);
+            nu_l[l] = nu;
+            nu_rho_l[l] = nu_rho;
+            nu_z_l[l] = nu_z;
+            lambda_l[l] = lambda;
+        }
+
+        // ========== Derivation of position ==========
+        for (int i = 0; i < dim*lanes; i++)
+            dydt[i] = y[dim*lanes + i];
+
+        // ========== Derivation of velocity ==========
+        const real *rho = y + RHO*lanes;
+        const real *ut = y + UT*lanes, *uphi = y + UPHI*lanes, *urho = y + URHO*lanes, *uz = y + UZ*lanes;
+        real *at = dydt + UT*lanes, *aphi = dydt + UPHI*lanes, *arho = dydt + URHO*lanes, *az = dydt + UZ*lanes;
+        for (int l = 0; l < lanes; l++)
+        {
+            real exp_2lambda_inv = std::exp(-2*lambda_l[l]);
+            real exp_4nu_2lambda_inv = std::exp(4*nu_l[l] - 2*lambda_l[l]);
+            real lambda_rho = rho[l]*(nu_rho_l[l]*nu_rho_l[l] - nu_z_l[l]*nu_z_l[l]);
+            real lambda_z = 2*rho[l]*nu_rho_l[l]*nu_z_l[l];
+            real a = lambda_rho - nu_rho_l[l];
+            real b = lambda_z - nu_z_l[l];
+            real urho2_uz2 = urho[l]*urho[l] - uz[l]*uz[l];
+            real urho_uz = urho[l]*uz[l];
+
+            at[l] = -2*ut[l]*(nu_rho_l[l]*urho[l] + nu_z_l[l]*uz[l]);
+            aphi[l] = -2*uphi[l]*((1/rho[l] - nu_rho_l[l])*urho[l] - nu_z_l[l]*uz[l]);
+            arho[l] = -(exp_4nu_2lambda_inv*nu_rho_l[l]*ut[l]*ut[l] + rho[l]*(rho[l]*nu_rho_l[l] - 1)*exp_2lambda_inv*uphi[l]*uphi[l] + a*urho2_uz2 + 2*b*urho_uz);
+            az[l] = -(exp_4nu_2lambda_inv*nu_z_l[l]*ut[l]*ut[l] + rho[l]*rho[l]*exp_2lambda_inv*nu_z_l[l]*uphi[l]*uphi[l] - b*urho2_uz2 + 2*a*urho_uz);
+        }
+
+        // ========== Derivation of lambda ==========
+        if (this->lambda_eval_run == gr2::diff)
+        {
+            real *dlambda = dydt + lambda_index*lanes;
+            for (int l = 0; l < lanes; l++)
+                dlambda[l] = rho[l]*((nu_rho_l[l]*nu_rho_l[l] - nu_z_l[l]*nu_z_l[l])*urho[l] + 2*nu_rho_l[l]*nu_z_l[l]*uz[l]);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,283 @@
+// ========== include - my library ==========
+#include "gravitacek2/integrator/batchintegrator.hpp"
+#include "gravitacek2/integrator/steppers.hpp"
+#include "gravitacek2/integrator/stepcontrollers.hpp"
+
+// ========== include - standard libraries ==========
+#include <stdexcept>
+#include <cmath>
+
+// ========== macros ==========
+#define MAX_ITERATIONS_HADJUST 50
+
+namespace gr2
+{
+    // ========== BatchOdeSystem ==========
+
+    BatchOdeSystem::BatchOdeSystem(std::shared_ptr<OdeSystem> ode, const int &lanes) : OdeSystem(ode->get_n()*lanes), ode(ode), lanes(lanes)
+    {
+        this->m = ode->get_n();
+        this->t_lane = new real[lanes]{};
+        this->h_lane = new real[lanes]{};
+        this->t_eval = new real[lanes];
+        this->active = new int[lanes];
+        this->y_active = new real[m*lanes];
+        this->dydt_active = new real[m*lanes];
+    }
+
+    BatchOdeSystem::~BatchOdeSystem()
+    {
+        delete[] t_lane;
+        delete[] h_lane;
+        delete[] t_eval;
+        delete[] active;
+        delete[] y_active;
+        delete[] dydt_active;
+    }
+
+    void BatchOdeSystem::set_lane(const int &lane, const real &t, const real &h)
+    {
+        this->t_lane[lane] = t;
+        this->h_lane[lane] = h;
+    }
+
+    int BatchOdeSystem::get_lanes() const
+    {
+        return lanes;
+    }
+
+    void BatchOdeSystem::function(const real &tau, const real y[], real dydt[])
+    {
+        // find active lanes
+        int k = 0;
+        for (int l = 0; l < lanes; l++)
+            if (h_lane[l] != 0)
+            {
+                active[k] = l;
+                t_eval[k] = t_lane[l] + h_lane[l]*tau;
+                k++;
+            }
+
+        // all lanes are active, no compaction is needed
+        if (k == lanes)
+        {
+            ode->function_batch(lanes, t_eval, y, dydt);
+            for (int i = 0; i < m; i++)
+                for (int l = 0; l < lanes; l++)
+                    dydt[i*lanes + l] *= h_lane[l];
+            return;
+        }
+
+        // evaluate only active lanes (inactive lanes do not change)
+        for (int i = 0; i < m; i++)
+            for (int a = 0; a < k; a++)
+                y_active[i*k + a] = y[i*lanes + active[a]];
+        if (k > 0)
+            ode->function_batch(k, t_eval, y_active, dydt_active);
+        for (int i = 0; i < m; i++)
+        {
+            for (int l = 0; l < lanes; l++)
+                dydt[i*lanes + l] = 0;
+            for (int a = 0; a < k; a++)
+                dydt[i*lanes + active[a]] = h_lane[active[a]]*dydt_active[i*k + a];
+        }
+    }
+
+    // ========== BatchIntegrator ==========
+
+    void BatchIntegrator::gather(const int &lane, const real from[], real to[], const real &factor) const
+    {
+        for (int i = 0; i < n; i++)
+            to[i] = factor*from[i*lanes + lane];
+    }
+
+    void BatchIntegrator::scatter(const int &lane, const real from[], real to[]) const
+    {
+        for (int i = 0; i < n; i++)
+            to[i*lanes + lane] = from[i];
+    }
+
+    BatchIntegrator::BatchIntegrator(std::shared_ptr<OdeSystem> ode, const int &lanes, const std::string& stepper_name, const real &atol, const real &rtol)
+    {
+        if (lanes <= 0)
+            throw std::invalid_argument("number of lanes has to be positive");
+
+        this->ode = ode;
+        this->lanes = lanes;
+        this->n = ode->get_n();
+        this->batch = std::make_shared<BatchOdeSystem>(ode, lanes);
+
+        // stepper
+        if (stepper_name == "RK4")
+            this->stepper = new RK4();
+        else if (stepper_name == "DoPr853")
+            this->stepper = new DoPr853();
+        else
+            throw std::invalid_argument("no integrator with given name found");
+        this->stepper->set_OdeSystem(batch);
+        this->stepcontroller = new StepControllerNR(n, this->stepper->get_err_order(), atol, rtol, 0.8, 0.2, 10.0);
+
+        // events
+        this->events = std::vector<std::vector<std::shared_ptr<Event>>>(lanes);
+
+        // state of lanes
+        this->t = new real[lanes];
+        this->h = new real[lanes];
+        this->h_step = new real[lanes];
+        this->rejections = new int[lanes];
+        this->state = new LaneState[lanes];
+
+        // values in structure-of-arrays layout
+        this->yt = new real[n*lanes];
+        this->yt2 = new real[n*lanes];
+        this->f = new real[n*lanes];
+        this->dydt_in = new real[n*lanes];
+        this->dydt_out = new real[n*lanes];
+        this->err = new real[n*lanes];
+
+        // values of one lane
+        this->y_lane = new real[n];
+        this->f_lane = new real[n];
+        this->err_lane = new real[n];
+    }
+
+    BatchIntegrator::~BatchIntegrator()
+    {
+        delete stepper;
+        delete stepcontroller;
+        delete[] t;
+        delete[] h;
+        delete[] h_step;
+        delete[] rejections;
+        delete[] state;
+        delete[] yt;
+        delete[] yt2;
+        delete[] f;
+        delete[] dydt_in;
+        delete[] dydt_out;
+        delete[] err;
+        delete[] y_lane;
+        delete[] f_lane;
+        delete[] err_lane;
+    }
+
+    void BatchIntegrator::add_event(const int &lane, std::shared_ptr<Event> event)
+    {
+        if (lane < 0 || lane >= lanes)
+            throw std::invalid_argument("invalid index of lane");
+        if (event->get_type() != EventType::data)
+            throw std::invalid_argument("only data events are supported by BatchIntegrator");
+        this->events[lane].push_back(event);
+    }
+
+    void BatchIntegrator::integrate(real y[], const real &t_start, const real &t_end, const real &h_start)
+    {
+        // copy values into structure-of-arrays layout
+        for (int l = 0; l < lanes; l++)
+        {
+            for (int i = 0; i < n; i++)
+                yt[i*lanes + l] = y[l*n + i];
+            t[l] = t_start;
+            h[l] = h_start;
+            rejections[l] = 0;
+            state[l] = LaneState::running;
+        }
+
+        // initial derivatives
+        ode->function_batch(lanes, t, yt, f);
+        int running = lanes;
+
+        // cycle for calculating new values of y
+        while (running > 0)
+        {
+            // prepare step of all lanes (inactive lanes have zero step)
+            for (int l = 0; l < lanes; l++)
+            {
+                h_step[l] = state[l] == LaneState::running ? h[l] : 0;
+                batch->set_lane(l, t[l], h_step[l]);
+            }
+            for (int i = 0; i < n; i++)
+                for (int l = 0; l < lanes; l++)
+                {
+                    yt2[i*lanes + l] = yt[i*lanes + l];
+                    dydt_in[i*lanes + l] = h_step[l]*f[i*lanes + l];
+                }
+
+            // take a step
+            this->stepper->step_err(0, yt2, 1, err, false, dydt_in, dydt_out);
+
+            // accept or reject step in each lane
+            for (int l = 0; l < lanes; l++)
+            {
+                if (state[l] != LaneState::running)
+                    continue;
+
+                gather(l, yt2, y_lane);
+                gather(l, err, err_lane);
+                gather(l, dydt_out, f_lane, 1/h_step[l]);
+
+                // adjust step size
+                real h_new = h_step[l];
+                if (!this->stepcontroller->hadjust(y_lane, err_lane, f_lane, h_new))
+                {
+                    h[l] = h_new;
+                    rejections[l]++;
+                    if (rejections[l] >= MAX_ITERATIONS_HADJUST)
+                    {
+                        state[l] = LaneState::failed;
+                        running--;
+                    }
+                    continue;
+                }
+                rejections[l] = 0;
+
+                // "commit" to the step
+                t[l] += h_step[l];
+                h[l] = h_new;
+
+                // data events
+                bool terminal = false;
+                for (auto &event : events[l])
+                    if (event->value(t[l], h[l], y_lane, f_lane) == 0)
+                    {
+                        event->apply(nullptr, t[l], h[l], y_lane, f_lane);
+                        terminal = terminal || event->get_terminal();
+                    }
+                scatter(l, y_lane, yt);
+                scatter(l, f_lane, f);
+
+                // finish lane
+                if (terminal)
+                {
+                    state[l] = LaneState::terminated;
+                    running--;
+                }
+                else if (t[l] >= t_end)
+                {
+                    state[l] = LaneState::finished;
+                    running--;
+                }
+            }
+        }
+
+        // copy final values
+        for (int l = 0; l < lanes; l++)
+            for (int i = 0; i < n; i++)
+                y[l*n + i] = yt[i*lanes + l];
+    }
+
+    int BatchIntegrator::get_lanes() const
+    {
+        return lanes;
+    }
+
+    real BatchIntegrator::get_t(const int &lane) const
+    {
+        return t[lane];
+    }
+
+    LaneState BatchIntegrator::get_state(const int &lane) const
+    {
+        return state[lane];
+    }
+}
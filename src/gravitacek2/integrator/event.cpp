@@ -2,7 +2,7 @@
 
 namespace gr2
 {
-    Event::Event(const EventType &type, const bool &terminal):type(type), terminal(terminal)
+    Event::Event(const EventType &type, const bool &terminal, const bool &dense):type(type), terminal(terminal), dense(dense)
     {
     }
 
@@ -15,4 +15,14 @@ namespace gr2
     {
         return this->terminal;
     }
-}
\ No newline at end of file
+
+    bool Event::get_dense() const
+    {
+        return this->dense;
+    }
+
+    bool Event::get_section(const real y[], int &index, real &value)
+    {
+        return false;
+    }
+}
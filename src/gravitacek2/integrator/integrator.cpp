@@ -6,6 +6,8 @@
 // ========== include - standard libraries ========== 
 #include <stdexcept>
 #include <cmath>
+#include <chrono>
+#include <sstream>
 // #include <iostream>
 // #include <iomanip>
 
@@ -14,9 +16,39 @@
 #define MAX_ITERATIONS_SOLVE_EVENT 30
 #define EVENT_PRECISION 1e-8
 #define TIME_PRECISION 1e-12
+#define SECTION_RATE_MIN 1e-3
+#define MAX_SECTION_PIECES 8
 
 namespace gr2
 {
+    void IntegratorStatistics::reset()
+    {
+        rhs_evaluations = 0;
+        accepted_steps = 0;
+        rejected_steps = 0;
+        hadjust_iterations = 0;
+        event_iterations = 0;
+        event_steps = 0;
+        events = 0;
+        promotions = 0;
+        h_min = 0;
+        h_max = 0;
+        time_events = 0;
+        time_total = 0;
+    }
+
+    std::string IntegratorStatistics::to_string() const
+    {
+        std::ostringstream text;
+        text << "rhs = " << rhs_evaluations << ", accepted = " << accepted_steps << ", rejected = " << rejected_steps;
+        text << ", hadjust = " << hadjust_iterations << ", event iterations = " << event_iterations << ", event steps = " << event_steps << ", events = " << events;
+        text << ", promotions = " << promotions;
+        text << std::scientific;
+        text << ", h_min = " << (double)h_min << ", h_max = " << (double)h_max;
+        text << ", time of events = " << time_events << " s, total time = " << time_total << " s";
+        return text.str();
+    }
+
     void Integrator::basic_setup()
     {
         this->ode = nullptr;
@@ -37,6 +69,22 @@ namespace gr2
         this->err2 = nullptr;
         this->err3 = nullptr;
 
+        this->stepcontroller_fine = nullptr;
+        this->quantity = nullptr;
+        this->quantity_limit = 0;
+        this->quantity_reference = std::numeric_limits<real>::quiet_NaN();
+        this->demotion_steps = 0;
+        this->promotion_time = std::numeric_limits<real>::quiet_NaN();
+
+        this->statistics_enabled = false;
+        this->statistics.reset();
+        this->counting_ode = nullptr;
+
+        this->stepper_section = nullptr;
+        this->henon_ode = nullptr;
+        this->y_section = nullptr;
+        this->err_section = nullptr;
+
         this->events_data = std::vector<std::shared_ptr<Event>>();
         this->events_modifying = std::vector<std::shared_ptr<Event>>();
     }
@@ -50,9 +98,107 @@ namespace gr2
             this->stepper = new DoPr853();
         else
             throw std::invalid_argument("no integrator with given name found");
+        this->stepper_name = stepper_name;
     }
 
-    bool Integrator::solve_event(std::shared_ptr<Event> event, const real& previous_value_of_event)
+    bool Integrator::solve_section(const int &index, const real &value, StepControllerBase *controller)
+    {
+        int n = this->ode->get_n();
+        std::shared_ptr<OdeSystem> rhs = counting_ode ? counting_ode : this->ode;
+
+        // prepare stepper for system with coordinate as independent variable
+        if (!stepper_section)
+        {
+            if (stepper_name == "RK4")
+                this->stepper_section = new RK4();
+            else
+                this->stepper_section = new DoPr853();
+            this->y_section = new real[n+1];
+            this->err_section = new real[n+1];
+        }
+        if (!henon_ode || henon_ode->get_ode() != rhs)
+        {
+            this->henon_ode = std::make_shared<HenonOdeSystem>(rhs, index);
+            this->stepper_section->set_OdeSystem(henon_ode);
+        }
+        this->henon_ode->set_index(index);
+
+        // coordinate has to be monotonous within the last step (grazing
+        // crossing makes the system with coordinate as independent variable
+        // singular)
+        real rate = std::min(std::abs(dydt[index]), std::abs(dydt2[index]));
+        if (!(dydt[index]*dydt2[index] > 0) || rate*h2 < SECTION_RATE_MIN*std::abs(yt2[index] - yt[index]))
+            return false;
+
+        // steps from yt to hyperplane (interval of coordinate is divided
+        // into more steps, if the error is not accepted by step controller)
+        for (int pieces = 1; pieces <= MAX_SECTION_PIECES; pieces *= 2)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                y_section[i] = yt[i];
+                err3[i] = 0;
+            }
+            y_section[n] = t;
+            real err_t = 0;
+            real ds = (value - yt[index])/pieces;
+            try
+            {
+                for (int k = 0; k < pieces; k++)
+                {
+                    real s = yt[index] + k*ds;
+                    this->stepper_section->step_err(s, y_section, k == pieces - 1 ? value - s : ds, err_section);
+                    if (statistics_enabled)
+                        statistics.event_steps++;
+                    for (int i = 0; i < n; i++)
+                        err3[i] += std::abs(err_section[i]);
+                    err_t += std::abs(err_section[n]);
+                }
+            }
+            catch(const std::domain_error& e)
+            {
+                return false;
+            }
+
+            // hyperplane has to be reached within the last step
+            h3 = y_section[n] - t;
+            if (!(h3 > 0 && h3 <= h2))
+                return false;
+
+            for (int i = 0; i < n; i++)
+                yt3[i] = y_section[i];
+            yt3[index] = value;
+            t3 = t + h3;
+            rhs->function(t3, yt3, dydt3);
+
+            // error of time is transferred to coordinates, landing has to be
+            // as precise as the integration around it
+            bool finite = true;
+            for (int i = 0; i < n; i++)
+            {
+                err3[i] += std::abs(dydt3[i]*err_t);
+                finite = finite && std::isfinite(yt3[i]) && std::isfinite(err3[i]);
+            }
+            if (!finite)
+                return false;
+            real h_test = h3;
+            if (!controller || controller->hadjust(yt3, err3, dydt3, h_test))
+            {
+                // main stepper still holds the trial step, its dense output
+                // has to be prepared for the landed step
+                if (dense)
+                {
+                    for (int i = 0; i < n; i++)
+                        y_section[i] = yt[i];
+                    this->stepper->step_err(t, y_section, h3, err_section, true, dydt);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Integrator::solve_event(std::shared_ptr<Event> event, const real& previous_value_of_event, StepControllerBase *controller)
     {
         // std::cout << "Solve event" << std::endl;
         // prepare values
@@ -73,29 +219,83 @@ namespace gr2
         //     return false;
         // }
 
-        // prepare values for secant method
-        real a = previous_value_of_event, b = current_value_of_event;
-        real h_a = 0, h_b = h2;
+        // ========== Hyperplane (Hénon's trick) ==========
+        int section_index;
+        real section_value;
+        if (event->get_section(yt, section_index, section_value) && this->solve_section(section_index, section_value, controller))
+            return true;
 
-        // std::cout << "==========" << std::endl;
-        // std::cout << current_value_of_event << std::endl;
-        // std::cout << h2 << std::endl;
+        int n = this->ode->get_n();
+        real value_end = current_value_of_event;
+        OdeSystem *rhs = counting_ode ? counting_ode.get() : this->ode.get();
+
+        // ========== Root on dense output (Illinois method) ==========
+        // values of event are calculated from interpolated values of y,
+        // this costs one evaluation of ODEs instead of one step
+        real a = previous_value_of_event, b = value_end;
+        real h_a = 0, h_b = h2;
+        int side = 0;
+        for (i = 0; i < MAX_ITERATIONS_SOLVE_EVENT; i++)
+        {
+            if (statistics_enabled)
+                statistics.event_iterations++;
+            h3 = (h_a*b - h_b*a)/(b - a);
+            this->stepper->dense_out_all(t + h3, yt3);
+            rhs->function(t + h3, yt3, dydt3);
+            current_value_of_event = event->value(t + h3, h3, yt3, dydt3);
+
+            // reduce interval for h (value on retained side is halved, if
+            // the same side is retained twice)
+            if (current_value_of_event*a > 0)
+            {
+                h_a = h3;
+                a = current_value_of_event;
+                if (side == -1)
+                    b /= 2;
+                side = -1;
+            }
+            else if (current_value_of_event*b > 0)
+            {
+                h_b = h3;
+                b = current_value_of_event;
+                if (side == 1)
+                    a /= 2;
+                side = 1;
+            }
+            else
+                break;
+            if ((h_b - h_a) < TIME_PRECISION*std::max(h_a, h_b) || std::abs(current_value_of_event) < EVENT_PRECISION)
+                break;
+        }
 
         // ========== Secant method ==========
-        // std::cout << "Let us iterate" << std::endl;
-        // std::cout << previous_value_of_event << " " << current_value_of_event << " " << h2 << " " << h2*yt[7] << std::endl;
+        // the first step lands on root of dense output, further steps are
+        // taken only if the event is not precise enough after it
+        a = previous_value_of_event;
+        b = value_end;
+        h_a = 0;
+        h_b = h2;
         for (i = 0; i < MAX_ITERATIONS_SOLVE_EVENT; i++)
         {
-            gr2::real avg = 0.5*(h_a+h_b);
-            h3 = avg + 0.8*((h_a*b-h_b*a)/(b-a)-avg); // new value of step size
+            if (statistics_enabled)
+            {
+                if (i > 0)
+                    statistics.event_iterations++;
+                statistics.event_steps++;
+            }
+            if (i > 0)
+            {
+                gr2::real avg = 0.5*(h_a+h_b);
+                h3 = avg + 0.8*((h_a*b-h_b*a)/(b-a)-avg); // new value of step size
+            }
 
             // copy starting value of yt to yt3
-            for (int j = 0; j < this->ode->get_n(); j++)
+            for (int j = 0; j < n; j++)
                 yt3[j] = yt[j];
 
             // take step and calculate new value of event
             // std::cout << "h3 = " << h3 << std::endl;
-            this->stepper->step_err(t, yt3, h3, err3, dense, dydt, dydt3);
+            this->stepper->step_err(t, yt3, h3, err3, true, dydt, dydt3);
             // for (int ii = 0; ii < 8; ii++)
             //     std::cout << this->yt3[ii] << " ";
             // std::cout << std::endl;
@@ -204,6 +404,8 @@ namespace gr2
 
     void Integrator::add_event(std::shared_ptr<Event> event)
     {
+        if (event->get_dense())
+            this->dense = true;
         switch (event->get_type())
         {
         case EventType::data:
@@ -218,10 +420,52 @@ namespace gr2
         }
     }
 
+    void Integrator::set_tolerance_promotion(std::function<real(const real y[])> quantity, const real &limit, const real &atol_fine, const real &rtol_fine, const real &reference, const int &demotion_steps)
+    {
+        if (!this->stepcontroller)
+            throw std::invalid_argument("promotion of tolerance requires step controller");
+
+        delete this->stepcontroller_fine;
+        this->stepcontroller_fine = new StepControllerNR(ode->get_n(), this->stepper->get_err_order(), atol_fine, rtol_fine, 0.8, 0.2, 10.0);
+        this->quantity = quantity;
+        this->quantity_limit = limit;
+        this->quantity_reference = reference;
+        this->demotion_steps = demotion_steps;
+    }
+
+    real Integrator::get_promotion_time() const
+    {
+        return promotion_time;
+    }
+
+    void Integrator::enable_statistics(const bool &enable)
+    {
+        this->statistics_enabled = enable;
+        if (enable && !counting_ode)
+        {
+            this->counting_ode = std::make_shared<CountingOdeSystem>(ode);
+            this->stepper->set_OdeSystem(counting_ode);
+        }
+        else if (!enable && counting_ode)
+        {
+            this->counting_ode = nullptr;
+            this->stepper->set_OdeSystem(ode);
+        }
+    }
+
+    const IntegratorStatistics& Integrator::get_statistics() const
+    {
+        return statistics;
+    }
+
     Integrator::~Integrator()
     {
         delete stepper;
         delete stepcontroller;
+        delete stepcontroller_fine;
+        delete stepper_section;
+        delete[] y_section;
+        delete[] err_section;
         delete[] yt;
         delete[] yt2;
         delete[] yt3;
@@ -234,6 +478,35 @@ namespace gr2
     }
 
     void Integrator::integrate(const real y_start[], const real &t_start, const real &t_end, const real &h_start)
+    {
+        if (!statistics_enabled)
+        {
+            this->integrate_steps(y_start, t_start, t_end, h_start);
+            return;
+        }
+
+        // integration with statistics (also if it is stopped by exception)
+        statistics.reset();
+        counting_ode->reset_evaluations();
+        auto start = std::chrono::steady_clock::now();
+        auto finish = [&]()
+        {
+            statistics.rhs_evaluations = counting_ode->get_evaluations();
+            statistics.time_total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        try
+        {
+            this->integrate_steps(y_start, t_start, t_end, h_start);
+        }
+        catch(...)
+        {
+            finish();
+            throw;
+        }
+        finish();
+    }
+
+    void Integrator::integrate_steps(const real y_start[], const real &t_start, const real &t_end, const real &h_start)
     {
         // prepare variables
         int i;
@@ -246,7 +519,10 @@ namespace gr2
         this->t = t_start;
         this->h = this->h2 = this->h3 = h_start;
         t2 = t3 = t;
-        this->ode->function(t, yt, dydt);
+        if (counting_ode)
+            this->counting_ode->function(t, yt, dydt);
+        else
+            this->ode->function(t, yt, dydt);
 
         // number of events
         number_of_events_modifying = events_modifying.size();
@@ -258,11 +534,19 @@ namespace gr2
         for (int i = 0; i < number_of_events_modifying; i++)
             events_modifying_values[i] = events_modifying[i]->value(t_start, h, yt, dydt);
 
+        // prepare promotion of tolerance
+        StepControllerBase *controller = this->stepcontroller;
+        real quantity_0 = 0;
+        int fine_steps = 0, drift_rejections = 0;
+        promotion_time = std::numeric_limits<real>::quiet_NaN();
+        if (stepcontroller_fine)
+            quantity_0 = std::isnan(quantity_reference) ? quantity(yt) : quantity_reference;
+
         // cycle for calculating new values of y
         while (t < t_end)
         {   
-            // taky a step
-            this->stepper->step_err(t, yt2, h, err2, dense, dydt, dydt2);
+            // taky a step (modifying events are solved on dense output)
+            this->stepper->step_err(t, yt2, h, err2, dense || number_of_events_modifying > 0, dydt, dydt2);
             t2 = t + h;
 
             // null current event
@@ -271,9 +555,12 @@ namespace gr2
 
             // check modifying events
             int current_event_index = 0;
+            std::chrono::steady_clock::time_point event_start;
+            if (statistics_enabled)
+                event_start = std::chrono::steady_clock::now();
             for (int i = 0; i < number_of_events_modifying; i++)
             {
-                if(this->solve_event(events_modifying[i], events_modifying_values[i]))
+                if(this->solve_event(events_modifying[i], events_modifying_values[i], controller))
                 {
                     for (int i = 0; i < n; i++)
                     {
@@ -289,9 +576,11 @@ namespace gr2
                     // std::cout << "Event activated" << std::endl;
                 }
             }
+            if (statistics_enabled)
+                statistics.time_events += std::chrono::duration<double>(std::chrono::steady_clock::now() - event_start).count();
 
             i = 0;
-            if (this->stepcontroller)
+            if (controller)
             {
                 // std::cout << std::scientific;
                 // std::cout << "Lets do it" << std::endl;
@@ -301,8 +590,12 @@ namespace gr2
                 // std::cout << "h2 = " << h2 << std::endl;
                 for (i = 0; i < MAX_ITERATIONS_HADJUST; i++)
                 {
-                    if(this->stepcontroller->hadjust(this->yt2, this->err2, this->dydt2, this->h2))
+                    if (statistics_enabled)
+                        statistics.hadjust_iterations++;
+                    if(controller->hadjust(this->yt2, this->err2, this->dydt2, this->h2))
                         break;
+                    if (statistics_enabled)
+                        statistics.rejected_steps++;
                     for (int j = 0; j < n; j++)
                         yt2[j] = yt[j];
                     this->stepper->step_err(t, yt2, h2, err2, dense, dydt, dydt2);
@@ -339,12 +632,57 @@ namespace gr2
                 throw std::runtime_error("optimal step size was not found, MAX_ITERATIONS_HADJUST reached");
             }
 
+            // drift of conserved quantity (return to checkpoint and repeat
+            // step with tighter tolerance or shorter step)
+            if (stepcontroller_fine && std::abs(quantity(yt2) - quantity_0) > quantity_limit)
+            {
+                if (controller == stepcontroller)
+                {
+                    controller = stepcontroller_fine;
+                    fine_steps = 0;
+                    if (std::isnan(promotion_time))
+                        promotion_time = t;
+                    if (statistics_enabled)
+                        statistics.promotions++;
+                }
+                else
+                {
+                    drift_rejections++;
+                    if (drift_rejections >= MAX_ITERATIONS_HADJUST)
+                        throw std::runtime_error("drift of conserved quantity was not kept under limit, MAX_ITERATIONS_HADJUST reached");
+                    h = (t2 - t)/2;
+                }
+                if (statistics_enabled)
+                    statistics.rejected_steps++;
+                for (int i = 0; i < n; i++)
+                {
+                    yt2[i] = yt[i];
+                    dydt2[i] = dydt[i];
+                }
+                h2 = h3 = h;
+                continue;
+            }
+            drift_rejections = 0;
+
+            // return to basic tolerance
+            if (controller == stepcontroller_fine && demotion_steps > 0 && ++fine_steps >= demotion_steps)
+                controller = stepcontroller;
+
             // "commit" to the step
             for (int i = 0; i < n; i++)
             {
                 yt[i] = yt2[i];
                 dydt[i] = dydt2[i];
             }
+            if (statistics_enabled)
+            {
+                real h_step = t2 - t;
+                if (statistics.accepted_steps == 0 || h_step < statistics.h_min)
+                    statistics.h_min = h_step;
+                if (statistics.accepted_steps == 0 || h_step > statistics.h_max)
+                    statistics.h_max = h_step;
+                statistics.accepted_steps++;
+            }
             t = t2;
 
             if (this->stepcontroller)
@@ -353,12 +691,21 @@ namespace gr2
             h3 = h;
             // t2 = t3 = t + h;
 
-            if (dense)
-                this->stepper->prepare_dense();
+            // dense output is prepared by stepper on the first request
 
             // apply event
             if (current_event)
-                current_event->apply(stepper, t, h, yt, dydt);
+            {
+                if (statistics_enabled)
+                {
+                    auto event_start = std::chrono::steady_clock::now();
+                    current_event->apply(stepper, t, h, yt, dydt);
+                    statistics.time_events += std::chrono::duration<double>(std::chrono::steady_clock::now() - event_start).count();
+                    statistics.events++;
+                }
+                else
+                    current_event->apply(stepper, t, h, yt, dydt);
+            }
             
             // data events
             // std::cout << "h before = " << h << std::endl;
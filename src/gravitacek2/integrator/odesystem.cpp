@@ -1,5 +1,8 @@
 #include "gravitacek2/integrator/odesystem.hpp"
 
+#include <stdexcept>
+#include <cmath>
+
 namespace gr2
 {
     OdeSystem::OdeSystem(const int &n)
@@ -17,6 +20,20 @@ namespace gr2
         return this->n;
     }
 
+    void OdeSystem::function_batch(const int &lanes, const real t[], const real y[], real dydt[])
+    {
+        batch_y.resize(n);
+        batch_dydt.resize(n);
+        for (int l = 0; l < lanes; l++)
+        {
+            for (int i = 0; i < n; i++)
+                batch_y[i] = y[i*lanes + l];
+            this->function(t[l], batch_y.data(), batch_dydt.data());
+            for (int i = 0; i < n; i++)
+                dydt[i*lanes + l] = batch_dydt[i];
+        }
+    }
+
     CombinedOdeSystem::CombinedOdeSystem(std::vector<std::shared_ptr<OdeSystem>> odes):OdeSystem(0), odes(odes)
     {
         for (auto &ode:odes)
@@ -32,4 +49,52 @@ namespace gr2
             i+=ode->get_n();
         }
     }
-}
\ No newline at end of file
+
+    CountingOdeSystem::CountingOdeSystem(std::shared_ptr<OdeSystem> ode):OdeSystem(ode->get_n()), ode(ode), evaluations(0)
+    {
+
+    }
+
+    long CountingOdeSystem::get_evaluations() const
+    {
+        return this->evaluations;
+    }
+
+    void CountingOdeSystem::reset_evaluations()
+    {
+        this->evaluations = 0;
+    }
+
+    void CountingOdeSystem::function(const real &t, const real y[], real dydt[])
+    {
+        this->evaluations++;
+        this->ode->function(t, y, dydt);
+    }
+
+    HenonOdeSystem::HenonOdeSystem(std::shared_ptr<OdeSystem> ode, const int &index):OdeSystem(ode->get_n() + 1), ode(ode), index(index)
+    {
+
+    }
+
+    std::shared_ptr<OdeSystem> HenonOdeSystem::get_ode() const
+    {
+        return this->ode;
+    }
+
+    void HenonOdeSystem::set_index(const int &index)
+    {
+        this->index = index;
+    }
+
+    void HenonOdeSystem::function(const real &s, const real y[], real dydt[])
+    {
+        int m = n - 1;
+        this->ode->function(y[m], y, dydt);
+        if (dydt[index] == 0 || !std::isfinite(dydt[index]))
+            throw std::domain_error("coordinate used as independent variable is not monotonous");
+        real inv = 1/dydt[index];
+        for (int i = 0; i < m; i++)
+            dydt[i] *= inv;
+        dydt[m] = inv;
+    }
+}
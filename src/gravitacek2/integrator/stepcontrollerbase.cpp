@@ -6,4 +6,9 @@ namespace gr2
     {
         this -> n = n;
     }
+
+    StepControllerBase::~StepControllerBase()
+    {
+
+    }
 }
\ No newline at end of file
@@ -28,13 +28,13 @@ namespace gr2
         real h_new; 
         for (int i = 0; i < n; i++)
         {
-            ratios[i] = err[i]/(eps_abs + eps_rel*(a_y*abs(y[i]) + a_dydt*abs(dydt[i])));
+            ratios[i] = err[i]/(eps_abs + eps_rel*(a_y*std::abs(y[i]) + a_dydt*std::abs(dydt[i])));
             max_ratio = std::max(max_ratio, ratios[i]);
         }
 
         if (max_ratio > 1.1)
         {
-            h_new = h*S*powl(max_ratio, -1.0/k);
+            h_new = h*S*std::pow(max_ratio, -1.0/k);
             if (h_new*factor < h)
                 h_new = h/factor;
             h = h_new;
@@ -42,7 +42,7 @@ namespace gr2
         }
         else if(max_ratio < 0.5)
         {
-            h_new = h*S*powl(max_ratio, -1.0/(k+1));
+            h_new = h*S*std::pow(max_ratio, -1.0/(k+1));
             if (h_new > h*factor)
                 h_new = h*factor;
             h = h_new;
@@ -21,18 +21,18 @@ namespace gr2
         this->err = 0;
         for (int i = 0; i < n; i++)
         {
-            scale = atol + rtol*fabs(y[i]);
+            scale = atol + rtol*std::abs(y[i]);
             // std::cout << "y[i] = " << y[i] << " scale = " << scale << " err[i] = " << err[i] << std::endl;
             real x = (err[i]/scale);
             this->err += x*x;
         }
         // std::cout << "err_ = " << this->err << std::endl;
-        this->err = sqrtl(this->err/n);
+        this->err = std::sqrt(this->err/n);
         // std::cout << "err__ = " << this->err << std::endl;
         // std::cout << "h_old = " << h << std::endl;
 
         // ========== Calculate step size ==========  
-        real h_new = h*S*powl(1.0/this->err, 1.0/this->k);
+        real h_new = h*S*std::pow(1.0/this->err, 1.0/this->k);
         if (h_new > factor_grow*h)
             h_new = factor_grow*h;
         else if (h_new < factor_decrease*h)
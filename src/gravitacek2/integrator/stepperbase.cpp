@@ -2,7 +2,7 @@
 
 namespace gr2
 {
-    StepperBase::StepperBase():t_in(0), h(0), n(0), ode(nullptr), y_in(nullptr), y_out(nullptr), y_err(nullptr), y_help(nullptr), y_cur(nullptr), dydt_in(nullptr), dydt_out(nullptr), dydt_cur(nullptr), dydt_opt(nullptr)
+    StepperBase::StepperBase():ode(nullptr), y_in(nullptr), y_out(nullptr), y_err(nullptr), y_cur(nullptr), y_help(nullptr), dydt_in(nullptr), dydt_out(nullptr), dydt_cur(nullptr), dydt_opt(nullptr), t_in(0), h(0), n(0), dense_pending(false)
     {}
 
     StepperBase::~StepperBase()
@@ -53,6 +53,11 @@ namespace gr2
         }
     }
 
+    std::shared_ptr<OdeSystem> StepperBase::get_OdeSystem() const
+    {
+        return ode;
+    }
+
     void StepperBase::step_err(const real &t, real y[], const real &h, real err[], const bool &dense, const real dydt_in[], real dydt_out[])
     {
         // save time and step internaly
@@ -114,4 +119,18 @@ namespace gr2
         real s1 = 1.0-s;
         return s1*y_in[i] + s*y_out[i] - s*s1*((1-2*s)*(y_out[i] - y_in[i]) - s1*h*dydt_in[i] + s*h*dydt_out[i]);
     }
+
+    void StepperBase::dense_out_all(const real &t, real y[])
+    {
+        real s = (t-t_in)/h;
+        real s1 = 1.0-s;
+        for (int i = 0; i < n; i++)
+            y[i] = s1*y_in[i] + s*y_out[i] - s*s1*((1-2*s)*(y_out[i] - y_in[i]) - s1*h*dydt_in[i] + s*h*dydt_out[i]);
+    }
+
+    void StepperBase::dense_out_many(const int &m, const real ts[], real *Y[])
+    {
+        for (int k = 0; k < m; k++)
+            this->dense_out_all(ts[k], Y[k]);
+    }
 }
\ No newline at end of file
@@ -264,7 +264,7 @@ namespace gr2
         // 12. corection
         for (i = 0; i < n; i++)
             y_cur[i] = y[i] + h * (a121 * k1[i] + a124 * k4[i] + a125 * k5[i] + a126 * k6[i] + a127 * k7[i] + a128 * k8[i] + a129 * k9[i] + a1210 * k10[i] + a1211 * k11[i]);
-        ode->function(t, y_cur, k12);
+        ode->function(t + h, y_cur, k12);
 
         // final value
         for (i = 0; i < n; i++)
@@ -285,6 +285,7 @@ namespace gr2
         {
             ode->function(t+h, y, this->dydt_out);
         }
+        this->dense_pending = dense;
     }
 
     void DoPr853::step_err(const real &t, real y[], const real &h, real err[], const bool& dense, const real dydt_in[], real dydt_out[])
@@ -465,7 +466,7 @@ namespace gr2
         // 12. corection
         for (i = 0; i < n; i++)
             y_cur[i] = y[i] + h * (a121 * k1[i] + a124 * k4[i] + a125 * k5[i] + a126 * k6[i] + a127 * k7[i] + a128 * k8[i] + a129 * k9[i] + a1210 * k10[i] + a1211 * k11[i]);
-        ode->function(t, y_cur, k12);
+        ode->function(t + h, y_cur, k12);
 
         // final value
         for (i = 0; i < n; i++)
@@ -482,9 +483,9 @@ namespace gr2
             err3 = (k_help[i] - bhh1 * k1[i] - bhh2 * k9[i] - bhh3 * k3[i]) * h;
             err5 = (er1 * k1[i] + er6 * k6[i] + er7 * k7[i] + er8 * k8[i] + er9 * k9[i] + er10 * k10[i] + er11 * k11[i] + er12 * k12[i]) * h;
             if (err5 != 0)
-                err[i] = err5*err5/sqrtl(0.01*err3*err3 + err5*err5);
+                err[i] = err5*err5/std::sqrt(0.01*err3*err3 + err5*err5);
             else
-                err[i] == 0;
+                err[i] = 0;
         }
 
         if (dydt_out)
@@ -498,6 +499,7 @@ namespace gr2
         {
             ode->function(t+h, y, this->dydt_out);
         }
+        this->dense_pending = dense;
     }
 
     int DoPr853::get_order() const
@@ -512,6 +514,11 @@ namespace gr2
 
     void DoPr853::prepare_dense()
     {
+        // dense output of this step is already prepared
+        if (!dense_pending)
+            return;
+        dense_pending = false;
+
         static const real c14 = 0.1e+00;
         static const real c15 = 0.2e+00;
         static const real c16 = 0.777777777777777777777777777778e+00;
@@ -636,9 +643,40 @@ namespace gr2
 
     real DoPr853::dense_out(const int &i, const real &t)
     {
+        if (dense_pending)
+            this->prepare_dense();
         real s = (t-t_in)/h;
         real s1 = 1.0-s;
         return pc1[i]+s*(pc2[i]+s1*(pc3[i]+s*(pc4[i]+s1*(pc5[i]+s*(pc6[i]+s1*(pc7[i]+s*pc8[i]))))));
     }
+
+    void DoPr853::dense_out_all(const real &t, real y[])
+    {
+        if (dense_pending)
+            this->prepare_dense();
+        real s = (t-t_in)/h;
+        real s1 = 1.0-s;
+        for (int i = 0; i < n; i++)
+            y[i] = pc1[i]+s*(pc2[i]+s1*(pc3[i]+s*(pc4[i]+s1*(pc5[i]+s*(pc6[i]+s1*(pc7[i]+s*pc8[i]))))));
+    }
+
+    void DoPr853::dense_out_many(const int &m, const real ts[], real *Y[])
+    {
+        if (dense_pending)
+            this->prepare_dense();
+
+        // coefficients of one coordinate are loaded once for all times
+        for (int i = 0; i < n; i++)
+        {
+            real c1 = pc1[i], c2 = pc2[i], c3 = pc3[i], c4 = pc4[i];
+            real c5 = pc5[i], c6 = pc6[i], c7 = pc7[i], c8 = pc8[i];
+            for (int k = 0; k < m; k++)
+            {
+                real s = (ts[k]-t_in)/h;
+                real s1 = 1.0-s;
+                Y[k][i] = c1+s*(c2+s1*(c3+s*(c4+s1*(c5+s*(c6+s1*(c7+s*c8))))));
+            }
+        }
+    }
 }
 
@@ -73,7 +73,7 @@ namespace gr2
         // fourth correction
         for (i = 0; i < n; i++)
             y_cur[i] = y_in[i] + h * k3[i];
-        ode->function(t + 0.5 * h, y_cur, k4);
+        ode->function(t + h, y_cur, k4);
 
         // final result
         for (i = 0; i < n; i++)
@@ -1,20 +1,22 @@
 #include "gravitacek2/mymath.hpp"
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 namespace gr2
 {
     void elliptic_KE(const real& k, real &K, real &E, const real &eps)
     { 
-        real x = sqrtl(1 - k * k), y = 1;
+        real x = std::sqrt(1 - k * k), y = 1;
         real x0 = x, y0 = y;
         real newx , newy; 
         real fac = 0.5, sum = 0; 
-        real eeps = 2.7 * sqrtl(eps); 
-        while (fabsl(x - y) > eeps * fabsl(x)) 
+        real eeps = 2.7 * std::sqrt(eps); 
+        while (std::abs(x - y) > eeps * std::abs(x)) 
         {  
             newx = 0.5 * (x + y); 
-            newy = sqrtl(x * y); 
+            newy = std::sqrt(x * y); 
             x = newx; 
             y = newy; 
             sum += fac * (x - y) * (x - y); 
@@ -63,6 +65,33 @@ namespace gr2
         }
     }
 
+    void legendre_polynomials2(const real& x, const int& n, real *p0, real *p1, real *p2)
+    {
+        // evaluate \f$P_0(x)\f$ and its derivatives
+        if (n > 0)
+        {
+            p0[0] = 1;
+            p1[0] = 0;
+            p2[0] = 0;
+        }
+        
+        // evaluate \f$P_1(x)\f$ and its derivatives
+        if (n > 1)
+        {
+            p0[1] = x;
+            p1[1] = 1;
+            p2[1] = 0;
+        }
+
+        // apply recurent formulas
+        for (int i = 1; i < n-1; i++)
+        {
+            p0[i+1] = ((2*i+1)*x*p0[i] - i*p0[i-1])/(i+1);
+            p1[i+1] = (i+1)*p0[i] + x*p1[i];
+            p2[i+1] = (i+2)*p1[i] + x*p2[i];
+        }
+    }
+
     void special_function_Q2n(const real& x, const int& n, real* q)
     {
         gr2::real q0, q1;
@@ -112,4 +141,352 @@ namespace gr2
         }
     }
 
-}
\ No newline at end of file
+    void special_function_Q2n2(const real& x, const int& n, real* q0, real* q1, real* q2)
+    {
+        gr2::real q0_val, q1_val;
+        gr2::real q0_der, q1_der;
+        gr2::real q0_der2, q1_der2;
+
+        if (n > 0)
+        {
+            q0_val = pi_2-std::atan(x);
+            q0_der = -1.0/(x*x+1);
+            q0_der2 = 2*x/((x*x+1)*(x*x+1));
+            q0[0] = q0_val;
+            q1[0] = q0_der;
+            q2[0] = q0_der2;
+        }
+
+        if (n > 1)
+        {
+            q1_val = x*q0_val-1;
+            q1_der = q0_val + x*q0_der;
+            q1_der2 = 2*q0_der + x*q0_der2;
+        }
+
+        for (int i = 1, j = 2; i<n; i++, j++)
+        {
+            q0_val = (-(2*j-1)*x*q1_val-(j-1)*q0_val)/((real) j);
+            q0[i] = q0_val;
+            q0_der = (-(2*j-1)*(x*q1_der + q1_val) - (j-1)*q0_der)/((real) j);
+            q1[i] = q0_der;
+            q0_der2 = (-(2*j-1)*(x*q1_der2 + 2*q1_der) - (j-1)*q0_der2)/((real) j);
+            q2[i] = q0_der2;
+            j++;
+            q1_val = ((2*j-1)*x*q0_val-(j-1)*q1_val)/j;
+            q1_der = ((2*j-1)*(x*q0_der + q0_val)-(j-1)*q1_der)/j;
+            q1_der2 = ((2*j-1)*(x*q0_der2 + 2*q0_der)-(j-1)*q1_der2)/j;
+        }
+    }
+
+    void rod_potential2(const real& rho, const real& z, const real& M, real* f)
+    {
+        // distances from the ends of the rod
+        real zm = z - M, zp = z + M;
+        real d1 = std::sqrt(rho*rho + zm*zm);
+        real d2 = std::sqrt(rho*rho + zp*zp);
+        real i1 = 1/d1, i2 = 1/d2;
+        real i13 = i1*i1*i1, i23 = i2*i2*i2;
+
+        // function s = d1 + d2 and its derivatives
+        real s = d1 + d2;
+        real s_rho = rho*(i1 + i2);
+        real s_z = zm*i1 + zp*i2;
+        real s_rhorho = zm*zm*i13 + zp*zp*i23;
+        real s_rhoz = -rho*(zm*i13 + zp*i23);
+        real s_zz = rho*rho*(i13 + i23);
+
+        // derivatives of potential with respect to s
+        real D = s*s - 4*M*M;
+        real g = 2*M/D;
+        real g_s = -2*s*g/D;
+
+        f[0] = 0.5*std::log((s - 2*M)/(s + 2*M));
+        f[1] = g*s_rho;
+        f[2] = g*s_z;
+        f[3] = g_s*s_rho*s_rho + g*s_rhorho;
+        f[4] = g_s*s_rho*s_z + g*s_rhoz;
+        f[5] = g_s*s_z*s_z + g*s_zz;
+    }
+
+    // complete elliptic integral K(k) and differences D = (K - E)/k^2,
+    // G = ((2 - k^2)K - 2E)/k^4 for m = k^2, differences are summed by AGM
+    // from positive terms, so they stay precise for small k
+    static void elliptic_KDG(const real &m, real &K, real &D, real &G)
+    {
+        const real EPS = std::numeric_limits<real>::epsilon();
+
+        // a, g are arithmetic and geometric means, c_n = m*e is half of
+        // their difference in previous iteration (c_1 = m/(2(1 + k')))
+        real a = 1, g = std::sqrt(1 - m);
+        real e = 1/(2*(1 + g));
+        real factor = 2, sum = 0;
+        for (int i = 0; i < 64; i++)
+        {
+            real a_new = 0.5*(a + g);
+            g = std::sqrt(a*g);
+            a = a_new;
+            sum += factor*e*e;
+
+            // c_{n+1} = c_n^2/(4 a_{n+1})
+            e = m*e*e/(2*(a + g));
+            factor *= 2;
+            if (m*e <= EPS*a && factor*e*e <= EPS*sum)
+                break;
+        }
+        K = pi/(a + g);
+        G = K*sum;
+        D = 0.5*K + 0.5*m*G;
+    }
+
+    void ring_potential1(const real& rho, const real& z, const real& b, real* f)
+    {
+        real K, D, G;
+        real l1_2 = (rho-b)*(rho-b) + z*z;
+        real l2_2 = (rho+b)*(rho+b) + z*z;
+        real l2 = std::sqrt(l2_2);
+        real m = 4*rho*b/l2_2;
+        elliptic_KDG(m, K, D, G);
+        real E = K - m*D;
+
+        f[0] = -2*K/(pi*l2);
+        f[1] = rho*(8*b*b*(G - D)/l2_2 + 2*E)/(pi*l1_2*l2);
+        f[2] = 2*E*z/(pi*l1_2*l2);
+    }
+
+    void ring_potential2(const real& rho, const real& z, const real& b, real* f)
+    {
+        real K, D, G;
+        real l1_2 = (rho-b)*(rho-b) + z*z;
+        real l2_2 = (rho+b)*(rho+b) + z*z;
+        real l2 = std::sqrt(l2_2);
+        real m = 4*rho*b/l2_2;
+        elliptic_KDG(m, K, D, G);
+        real E = K - m*D;
+
+        // potential and first derivatives (f_rho/rho is finite on the axis)
+        real f_rho_over_rho = (8*b*b*(G - D)/l2_2 + 2*E)/(pi*l1_2*l2);
+        f[0] = -2*K/(pi*l2);
+        f[1] = rho*f_rho_over_rho;
+        f[2] = 2*E*z/(pi*l1_2*l2);
+
+        // derivatives of E
+        real E_rho = -2*b*D*(1 - 2*rho*(rho + b)/l2_2)/l2_2;
+        real E_z = z*m*D/l2_2;
+
+        // second derivatives (f_rhorho from Laplace equation)
+        real A = 2/(pi*l1_2*l2);
+        f[5] = A*(E + z*E_z - z*z*E*(2/l1_2 + 1/l2_2));
+        f[4] = A*z*(E_rho - E*(2*(rho - b)/l1_2 + (rho + b)/l2_2));
+        f[3] = -f[5] - f_rho_over_rho;
+    }
+
+    // reflect rows r, r+1, ..., r+m-1 of H (columns c0..c1) and the same
+    // columns (rows r0..r1) by Householder reflection which maps vector v
+    // of length m onto the first axis
+    static void householder4(real H[4][4], const real *v, const int &m, const int &r, const int &c0, const int &c1, const int &r0, const int &r1)
+    {
+        real norm = 0;
+        for (int i = 0; i < m; i++)
+            norm += v[i]*v[i];
+        norm = std::sqrt(norm);
+        if (norm == 0)
+            return;
+
+        real u[3] = {0, 0, 0};
+        for (int i = 0; i < m; i++)
+            u[i] = v[i];
+        u[0] += std::copysign(norm, v[0]);
+        real uu = 0;
+        for (int i = 0; i < m; i++)
+            uu += u[i]*u[i];
+        real beta = 2/uu;
+
+        for (int j = c0; j <= c1; j++)
+        {
+            real s = 0;
+            for (int i = 0; i < m; i++)
+                s += u[i]*H[r+i][j];
+            s *= beta;
+            for (int i = 0; i < m; i++)
+                H[r+i][j] -= s*u[i];
+        }
+        for (int i = r0; i <= r1; i++)
+        {
+            real s = 0;
+            for (int j = 0; j < m; j++)
+                s += H[i][r+j]*u[j];
+            s *= beta;
+            for (int j = 0; j < m; j++)
+                H[i][r+j] -= s*u[j];
+        }
+    }
+
+    void eigenvalues_nonsymm4(const real* a, real* re, real* im)
+    {
+        const real EPS = std::numeric_limits<real>::epsilon();
+        const int MAX_ITERATIONS = 120;
+
+        // matrix is scaled to unit maximal element
+        real H[4][4], scale = 0;
+        for (int i = 0; i < 16; i++)
+            scale = std::max(scale, std::abs(a[i]));
+        if (scale == 0)
+        {
+            for (int i = 0; i < 4; i++)
+                re[i] = im[i] = 0;
+            return;
+        }
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                H[i][j] = a[4*i + j]/scale;
+
+        // ========== Reduction to Hessenberg form ==========
+        // column k is reflected onto its subdiagonal element
+        for (int k = 0; k < 2; k++)
+        {
+            real v[3];
+            for (int i = k+1; i < 4; i++)
+                v[i-k-1] = H[i][k];
+            householder4(H, v, 3-k, k+1, k, 3, 0, 3);
+            for (int i = k+2; i < 4; i++)
+                H[i][k] = 0;
+        }
+
+        // ========== Francis double shift QR iteration ==========
+        // active block H[lo..hi][lo..hi] is iterated until its last
+        // subdiagonal element (or the one before) vanishes; eigenvalues of
+        // deflated 1x1 or 2x2 blocks are saved and the block is shrunk
+        int hi = 3, iterations = 0;
+        while (hi >= 0)
+        {
+            int lo = hi;
+            while (lo > 0)
+            {
+                real d = std::abs(H[lo-1][lo-1]) + std::abs(H[lo][lo]);
+                if (std::abs(H[lo][lo-1]) <= EPS*(d == 0 ? 1 : d))
+                {
+                    H[lo][lo-1] = 0;
+                    break;
+                }
+                lo--;
+            }
+
+            if (lo == hi)
+            {
+                re[hi] = H[hi][hi]*scale;
+                im[hi] = 0;
+                hi--;
+                iterations = 0;
+                continue;
+            }
+            if (lo == hi-1)
+            {
+                // eigenvalues of 2x2 block
+                real mean = 0.5*(H[lo][lo] + H[hi][hi]);
+                real half = 0.5*(H[lo][lo] - H[hi][hi]);
+                real disc = half*half + H[lo][hi]*H[hi][lo];
+                if (disc >= 0)
+                {
+                    re[lo] = (mean + std::sqrt(disc))*scale;
+                    re[hi] = (mean - std::sqrt(disc))*scale;
+                    im[lo] = im[hi] = 0;
+                }
+                else
+                {
+                    re[lo] = re[hi] = mean*scale;
+                    im[lo] = std::sqrt(-disc)*scale;
+                    im[hi] = -im[lo];
+                }
+                hi -= 2;
+                iterations = 0;
+                continue;
+            }
+
+            if (iterations == MAX_ITERATIONS)
+                throw std::runtime_error("Too much iterations in routine eigenvalues_nonsymm4");
+            iterations++;
+
+            // shifts are eigenvalues of trailing 2x2 block, they are
+            // replaced by a double real shift when convergence stalls
+            real sum = H[hi-1][hi-1] + H[hi][hi];
+            real prod = H[hi-1][hi-1]*H[hi][hi] - H[hi-1][hi]*H[hi][hi-1];
+            if (iterations % 10 == 0)
+            {
+                real shift = H[hi][hi] + std::abs(H[hi][hi-1]) + std::abs(H[hi-1][hi-2]);
+                sum = 2*shift;
+                prod = shift*shift;
+            }
+
+            // first column of (H - s1)(H - s2) is chased down the block by
+            // reflections, the block stays in Hessenberg form
+            real v[3];
+            v[0] = H[lo][lo]*H[lo][lo] + H[lo][lo+1]*H[lo+1][lo] - sum*H[lo][lo] + prod;
+            v[1] = H[lo+1][lo]*(H[lo][lo] + H[lo+1][lo+1] - sum);
+            v[2] = H[lo+1][lo]*H[lo+2][lo+1];
+            for (int k = lo; k < hi-1; k++)
+            {
+                householder4(H, v, 3, k, std::max(lo, k-1), hi, lo, std::min(k+3, hi));
+                if (k > lo)
+                    H[k+1][k-1] = H[k+2][k-1] = 0;
+                v[0] = H[k+1][k];
+                v[1] = H[k+2][k];
+                if (k < hi-2)
+                    v[2] = H[k+3][k];
+            }
+            householder4(H, v, 2, hi-1, hi-2, hi, lo, hi);
+            H[hi][hi-2] = 0;
+        }
+    }
+
+    void eigenvalues_symm(const int& n, real* a, real* eig)
+    {
+        auto A = [a, n](const int &i, const int &j) -> real& { return a[i*n + j]; };
+        const real EPS = std::numeric_limits<real>::epsilon();
+        const int MAX_SWEEPS = 50;
+
+        for (int sweep = 0; sweep < MAX_SWEEPS; sweep++)
+        {
+            // ========== Checking convergence ==========
+            real off = 0, diag = 0;
+            for (int p = 0; p < n; p++)
+            {
+                diag += A(p, p)*A(p, p);
+                for (int q = p+1; q < n; q++)
+                    off += A(p, q)*A(p, q);
+            }
+            if (off <= EPS*EPS*diag || off == 0)
+            {
+                for (int p = 0; p < n; p++)
+                    eig[p] = A(p, p);
+                return;
+            }
+
+            // ========== Jacobi rotations ==========
+            for (int p = 0; p < n-1; p++)
+                for (int q = p+1; q < n; q++)
+                {
+                    real apq = A(p, q);
+                    if (apq == 0)
+                        continue;
+                    real theta = 0.5*(A(q, q) - A(p, p))/apq;
+                    real t = 1/(std::abs(theta) + std::sqrt(theta*theta + 1));
+                    if (theta < 0)
+                        t = -t;
+                    real c = 1/std::sqrt(t*t + 1), s = t*c, tau = s/(1 + c);
+                    A(p, p) -= t*apq;
+                    A(q, q) += t*apq;
+                    A(p, q) = A(q, p) = 0;
+                    for (int r = 0; r < n; r++)
+                    {
+                        if (r == p || r == q)
+                            continue;
+                        real g = A(r, p), h = A(r, q);
+                        A(r, p) = A(p, r) = g - s*(h + g*tau);
+                        A(r, q) = A(q, r) = h + s*(g - h*tau);
+                    }
+                }
+        }
+        throw std::runtime_error("Too much iterations in routine eigenvalues_symm");
+    }
+}
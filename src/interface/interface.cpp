@@ -1,17 +1,22 @@
 #include "interface/interface.hpp"
 #include "interface/usefullfunctions.hpp"
+#include "interface/parallelsweep.hpp"
 #include "gravitacek2/geomotion/spacetimes.hpp"
 #include "gravitacek2/integrator/integrator.hpp"
 #include "gravitacek2/integrator/odesystems.hpp"
 #include "gravitacek2/chaos/linearized_evolution.hpp"
+#include "gravitacek2/chaos/chaos_indicators.hpp"
 
 #include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <array>
 #include <cmath>
+#include <csignal>
+#include <atomic>
 
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_eigen.h>
@@ -122,6 +127,16 @@ bool Interface::try_apply_operators(std::string text)
         this->help(rest);
         return true;
     }
+    else if(command == "statistics")
+    {
+        this->set_statistics(rest);
+        return true;
+    }
+    else if(command == "promotion")
+    {
+        this->set_promotion(rest);
+        return true;
+    }
 
     return false;
 }
@@ -196,6 +211,31 @@ void Interface::print_all_macros()
     }
 }
 
+void Interface::set_statistics(std::string text)
+{
+    text = this->strip(text);
+    if (text == "on")
+        this->print_statistics = true;
+    else if (text == "off")
+        this->print_statistics = false;
+    else
+        throw std::invalid_argument("statistics can be only on or off");
+}
+
+void Interface::set_promotion(std::string text)
+{
+    text = this->strip(text);
+    if (text == "off")
+    {
+        this->promotion_tolerance = 0;
+        return;
+    }
+    gr2::real tolerance = std::stold(text);
+    if (!(tolerance > 0))
+        throw std::invalid_argument("tolerance for promotion has to be positive");
+    this->promotion_tolerance = tolerance;
+}
+
 void Interface::help(std::string text)
 {
     text = this->strip(text);
@@ -241,6 +281,12 @@ std::shared_ptr<gr2::Weyl> Interface::create_weyl_spacetime(std::string text)
         }
         spacetime = std::make_shared<gr2::CombinedWeyl>(sources);
     }
+    else if (spacetime_name == "SurrogateWeyl")
+    {
+        if (args.size() != 5)
+            throw std::invalid_argument("invalid number of arguments for SurrogateWeyl");
+        spacetime = std::make_shared<gr2::SurrogateWeyl>(this->create_weyl_spacetime(args[0]), std::stold(args[1]), std::stold(args[2]), std::stold(args[3]), std::stold(args[4]));
+    }
     else if (spacetime_name == "WeylSchwarzschild")
     {
         if (args.size() != 1)
@@ -429,6 +475,16 @@ bool Interface::try_apply_function(std::string text)
         this->poincare_section_mp(rest);
         return true;
     }
+    else if (name == "chaos_indicators_weyl")
+    {
+        this->chaos_indicators_weyl(rest);
+        return true;
+    }
+    else if (name == "chaos_indicators_mp")
+    {
+        this->chaos_indicators_mp(rest);
+        return true;
+    }
     else if (name == "numerical_expansions_weyl")
     {
         this->numerical_expansions_weyl(rest);
@@ -636,6 +692,48 @@ std::shared_ptr<gr2::OdeSystem> Interface::create_ode_system(std::string text)
 //     }
 // }
 
+// set by SIGINT during evaluation of map
+static std::atomic<bool> map_cancelled(false);
+
+static void cancel_map(int signal)
+{
+    map_cancelled = true;
+}
+
+void Interface::evaluate_map(int n_rho, int n_z, int n_threads, std::function<MapPointTask(int)> create_worker, std::ostream &out)
+{
+    // print progress only when percents change
+    int last_percent = -1;
+    auto progress = [&](long done, long total)
+    {
+        int percent = (int)(100*done/total);
+        if (percent == last_percent)
+            return;
+        last_percent = percent;
+        std::cout << "\rprogress: " << percent << " %";
+        std::cout.flush();
+    };
+
+    // Ctrl+C stops evaluation of map instead of application
+    map_cancelled = false;
+    auto previous_handler = std::signal(SIGINT, cancel_map);
+    bool completed;
+    try
+    {
+        completed = parallel_map(n_rho, n_z, n_threads, create_worker, out, &map_cancelled, progress);
+    }
+    catch(...)
+    {
+        std::signal(SIGINT, previous_handler);
+        std::cout << "\n";
+        throw;
+    }
+    std::signal(SIGINT, previous_handler);
+    std::cout << "\n";
+    if (!completed)
+        std::cout << "evaluation of map was cancelled\n";
+}
+
 void Interface::local_expansions_weyl(std::string text)
 {
     // Initialize calculation
@@ -643,10 +741,10 @@ void Interface::local_expansions_weyl(std::string text)
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::Weyl> spt = this->create_weyl_spacetime(args[0]);
+    std::shared_ptr<gr2::Weyl> spacetime = this->create_weyl_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -669,9 +767,9 @@ void Interface::local_expansions_weyl(std::string text)
     int n_angles = std::stoi(args[5]);
     gr2::real delta_angle = 2*gr2::pi/n_angles;
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -682,11 +780,15 @@ void Interface::local_expansions_weyl(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::Weyl> spt(spacetime->clone());
 
-        // calculate eigenvalues
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+            return [=](int i, int j) -> std::string
             {
+                gr2::real y[9]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = z_min + j*delta_z;
                 if (std::abs(z) < 1e-3)
@@ -708,9 +810,9 @@ void Interface::local_expansions_weyl(std::string text)
                 // calculate size of rest velocity
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
                 if (norm2 < 0)
-                    continue;
+                    return "";
                 gr2::real norm2_c = norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO];
-                gr2::real norm_c = sqrtl(norm2_c);
+                gr2::real norm_c = std::sqrt(norm2_c);
             
                 gr2::real method_value = 0;
                 for (int k = 0; k < n_angles; k++)
@@ -719,19 +821,24 @@ void Interface::local_expansions_weyl(std::string text)
                     gr2::real angle = k*delta_angle;
 
                     // calculate rest of velocity
-                    y[gr2::Weyl::URHO] = norm_c*cosl(angle);
-                    y[gr2::Weyl::UZ] = norm_c*sinl(angle);
+                    y[gr2::Weyl::URHO] = norm_c*std::cos(angle);
+                    y[gr2::Weyl::UZ] = norm_c*std::sin(angle);
 
                     // calculate value
                     value = gr2::expected_growth(spt.get(), y);
                     method_value = std::max(value, method_value);
                 }
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
+                return data.str();
+            };
+        };
+
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
 
-            // close file
-            file.close();
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -747,10 +854,10 @@ void Interface::local_expansions_mp(std::string text)
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt = this->create_mp_spacetime(args[0]);
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime = this->create_mp_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -773,9 +880,9 @@ void Interface::local_expansions_mp(std::string text)
     int n_angles = std::stoi(args[5]);
     gr2::real delta_angle = 2*gr2::pi/n_angles;
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[8]={};
 
     // Procede in calculation
     try
@@ -786,11 +893,15 @@ void Interface::local_expansions_mp(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt(spacetime->clone());
 
-        // calculate eigenvalues
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+            return [=](int i, int j) -> std::string
             {
+                gr2::real y[8]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = z_min + j*delta_z;
                 if (std::abs(z) < 1e-3)
@@ -808,9 +919,9 @@ void Interface::local_expansions_mp(std::string text)
                 // calculate size of rest velocity
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
                 if (norm2 < 0)
-                    continue;
+                    return "";
                 gr2::real norm2_c = norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO];
-                gr2::real norm_c = sqrtl(norm2_c);
+                gr2::real norm_c = std::sqrt(norm2_c);
             
                 gr2::real method_value = 0;
                 for (int k = 0; k < n_angles; k++)
@@ -819,19 +930,24 @@ void Interface::local_expansions_mp(std::string text)
                     gr2::real angle = k*delta_angle;
 
                     // calculate rest of velocity
-                    y[gr2::Weyl::URHO] = norm_c*cosl(angle);
-                    y[gr2::Weyl::UZ] = norm_c*sinl(angle);
+                    y[gr2::Weyl::URHO] = norm_c*std::cos(angle);
+                    y[gr2::Weyl::UZ] = norm_c*std::sin(angle);
 
                     // calculate value
                     value = gr2::expected_growth(spt.get(), y);
                     method_value = std::max(value, method_value);
                 }
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
+                return data.str();
+            };
+        };
+
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
 
-            // close file
-            file.close();
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -847,10 +963,10 @@ void Interface::norm_growth_weyl(std::string text)
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::Weyl> spt = this->create_weyl_spacetime(args[0]);
+    std::shared_ptr<gr2::Weyl> spacetime = this->create_weyl_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -873,9 +989,9 @@ void Interface::norm_growth_weyl(std::string text)
     int n_angles = std::stoi(args[5]);
     gr2::real delta_angle = 2*gr2::pi/n_angles;
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -886,10 +1002,16 @@ void Interface::norm_growth_weyl(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        // calculate eigenvalues
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::Weyl> spt(spacetime->clone());
+            std::vector<gr2::real> velocities(4*n_angles), values(n_angles);
+
+            return [=](int i, int j) mutable -> std::string
             {
+                gr2::real y[9]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = z_min + j*delta_z;
                 if (std::abs(z) < 1e-3)
@@ -911,30 +1033,38 @@ void Interface::norm_growth_weyl(std::string text)
                 // calculate size of rest velocity
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
                 if (norm2 < 0)
-                    continue;
+                    return "";
                 gr2::real norm2_c = norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO];
-                gr2::real norm_c = sqrtl(norm2_c);
+                gr2::real norm_c = std::sqrt(norm2_c);
             
-                gr2::real method_value = 0;
                 for (int k = 0; k < n_angles; k++)
                 {
-                    gr2::real value = 0;
                     gr2::real angle = k*delta_angle;
 
-                    // calculate rest of velocity
-                    y[gr2::Weyl::URHO] = norm_c*cosl(angle);
-                    y[gr2::Weyl::UZ] = norm_c*sinl(angle);
-
-                    // calculate value
-                    value = gr2::max_norm_growth(spt.get(), y);
-                    method_value = std::max(value, method_value);
+                    // calculate velocity
+                    gr2::real *u = velocities.data() + 4*k;
+                    u[gr2::Weyl::T] = y[gr2::Weyl::UT];
+                    u[gr2::Weyl::PHI] = y[gr2::Weyl::UPHI];
+                    u[gr2::Weyl::RHO] = norm_c*std::cos(angle);
+                    u[gr2::Weyl::Z] = norm_c*std::sin(angle);
                 }
+
+                // calculate values for all directions at once
+                gr2::max_norm_growth(spt.get(), y, n_angles, velocities.data(), values.data());
+                gr2::real method_value = 0;
+                for (int k = 0; k < n_angles; k++)
+                    method_value = std::max(values[k], method_value);
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
+                return data.str();
+            };
+        };
+
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
 
-            // close file
-            file.close();
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -950,10 +1080,10 @@ void Interface::norm_growth_mp(std::string text)
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt = this->create_mp_spacetime(args[0]);
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime = this->create_mp_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -976,9 +1106,9 @@ void Interface::norm_growth_mp(std::string text)
     int n_angles = std::stoi(args[5]);
     gr2::real delta_angle = 2*gr2::pi/n_angles;
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -989,10 +1119,16 @@ void Interface::norm_growth_mp(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        // calculate eigenvalues
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt(spacetime->clone());
+            std::vector<gr2::real> velocities(4*n_angles), values(n_angles);
+
+            return [=](int i, int j) mutable -> std::string
             {
+                gr2::real y[9]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = z_min + j*delta_z;
                 if (std::abs(z) < 1e-3)
@@ -1011,30 +1147,38 @@ void Interface::norm_growth_mp(std::string text)
                 // calculate size of rest velocity
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
                 if (norm2 < 0)
-                    continue;
+                    return "";
                 gr2::real norm2_c = norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO];
-                gr2::real norm_c = sqrtl(norm2_c);
+                gr2::real norm_c = std::sqrt(norm2_c);
             
-                gr2::real method_value = 0;
                 for (int k = 0; k < n_angles; k++)
                 {
-                    gr2::real value = 0;
                     gr2::real angle = k*delta_angle;
 
-                    // calculate rest of velocity
-                    y[gr2::Weyl::URHO] = norm_c*cosl(angle);
-                    y[gr2::Weyl::UZ] = norm_c*sinl(angle);
-
-                    // calculate value
-                    value = gr2::max_norm_growth(spt.get(), y);
-                    method_value = std::max(value, method_value);
+                    // calculate velocity
+                    gr2::real *u = velocities.data() + 4*k;
+                    u[gr2::Weyl::T] = y[gr2::Weyl::UT];
+                    u[gr2::Weyl::PHI] = y[gr2::Weyl::UPHI];
+                    u[gr2::Weyl::RHO] = norm_c*std::cos(angle);
+                    u[gr2::Weyl::Z] = norm_c*std::sin(angle);
                 }
+
+                // calculate values for all directions at once
+                gr2::max_norm_growth(spt.get(), y, n_angles, velocities.data(), values.data());
+                gr2::real method_value = 0;
+                for (int k = 0; k < n_angles; k++)
+                    method_value = std::max(values[k], method_value);
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << method_value << "\n";
+                return data.str();
+            };
+        };
 
-            // close file
-            file.close();
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
+
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -1050,10 +1194,10 @@ void Interface::rest_norm2_weyl(std::string text)
     int number_of_arguments = 6;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::Weyl> spt = this->create_weyl_spacetime(args[0]);
+    std::shared_ptr<gr2::Weyl> spacetime = this->create_weyl_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -1074,9 +1218,9 @@ void Interface::rest_norm2_weyl(std::string text)
     gr2::real delta_z = (z_max-z_min)/(n_z-1);
     
     std::string file_name = args[5];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[6] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -1087,10 +1231,15 @@ void Interface::rest_norm2_weyl(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        // calculate norms
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::Weyl> spt(spacetime->clone());
+
+            return [=](int i, int j) -> std::string
             {
+                gr2::real y[9]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = std::abs(z_min + j*delta_z);
                 if (std::abs(z) < 1e-3)
@@ -1113,11 +1262,16 @@ void Interface::rest_norm2_weyl(std::string text)
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
             
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << norm2 << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << norm2 << "\n";
+                return data.str();
+            };
+        };
+
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
 
-            // close file
-            file.close();
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -1133,10 +1287,10 @@ void Interface::rest_norm2_mp(std::string text)
     int number_of_arguments = 6;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for local_expansions_Weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for local_expansions_Weyl");
 
-    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt = this->create_mp_spacetime(args[0]);
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime = this->create_mp_spacetime(args[0]);
 
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
@@ -1157,9 +1311,9 @@ void Interface::rest_norm2_mp(std::string text)
     gr2::real delta_z = (z_max-z_min)/(n_z-1);
     
     std::string file_name = args[5];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[6] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -1170,10 +1324,15 @@ void Interface::rest_norm2_mp(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        // calculate norms
-        for (int i = 0; i < n_rho; i++)
-            for (int j = 0; j < n_z; j++)
+        // every thread has its own spacetime
+        auto create_worker = [&](int thread) -> MapPointTask
+        {
+            std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt(spacetime->clone());
+
+            return [=](int i, int j) -> std::string
             {
+                gr2::real y[9]={};
+
                 gr2::real rho = rho_min + i*delta_rho;
                 gr2::real z = z_min + j*delta_z;
                 if (std::abs(z) < 1e-3)
@@ -1192,11 +1351,16 @@ void Interface::rest_norm2_mp(std::string text)
                 gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
             
                 // save values to the file
-                file << i << ";" << j << ";" << rho << ";" << z << ";" << norm2 << "\n";
-            }
+                std::ostringstream data;
+                data << i << ";" << j << ";" << rho << ";" << z << ";" << norm2 << "\n";
+                return data.str();
+            };
+        };
+
+        evaluate_map(n_rho, n_z, n_threads, create_worker, file);
 
-            // close file
-            file.close();
+        // close file
+        file.close();
     }
     catch(const std::exception& e)
     {
@@ -1266,7 +1430,7 @@ void Interface::poincare_border_weyl(std::string text)
             if (norm2<0)
                 urho = 0;
             else
-                urho = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+                urho = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
         
             // save values to the file
             file << i << ";" << rho << ";" << urho << "\n";
@@ -1338,7 +1502,7 @@ void Interface::poincare_border_mp(std::string text)
             if (norm2<0)
                 urho = 0;
             else
-                urho = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+                urho = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
         
             // save values to the file
             file << i << ";" << rho << ";" << urho << "\n";
@@ -1355,19 +1519,15 @@ void Interface::poincare_border_mp(std::string text)
 
 void Interface::poincare_section_weyl(std::string text)
 {
-    std::cout << std::fixed;
-    std::cout << std::setprecision(2);
-
     // Initialize calculation
     auto args = find_function_arguments(text);
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for poincare_section_weyl");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for poincare_section_weyl");
 
-    std::shared_ptr<gr2::Weyl> spt = this->create_weyl_spacetime(args[0]);
-
+    std::shared_ptr<gr2::Weyl> spacetime = this->create_weyl_spacetime(args[0]);
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
     auto range_rho = find_function_arguments(args[3]);
@@ -1382,9 +1542,9 @@ void Interface::poincare_section_weyl(std::string text)
     gr2::real delta_angle = gr2::pi_4/angles;
     gr2::real t_max = std::stoll(args[5]);
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[9]={};
 
     // Procede in calculation
     try
@@ -1395,96 +1555,105 @@ void Interface::poincare_section_weyl(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        gr2::Integrator integrator(spt, "DoPr853", 1e-17, 1e-17, false);
-        auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
-        integrator.add_event(too_close);
-        auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::Weyl>>(spt,E,1e-10);
-        integrator.add_event(errorE_too_high);
-        auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::Weyl>>(spt,L,1e-10);
-        integrator.add_event(errorL_too_high);
-        auto stop_on_disk = std::make_shared<StopOnDisk<gr2::Weyl>>(spt, 1e-4, true);
-        integrator.add_event(stop_on_disk);
-        auto disk_reg = std::make_shared<RegularizeApproach>(1e-4, 1e-4, 0.8, 0.8);
-        integrator.add_event(disk_reg);
-
-        // calculate norms
-        for (int i = 0; i < n_rho; i++)
+        // every thread has its own spacetime, integrator and events
+        bool statistics = this->print_statistics;
+        gr2::real promotion = this->promotion_tolerance;
+        auto create_worker = [&](int thread) -> SweepTask
         {
-            gr2::real rho = rho_min + i*delta_rho;
-            gr2::real z = 1e-4;
-            y[gr2::Weyl::RHO] = rho;
-            y[gr2::Weyl::Z] = z;
+            std::shared_ptr<gr2::Weyl> spt(spacetime->clone());
+            gr2::real tol = promotion > 0 ? promotion : 1e-17;
+            auto integrator = std::make_shared<gr2::Integrator>(spt, "DoPr853", tol, tol, false);
+            integrator->enable_statistics(statistics);
+            // tighter tolerance while drift of E or L exceeds half of the limit
+            if (promotion > 0)
+                integrator->set_tolerance_promotion(ConservationDrift<gr2::Weyl>(spt, E, L), 0.5*1e-10, 1e-17, 1e-17, 0);
+            auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
+            integrator->add_event(too_close);
+            auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::Weyl>>(spt,E,1e-10);
+            integrator->add_event(errorE_too_high);
+            auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::Weyl>>(spt,L,1e-10);
+            integrator->add_event(errorL_too_high);
+            auto stop_on_disk = std::make_shared<StopOnDisk<gr2::Weyl>>(spt, 1e-4, true);
+            integrator->add_event(stop_on_disk);
+            auto disk_reg = std::make_shared<RegularizeApproach>(1e-4, 1e-4, 0.8, 0.8);
+            integrator->add_event(disk_reg);
+
+            return [=](int task) -> SweepResult
+            {
+                SweepResult result;
+                int i = task/angles;
+                int j = task%angles;
+                gr2::real y[9]={};
 
-            // calculate lambda 
-            spt->calculate_lambda_init(y);
-            y[gr2::Weyl::LAMBDA] = spt->get_lambda();
+                gr2::real rho = rho_min + i*delta_rho;
+                gr2::real z = 1e-4;
+                y[gr2::Weyl::RHO] = rho;
+                y[gr2::Weyl::Z] = z;
 
-            // calculate ut (from E)
-            spt->calculate_metric(y);
-            y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+                // calculate lambda 
+                spt->calculate_lambda_init(y);
+                y[gr2::Weyl::LAMBDA] = spt->get_lambda();
 
-            // calculate uphi (from L)
-            y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+                // calculate ut (from E)
+                spt->calculate_metric(y);
+                y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
 
-            // calculate size of rest velocity
-            gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
-            if (norm2 < 0)
-                continue;
-            gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+                // calculate uphi (from L)
+                y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
 
-            std::cout << i+1 << "/" << n_rho << ", rho = " << y[gr2::Weyl::RHO] << std::endl; 
-            for (int j = 0; j < angles; j++)
-            {
-                std::cout << j+1 << "/" << angles << ", reason of termination: ";
-                std::cout.flush();
+                // calculate size of rest velocity
+                gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
+                if (norm2 < 0)
+                    return result;
+                gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
                 // calculate initial conditions
                 gr2::real angle = j*delta_angle;
-                y[gr2::Weyl::URHO] = norm*sinl(angle);
-                y[gr2::Weyl::UZ] = norm*cosl(angle);
+                y[gr2::Weyl::URHO] = norm*std::sin(angle);
+                y[gr2::Weyl::UZ] = norm*std::cos(angle);
+
+                std::ostringstream log;
+                log << std::fixed << std::setprecision(2);
+                log << i+1 << "/" << n_rho << ", " << j+1 << "/" << angles << ", rho = " << rho << ", reason of termination: ";
 
                 // calculate poincare section
+                errorE_too_high->activated = false;
+                errorL_too_high->activated = false;
+                too_close->activated = false;
+                stop_on_disk->data.clear();
                 try
                 {
-                    /* code */
-                    integrator.integrate(y, 0, t_max, 0.2);
+                    integrator->integrate(y, 0, t_max, 0.2);
                 }
                 catch(const std::exception& e)
                 {
-                    std::cerr << e.what() << '\n';
+                    log << e.what() << ", ";
                 }
-                
+
                 // save data
+                std::ostringstream data;
                 for (auto& d : stop_on_disk->data)
-                    file << d[0] << ";" << d[1] << "\n";
-
-                // delete data
-                stop_on_disk->data.clear();
-                file.flush();
+                    data << d[0] << ";" << d[1] << "\n";
+                result.data = data.str();
 
                 if (errorE_too_high->activated)
-                {
-                    std::cout << "Energy, t = " << errorE_too_high->t / t_max*100 << " %" << std::endl;
-                }
+                    log << "Energy, t = " << errorE_too_high->t / t_max*100 << " %\n";
                 else if (errorL_too_high->activated)
-                {
-                    std::cout << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %" << std::endl;
-                }
+                    log << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %\n";
                 else if (too_close->activated)
-                {
-                    std::cout << "Black hole, t = " << too_close->t / t_max*100 << " %" << std::endl;
-                }
+                    log << "Black hole, t = " << too_close->t / t_max*100 << " %\n";
                 else
-                {
-                    std::cout << "None, t = 100 %" << std::endl;
-                }
-                errorE_too_high->activated = false;
-                errorL_too_high->activated = false;
-                too_close->activated = false;
-            }
-        }
-        std::cout << std::defaultfloat;
-        std::cout << std::setprecision(6);
+                    log << "None, t = 100 %\n";
+                if (statistics)
+                    log << "statistics: " << integrator->get_statistics().to_string() << "\n";
+                result.log = log.str();
+
+                return result;
+            };
+        };
+
+        parallel_sweep(n_rho*angles, n_threads, create_worker, file);
+
         // close file
         file.close();
     }
@@ -1497,19 +1666,15 @@ void Interface::poincare_section_weyl(std::string text)
 
 void Interface::poincare_section_mp(std::string text)
 {
-    std::cout << std::fixed;
-    std::cout << std::setprecision(2);
-
     // Initialize calculation
     auto args = find_function_arguments(text);
     int number_of_arguments = 7;
     if (args.size() < number_of_arguments)
         throw std::invalid_argument("too little arguments for poincare_section_mp");
-    else if (args.size() > number_of_arguments)
+    else if (args.size() > number_of_arguments + 1)
         throw std::invalid_argument("too much arguments for poincare_section_mp");
 
-    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt = this->create_mp_spacetime(args[0]);
-
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime = this->create_mp_spacetime(args[0]);
     gr2::real E = std::stold(args[1]);
     gr2::real L = std::stold(args[2]);
     auto range_rho = find_function_arguments(args[3]);
@@ -1524,9 +1689,9 @@ void Interface::poincare_section_mp(std::string text)
     gr2::real delta_angle = gr2::pi_4/angles;
     gr2::real t_max = std::stoll(args[5]);
     std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
 
     std::ofstream file;
-    gr2::real y[8]={};
 
     // Procede in calculation
     try
@@ -1537,92 +1702,425 @@ void Interface::poincare_section_mp(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        gr2::Integrator integrator(spt, "DoPr853", 1e-17, 1e-17, false);
-        auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
-        integrator.add_event(too_close);
-        auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::MajumdarPapapetrouWeyl>>(spt,E,1e-10);
-        integrator.add_event(errorE_too_high);
-        auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::MajumdarPapapetrouWeyl>>(spt,L,1e-10);
-        integrator.add_event(errorL_too_high);
-        auto stop_on_disk = std::make_shared<StopOnDisk<gr2::MajumdarPapapetrouWeyl>>(spt, 1e-4, true);
-        integrator.add_event(stop_on_disk);
-        auto disk_reg = std::make_shared<RegularizeApproach>(1e-5, 1e-5, 0.8, 0.8);
-        integrator.add_event(disk_reg);
-
-        // calculate norms
-        for (int i = 0; i < n_rho; i++)
+        // every thread has its own spacetime, integrator and events
+        bool statistics = this->print_statistics;
+        gr2::real promotion = this->promotion_tolerance;
+        auto create_worker = [&](int thread) -> SweepTask
         {
-            gr2::real rho = rho_min + i*delta_rho;
-            gr2::real z = 1e-3;
-            y[gr2::Weyl::RHO] = rho;
-            y[gr2::Weyl::Z] = z;
+            std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt(spacetime->clone());
+            gr2::real tol = promotion > 0 ? promotion : 1e-17;
+            auto integrator = std::make_shared<gr2::Integrator>(spt, "DoPr853", tol, tol, false);
+            integrator->enable_statistics(statistics);
+            // tighter tolerance while drift of E or L exceeds half of the limit
+            if (promotion > 0)
+                integrator->set_tolerance_promotion(ConservationDrift<gr2::MajumdarPapapetrouWeyl>(spt, E, L), 0.5*1e-10, 1e-17, 1e-17, 0);
+            auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
+            integrator->add_event(too_close);
+            auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::MajumdarPapapetrouWeyl>>(spt,E,1e-10);
+            integrator->add_event(errorE_too_high);
+            auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::MajumdarPapapetrouWeyl>>(spt,L,1e-10);
+            integrator->add_event(errorL_too_high);
+            auto stop_on_disk = std::make_shared<StopOnDisk<gr2::MajumdarPapapetrouWeyl>>(spt, 1e-4, true);
+            integrator->add_event(stop_on_disk);
+            auto disk_reg = std::make_shared<RegularizeApproach>(1e-5, 1e-5, 0.8, 0.8);
+            integrator->add_event(disk_reg);
+
+            return [=](int task) -> SweepResult
+            {
+                SweepResult result;
+                int i = task/angles;
+                int j = task%angles;
+                gr2::real y[8]={};
 
-            // calculate ut (from E)
-            spt->calculate_metric(y);
-            y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+                gr2::real rho = rho_min + i*delta_rho;
+                gr2::real z = 1e-3;
+                y[gr2::Weyl::RHO] = rho;
+                y[gr2::Weyl::Z] = z;
 
-            // calculate uphi (from L)
-            y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+                // calculate ut (from E)
+                spt->calculate_metric(y);
+                y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
 
-            // calculate size of rest velocity
-            gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
-            if (norm2 < 0)
-                continue;
-            gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+                // calculate uphi (from L)
+                y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
 
-            std::cout << i+1 << "/" << n_rho << ", rho = " << y[gr2::Weyl::RHO] << std::endl; 
-            for (int j = 0; j < angles; j++)
-            {
-                std::cout << j+1 << "/" << angles << ", reason of termination: ";
-                std::cout.flush();
+                // calculate size of rest velocity
+                gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
+                if (norm2 < 0)
+                    return result;
+                gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
                 // calculate initial conditions
                 gr2::real angle = j*delta_angle;
-                y[gr2::Weyl::URHO] = norm*sinl(angle);
-                y[gr2::Weyl::UZ] = norm*cosl(angle);
+                y[gr2::Weyl::URHO] = norm*std::sin(angle);
+                y[gr2::Weyl::UZ] = norm*std::cos(angle);
+
+                std::ostringstream log;
+                log << std::fixed << std::setprecision(2);
+                log << i+1 << "/" << n_rho << ", " << j+1 << "/" << angles << ", rho = " << rho << ", reason of termination: ";
 
                 // calculate poincare section
+                errorE_too_high->activated = false;
+                errorL_too_high->activated = false;
+                too_close->activated = false;
+                stop_on_disk->data.clear();
                 try
                 {
-                    /* code */
-                    integrator.integrate(y, 0, t_max, 0.2);
+                    integrator->integrate(y, 0, t_max, 0.2);
                 }
                 catch(const std::exception& e)
                 {
-                    std::cerr << e.what() << '\n';
+                    log << e.what() << ", ";
                 }
-                
+
                 // save data
+                std::ostringstream data;
                 for (auto& d : stop_on_disk->data)
-                    file << d[0] << ";" << d[1] << "\n";
-
-                // delete data
-                stop_on_disk->data.clear();
-                file.flush();
+                    data << d[0] << ";" << d[1] << "\n";
+                result.data = data.str();
 
                 if (errorE_too_high->activated)
-                {
-                    std::cout << "Energy, t = " << errorE_too_high->t / t_max*100 << " %" << std::endl;
-                }
+                    log << "Energy, t = " << errorE_too_high->t / t_max*100 << " %\n";
                 else if (errorL_too_high->activated)
-                {
-                    std::cout << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %" << std::endl;
-                }
+                    log << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %\n";
                 else if (too_close->activated)
+                    log << "Black hole, t = " << too_close->t / t_max*100 << " %\n";
+                else
+                    log << "None, t = 100 %\n";
+                if (statistics)
+                    log << "statistics: " << integrator->get_statistics().to_string() << "\n";
+                result.log = log.str();
+
+                return result;
+            };
+        };
+
+        parallel_sweep(n_rho*angles, n_threads, create_worker, file);
+
+        // close file
+        file.close();
+    }
+    catch(const std::exception& e)
+    {
+        file.close();
+        throw e;
+    }
+}
+
+void Interface::chaos_indicators_weyl(std::string text)
+{
+    // Initialize calculation
+    auto args = find_function_arguments(text);
+    int number_of_arguments = 7;
+    if (args.size() < number_of_arguments)
+        throw std::invalid_argument("too little arguments for chaos_indicators_weyl");
+    else if (args.size() > number_of_arguments + 1)
+        throw std::invalid_argument("too much arguments for chaos_indicators_weyl");
+
+    std::shared_ptr<gr2::Weyl> spacetime = this->create_weyl_spacetime(args[0]);
+    gr2::real E = std::stold(args[1]);
+    gr2::real L = std::stold(args[2]);
+    auto range_rho = find_function_arguments(args[3]);
+    if (range_rho.size() != 3)
+        throw std::invalid_argument("incorent number of arguments for range in rho");
+    gr2::real rho_min = std::stold(range_rho[0]);
+    gr2::real rho_max = std::stold(range_rho[1]);
+    int n_rho = std::stoi(range_rho[2]);
+    gr2::real delta_rho = (rho_max-rho_min)/(n_rho-1);
+
+    auto range_u = find_function_arguments(args[4]);
+    if (range_u.size() != 3)
+        throw std::invalid_argument("incorent number of arguments for range in u_rho_frac");
+    gr2::real u_min = std::stold(range_u[0]);
+    gr2::real u_max = std::stold(range_u[1]);
+    int n_u = std::stoi(range_u[2]);
+    gr2::real delta_u = (u_max-u_min)/(n_u-1);
+
+    gr2::real t_max = std::stold(args[5]);
+    std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
+
+    std::ofstream file;
+
+    // Procede in calculation
+    try
+    {
+        // open file
+        file.open(file_name);
+
+        if (!file.is_open())
+            throw std::runtime_error("file " + file_name + "could not be opened");
+
+        // every thread has its own spacetime, integrator and events
+        bool statistics = this->print_statistics;
+        gr2::real promotion = this->promotion_tolerance;
+        auto create_worker = [&](int thread) -> SweepTask
+        {
+            std::shared_ptr<gr2::Weyl> spt(spacetime->clone());
+            auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, 3, true);
+            gr2::real tol = promotion > 0 ? promotion : 1e-15;
+            auto integrator = std::make_shared<gr2::Integrator>(variational, "DoPr853", tol, tol, false);
+            integrator->enable_statistics(statistics);
+            // tighter tolerance while drift of E or L exceeds half of the limit
+            if (promotion > 0)
+                integrator->set_tolerance_promotion(ConservationDrift<gr2::Weyl>(spt, E, L), 0.5*1e-10, 1e-15, 1e-15, 0);
+            auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
+            integrator->add_event(too_close);
+            auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::Weyl>>(spt,E,1e-10);
+            integrator->add_event(errorE_too_high);
+            auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::Weyl>>(spt,L,1e-10);
+            integrator->add_event(errorL_too_high);
+            auto disk_reg = std::make_shared<RegularizeApproach>(1e-4, 1e-4, 0.8, 0.8);
+            integrator->add_event(disk_reg);
+
+            // MEGNO stops integration, FLI and SALI are only recorded
+            auto megno = std::make_shared<gr2::MEGNO>(variational, t_max/10);
+            integrator->add_event(megno);
+            auto fli = std::make_shared<gr2::FLI>(variational, t_max/10, 20, 0, false);
+            integrator->add_event(fli);
+            auto sali = std::make_shared<gr2::SALI>(variational, t_max/10, 1e-8, 1, 2, false);
+            integrator->add_event(sali);
+
+            return [=](int task) -> SweepResult
+            {
+                SweepResult result;
+                int i = task/n_u;
+                int j = task%n_u;
+                gr2::real y[9+3*8+2]={};
+
+                gr2::real rho = rho_min + i*delta_rho;
+                gr2::real u_rho_frac = u_min + j*delta_u;
+                gr2::real z = 1e-4;
+                y[gr2::Weyl::RHO] = rho;
+                y[gr2::Weyl::Z] = z;
+
+                // calculate lambda 
+                spt->calculate_lambda_init(y);
+                y[gr2::Weyl::LAMBDA] = spt->get_lambda();
+
+                // calculate ut (from E)
+                spt->calculate_metric(y);
+                y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+
+                // calculate uphi (from L)
+                y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+
+                // calculate size of rest velocity
+                gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
+                if (norm2 < 0)
+                    return result;
+                gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+
+                // calculate initial conditions
+                y[gr2::Weyl::URHO] = norm*u_rho_frac;
+                y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
+                variational->init_deviations(y);
+
+                std::ostringstream log;
+                log << std::fixed << std::setprecision(2);
+                log << i+1 << "/" << n_rho << ", " << j+1 << "/" << n_u << ", rho = " << rho << ", u = " << u_rho_frac << ", reason of termination: ";
+
+                // calculate chaos indicators
+                errorE_too_high->activated = false;
+                errorL_too_high->activated = false;
+                too_close->activated = false;
+                megno->reset();
+                fli->reset();
+                sali->reset();
+                try
                 {
-                    std::cout << "Black hole, t = " << too_close->t / t_max*100 << " %" << std::endl;
+                    integrator->integrate(y, 0, t_max, 0.2);
                 }
-                else
+                catch(const std::exception& e)
                 {
-                    std::cout << "None, t = 100 %" << std::endl;
+                    log << e.what() << ", ";
                 }
+
+                // save data
+                std::ostringstream data;
+                data << rho << ";" << u_rho_frac << ";" << megno->get_value() << ";" << fli->get_value() << ";" << sali->get_value() << ";" << megno->get_time() << ";" << megno->get_orbit_class() << "\n";
+                result.data = data.str();
+
+                if (errorE_too_high->activated)
+                    log << "Energy, t = " << errorE_too_high->t / t_max*100 << " %\n";
+                else if (errorL_too_high->activated)
+                    log << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %\n";
+                else if (too_close->activated)
+                    log << "Black hole, t = " << too_close->t / t_max*100 << " %\n";
+                else if (megno->get_orbit_class() != gr2::OrbitClass::undecided)
+                    log << "Classified, t = " << megno->get_time() / t_max*100 << " %\n";
+                else
+                    log << "None, t = 100 %\n";
+                if (statistics)
+                    log << "statistics: " << integrator->get_statistics().to_string() << "\n";
+                result.log = log.str();
+
+                return result;
+            };
+        };
+
+        parallel_sweep(n_rho*n_u, n_threads, create_worker, file);
+
+        // close file
+        file.close();
+    }
+    catch(const std::exception& e)
+    {
+        file.close();
+        throw e;
+    }
+}
+
+void Interface::chaos_indicators_mp(std::string text)
+{
+    // Initialize calculation
+    auto args = find_function_arguments(text);
+    int number_of_arguments = 7;
+    if (args.size() < number_of_arguments)
+        throw std::invalid_argument("too little arguments for chaos_indicators_mp");
+    else if (args.size() > number_of_arguments + 1)
+        throw std::invalid_argument("too much arguments for chaos_indicators_mp");
+
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime = this->create_mp_spacetime(args[0]);
+    gr2::real E = std::stold(args[1]);
+    gr2::real L = std::stold(args[2]);
+    auto range_rho = find_function_arguments(args[3]);
+    if (range_rho.size() != 3)
+        throw std::invalid_argument("incorent number of arguments for range in rho");
+    gr2::real rho_min = std::stold(range_rho[0]);
+    gr2::real rho_max = std::stold(range_rho[1]);
+    int n_rho = std::stoi(range_rho[2]);
+    gr2::real delta_rho = (rho_max-rho_min)/(n_rho-1);
+
+    auto range_u = find_function_arguments(args[4]);
+    if (range_u.size() != 3)
+        throw std::invalid_argument("incorent number of arguments for range in u_rho_frac");
+    gr2::real u_min = std::stold(range_u[0]);
+    gr2::real u_max = std::stold(range_u[1]);
+    int n_u = std::stoi(range_u[2]);
+    gr2::real delta_u = (u_max-u_min)/(n_u-1);
+
+    gr2::real t_max = std::stold(args[5]);
+    std::string file_name = args[6];
+    int n_threads = number_of_threads(args.size() > number_of_arguments ? args[7] : "");
+
+    std::ofstream file;
+
+    // Procede in calculation
+    try
+    {
+        // open file
+        file.open(file_name);
+
+        if (!file.is_open())
+            throw std::runtime_error("file " + file_name + "could not be opened");
+
+        // every thread has its own spacetime, integrator and events
+        bool statistics = this->print_statistics;
+        gr2::real promotion = this->promotion_tolerance;
+        auto create_worker = [&](int thread) -> SweepTask
+        {
+            std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spt(spacetime->clone());
+            auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, 3, true);
+            gr2::real tol = promotion > 0 ? promotion : 1e-15;
+            auto integrator = std::make_shared<gr2::Integrator>(variational, "DoPr853", tol, tol, false);
+            integrator->enable_statistics(statistics);
+            // tighter tolerance while drift of E or L exceeds half of the limit
+            if (promotion > 0)
+                integrator->set_tolerance_promotion(ConservationDrift<gr2::MajumdarPapapetrouWeyl>(spt, E, L), 0.5*1e-10, 1e-15, 1e-15, 0);
+            auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
+            integrator->add_event(too_close);
+            auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::MajumdarPapapetrouWeyl>>(spt,E,1e-10);
+            integrator->add_event(errorE_too_high);
+            auto errorL_too_high = std::make_shared<StopTooHighErrorL<gr2::MajumdarPapapetrouWeyl>>(spt,L,1e-10);
+            integrator->add_event(errorL_too_high);
+            auto disk_reg = std::make_shared<RegularizeApproach>(1e-5, 1e-5, 0.8, 0.8);
+            integrator->add_event(disk_reg);
+
+            // MEGNO stops integration, FLI and SALI are only recorded
+            auto megno = std::make_shared<gr2::MEGNO>(variational, t_max/10);
+            integrator->add_event(megno);
+            auto fli = std::make_shared<gr2::FLI>(variational, t_max/10, 20, 0, false);
+            integrator->add_event(fli);
+            auto sali = std::make_shared<gr2::SALI>(variational, t_max/10, 1e-8, 1, 2, false);
+            integrator->add_event(sali);
+
+            return [=](int task) -> SweepResult
+            {
+                SweepResult result;
+                int i = task/n_u;
+                int j = task%n_u;
+                gr2::real y[8+3*8+2]={};
+
+                gr2::real rho = rho_min + i*delta_rho;
+                gr2::real u_rho_frac = u_min + j*delta_u;
+                gr2::real z = 1e-3;
+                y[gr2::Weyl::RHO] = rho;
+                y[gr2::Weyl::Z] = z;
+
+                // calculate ut (from E)
+                spt->calculate_metric(y);
+                y[gr2::Weyl::UT] = -E/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+
+                // calculate uphi (from L)
+                y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+
+                // calculate size of rest velocity
+                gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
+                if (norm2 < 0)
+                    return result;
+                gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+
+                // calculate initial conditions
+                y[gr2::Weyl::URHO] = norm*u_rho_frac;
+                y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
+                variational->init_deviations(y);
+
+                std::ostringstream log;
+                log << std::fixed << std::setprecision(2);
+                log << i+1 << "/" << n_rho << ", " << j+1 << "/" << n_u << ", rho = " << rho << ", u = " << u_rho_frac << ", reason of termination: ";
+
+                // calculate chaos indicators
                 errorE_too_high->activated = false;
                 errorL_too_high->activated = false;
                 too_close->activated = false;
-            }
-        }
-        std::cout << std::defaultfloat;
-        std::cout << std::setprecision(6);
+                megno->reset();
+                fli->reset();
+                sali->reset();
+                try
+                {
+                    integrator->integrate(y, 0, t_max, 0.2);
+                }
+                catch(const std::exception& e)
+                {
+                    log << e.what() << ", ";
+                }
+
+                // save data
+                std::ostringstream data;
+                data << rho << ";" << u_rho_frac << ";" << megno->get_value() << ";" << fli->get_value() << ";" << sali->get_value() << ";" << megno->get_time() << ";" << megno->get_orbit_class() << "\n";
+                result.data = data.str();
+
+                if (errorE_too_high->activated)
+                    log << "Energy, t = " << errorE_too_high->t / t_max*100 << " %\n";
+                else if (errorL_too_high->activated)
+                    log << "Momentum, t = " << errorL_too_high->t / t_max*100 << " %\n";
+                else if (too_close->activated)
+                    log << "Black hole, t = " << too_close->t / t_max*100 << " %\n";
+                else if (megno->get_orbit_class() != gr2::OrbitClass::undecided)
+                    log << "Classified, t = " << megno->get_time() / t_max*100 << " %\n";
+                else
+                    log << "None, t = 100 %\n";
+                if (statistics)
+                    log << "statistics: " << integrator->get_statistics().to_string() << "\n";
+                result.log = log.str();
+
+                return result;
+            };
+        };
+
+        parallel_sweep(n_rho*n_u, n_threads, create_worker, file);
+
         // close file
         file.close();
     }
@@ -1680,7 +2178,13 @@ void Interface::numerical_expansions_weyl(std::string text)
     // Procede in calculation
     try
     {
-        gr2::Integrator integrator(ode, "DoPr853", 1e-16, 1e-16, true);
+        gr2::real promotion = this->promotion_tolerance;
+        gr2::real tol = promotion > 0 ? promotion : 1e-16;
+        gr2::Integrator integrator(ode, "DoPr853", tol, tol);
+        integrator.enable_statistics(this->print_statistics);
+        // tighter tolerance while drift of E or L exceeds half of the limit
+        if (promotion > 0)
+            integrator.set_tolerance_promotion(ConservationDrift<gr2::Weyl>(spt, E, L), 0.5*1e-9, 1e-16, 1e-16, 0);
         auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
         integrator.add_event(too_close);
         auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::Weyl>>(spt,E,1e-9);
@@ -1718,11 +2222,11 @@ void Interface::numerical_expansions_weyl(std::string text)
         gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // ========== initial conditions for second particle ==========
         gr2::real* y_ = y + 9;
@@ -1746,11 +2250,11 @@ void Interface::numerical_expansions_weyl(std::string text)
         norm2 = (-1 + y_[gr2::Weyl::UT]*E - y_[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y_[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y_[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y_[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // renormalization
 
@@ -1766,6 +2270,8 @@ void Interface::numerical_expansions_weyl(std::string text)
         {
             std::cerr << e.what() << '\n';
         }
+        if (this->print_statistics)
+            std::cout << "statistics: " << integrator.get_statistics().to_string() << std::endl;
         
         // TODO: save data
         std::cout << "Jdeme ukladat" << std::endl;
@@ -1863,7 +2369,13 @@ void Interface::numerical_expansions_mp(std::string text)
     // Procede in calculation
     try
     {
-        gr2::Integrator integrator(ode, "DoPr853", 1e-16, 1e-16, true);
+        gr2::real promotion = this->promotion_tolerance;
+        gr2::real tol = promotion > 0 ? promotion : 1e-16;
+        gr2::Integrator integrator(ode, "DoPr853", tol, tol);
+        integrator.enable_statistics(this->print_statistics);
+        // tighter tolerance while drift of E or L exceeds half of the limit
+        if (promotion > 0)
+            integrator.set_tolerance_promotion(ConservationDrift<gr2::MajumdarPapapetrouWeyl>(spt, E, L), 0.5*1e-10, 1e-16, 1e-16, 0);
         auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
         integrator.add_event(too_close);
         auto errorE_too_high = std::make_shared<StopTooHighErrorE<gr2::MajumdarPapapetrouWeyl>>(spt,E,1e-10);
@@ -1896,11 +2408,11 @@ void Interface::numerical_expansions_mp(std::string text)
         gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // ========== initial conditions for second particle ==========
         gr2::real* y_ = y + 8;
@@ -1920,11 +2432,11 @@ void Interface::numerical_expansions_mp(std::string text)
         norm2 = (-1 + y_[gr2::Weyl::UT]*E - y_[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y_[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y_[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y_[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // calculate numerical expansions
         try
@@ -1938,6 +2450,8 @@ void Interface::numerical_expansions_mp(std::string text)
         {
             std::cerr << e.what() << '\n';
         }
+        if (this->print_statistics)
+            std::cout << "statistics: " << integrator.get_statistics().to_string() << std::endl;
         
         // TODO: save data
         std::cout << "Jdeme ukladat" << std::endl;
@@ -2022,7 +2536,13 @@ void Interface::trajectory_weyl(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        gr2::Integrator integrator(spt, "DoPr853", 1e-16, 1e-16, true);
+        gr2::real promotion = this->promotion_tolerance;
+        gr2::real tol = promotion > 0 ? promotion : 1e-16;
+        gr2::Integrator integrator(spt, "DoPr853", tol, tol);
+        integrator.enable_statistics(this->print_statistics);
+        // tighter tolerance while drift of E or L exceeds half of the limit
+        if (promotion > 0)
+            integrator.set_tolerance_promotion(ConservationDrift<gr2::Weyl>(spt, E, L), 0.5*1e-10, 1e-16, 1e-16, 0);
         auto data_monitor = std::make_shared<ConstantStepDataMonitoring<9>>(0, dt);
         integrator.add_event(data_monitor);
         auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
@@ -2057,11 +2577,11 @@ void Interface::trajectory_weyl(std::string text)
         gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // calculate trajectory
         try
@@ -2075,6 +2595,8 @@ void Interface::trajectory_weyl(std::string text)
         {
             std::cerr << e.what() << '\n';
         }
+        if (this->print_statistics)
+            std::cout << "statistics: " << integrator.get_statistics().to_string() << std::endl;
         
         // TODO: save data
         std::cout << "Jdeme ukladat" << std::endl;
@@ -2133,7 +2655,13 @@ void Interface::trajectory_mp(std::string text)
         if (!file.is_open())
             throw std::runtime_error("file " + file_name + "could not be opened");
 
-        gr2::Integrator integrator(spt, "DoPr853", 1e-16, 1e-16, true);
+        gr2::real promotion = this->promotion_tolerance;
+        gr2::real tol = promotion > 0 ? promotion : 1e-16;
+        gr2::Integrator integrator(spt, "DoPr853", tol, tol);
+        integrator.enable_statistics(this->print_statistics);
+        // tighter tolerance while drift of E or L exceeds half of the limit
+        if (promotion > 0)
+            integrator.set_tolerance_promotion(ConservationDrift<gr2::MajumdarPapapetrouWeyl>(spt, E, L), 0.5*1e-9, 1e-16, 1e-16, 0);
         auto data_monitor = std::make_shared<ConstantStepDataMonitoring<8>>(0, dt);
         integrator.add_event(data_monitor);
         auto too_close = std::make_shared<StopBeforeBlackHole>(0.4);
@@ -2164,11 +2692,11 @@ void Interface::trajectory_mp(std::string text)
         gr2::real norm2 = (-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L);
         if (norm2 < 0)
             return;
-        gr2::real norm = sqrtl(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        gr2::real norm = std::sqrt(norm2/spt->get_metric()[gr2::Weyl::RHO][gr2::Weyl::RHO]);
 
         // calculate velocity
         y[gr2::Weyl::URHO] = norm*u_rho_frac;
-        y[gr2::Weyl::UZ] = norm*sqrtl(1-u_rho_frac*u_rho_frac);
+        y[gr2::Weyl::UZ] = norm*std::sqrt(1-u_rho_frac*u_rho_frac);
 
         // calculate trajectory
         try
@@ -2182,6 +2710,8 @@ void Interface::trajectory_mp(std::string text)
         {
             std::cerr << e.what() << '\n';
         }
+        if (this->print_statistics)
+            std::cout << "statistics: " << integrator.get_statistics().to_string() << std::endl;
         
         // TODO: save data
         std::cout << "Jdeme ukladat" << std::endl;
@@ -2206,7 +2736,7 @@ void Interface::trajectory_mp(std::string text)
     }
 }
 
-Interface::Interface():macros(), values(), help_name(), help_text()
+Interface::Interface():macros(), values(), help_name(), help_text(), print_statistics(false), promotion_tolerance(0)
 {
     // load help
     std::ifstream file;
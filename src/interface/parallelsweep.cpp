@@ -0,0 +1,187 @@
+#include "interface/parallelsweep.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+void parallel_sweep(int n_tasks, int n_threads, std::function<SweepTask(int)> create_worker, std::ostream &out)
+{
+    if (n_tasks <= 0)
+        return;
+    if (n_threads <= 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    n_threads = std::min(n_threads, n_tasks);
+
+    // create workers (serially, before threads are started)
+    std::vector<SweepTask> workers;
+    for (int i = 0; i < n_threads; i++)
+        workers.push_back(create_worker(i));
+
+    // shared state
+    std::atomic<int> next_task(0);
+    std::atomic<bool> stop(false);
+    std::mutex output_mutex;
+    std::vector<std::string> results(n_tasks);
+    std::vector<bool> finished(n_tasks, false);
+    int next_written = 0;
+    std::exception_ptr error = nullptr;
+
+    auto run = [&](int thread)
+    {
+        int task;
+        while (!stop && (task = next_task++) < n_tasks)
+        {
+            SweepResult result;
+            try
+            {
+                result = workers[thread](task);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+                return;
+            }
+
+            // write finished prefix of tasks
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cout << result.log;
+            std::cout.flush();
+            results[task] = std::move(result.data);
+            finished[task] = true;
+            while (next_written < n_tasks && finished[next_written])
+            {
+                out << results[next_written];
+                std::string().swap(results[next_written]);
+                next_written++;
+            }
+            out.flush();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < n_threads; i++)
+        threads.emplace_back(run, i);
+    run(0);
+    for (auto &thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool parallel_map(int n_rows, int n_cols, int n_threads, std::function<MapPointTask(int)> create_worker, std::ostream &out, const std::atomic<bool> *cancel, MapProgress progress, int tile_size)
+{
+    if (n_rows <= 0 || n_cols <= 0)
+        return true;
+    if (tile_size <= 0)
+        throw std::invalid_argument("size of tile has to be positive");
+    int n_tile_rows = (n_rows + tile_size - 1)/tile_size;
+    int n_tile_cols = (n_cols + tile_size - 1)/tile_size;
+    int n_tiles = n_tile_rows*n_tile_cols;
+    if (n_threads <= 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    n_threads = std::min(n_threads, n_tiles);
+
+    // create workers (serially, before threads are started)
+    std::vector<MapPointTask> workers;
+    for (int i = 0; i < n_threads; i++)
+        workers.push_back(create_worker(i));
+
+    // shared state
+    std::atomic<int> next_tile(0);
+    std::atomic<bool> stop(false);
+    std::mutex output_mutex;
+    std::vector<std::vector<std::string>> results(n_tiles);
+    std::vector<int> finished(n_tile_rows, 0);
+    int next_written = 0;
+    long n_done = 0;
+    long n_points = (long)n_rows*n_cols;
+    std::exception_ptr error = nullptr;
+
+    auto cancelled = [&]()
+    {
+        return stop || (cancel && *cancel);
+    };
+
+    auto run = [&](int thread)
+    {
+        int tile;
+        while (!cancelled() && (tile = next_tile++) < n_tiles)
+        {
+            int row_begin = (tile/n_tile_cols)*tile_size;
+            int row_end = std::min(row_begin + tile_size, n_rows);
+            int col_begin = (tile%n_tile_cols)*tile_size;
+            int col_end = std::min(col_begin + tile_size, n_cols);
+
+            // evaluate tile (every row of tile has its own buffer)
+            std::vector<std::string> rows(row_end - row_begin);
+            try
+            {
+                for (int i = row_begin; i < row_end; i++)
+                    for (int j = col_begin; j < col_end; j++)
+                    {
+                        if (cancelled())
+                            return;
+                        rows[i - row_begin] += workers[thread](i, j);
+                    }
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+                return;
+            }
+
+            // write finished prefix of rows of tiles
+            std::lock_guard<std::mutex> lock(output_mutex);
+            results[tile] = std::move(rows);
+            finished[tile/n_tile_cols]++;
+            while (next_written < n_tile_rows && finished[next_written] == n_tile_cols)
+            {
+                int first = next_written*n_tile_cols;
+                for (std::size_t r = 0; r < results[first].size(); r++)
+                    for (int k = first; k < first + n_tile_cols; k++)
+                        out << results[k][r];
+                for (int k = first; k < first + n_tile_cols; k++)
+                    std::vector<std::string>().swap(results[k]);
+                next_written++;
+            }
+            out.flush();
+
+            n_done += (long)(row_end - row_begin)*(col_end - col_begin);
+            if (progress)
+                progress(n_done, n_points);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < n_threads; i++)
+        threads.emplace_back(run, i);
+    run(0);
+    for (auto &thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return next_written == n_tile_rows;
+}
+
+int number_of_threads(const std::string &text)
+{
+    if (text == "")
+        return 0;
+    int n = std::stoi(text);
+    if (n < 0)
+        throw std::invalid_argument("number of threads has to be non-negative");
+    return n;
+}
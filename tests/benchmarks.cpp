@@ -0,0 +1,323 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/mymath.hpp"
+#include "gravitacek2/geomotion/spacetimes.hpp"
+#include "gravitacek2/geomotion/reducedgeomotion.hpp"
+#include "gravitacek2/integrator/steppers.hpp"
+#include "gravitacek2/chaos/linearized_evolution.hpp"
+
+// ========== Settings of benchmarks ==========
+
+struct BenchmarkSettings
+{
+    int repetitions = 15;       // number of measured samples
+    double min_time = 0.02;     // minimal duration of one sample in seconds
+    std::string filter = "";    // only benchmarks containing this text are run
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    long iterations;            // calls in one sample
+    std::vector<double> ns;     // nanoseconds per call of each sample
+};
+
+// values are accumulated here, so calls cannot be optimized away
+volatile gr2::real sink = 0;
+
+// ========== Measurement ==========
+
+template<class F>
+double time_batch(F &func, const long &iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+        func(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template<class F>
+BenchmarkResult run_benchmark(const std::string &name, F func, const BenchmarkSettings &settings)
+{
+    BenchmarkResult result;
+    result.name = name;
+
+    // calibrate number of iterations (also warms up caches)
+    long iterations = 1;
+    while (time_batch(func, iterations) < settings.min_time)
+        iterations *= 2;
+    result.iterations = iterations;
+
+    // samples
+    for (int r = 0; r < settings.repetitions; r++)
+        result.ns.push_back(1e9*time_batch(func, iterations)/iterations);
+    return result;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    int n = values.size();
+    return n % 2 ? values[n/2] : 0.5*(values[n/2 - 1] + values[n/2]);
+}
+
+void write_json(std::ostream &out, const std::vector<BenchmarkResult> &results, const BenchmarkSettings &settings)
+{
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"precision\": \"" << (sizeof(gr2::real) == sizeof(double) ? "double" : "long double") << "\",\n";
+    out << "  \"repetitions\": " << settings.repetitions << ",\n";
+    out << "  \"min_time\": " << settings.min_time << ",\n";
+    out << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &res = results[i];
+        double med = median(res.ns);
+        double mean = 0, var = 0;
+        for (double x : res.ns)
+            mean += x/res.ns.size();
+        for (double x : res.ns)
+            var += (x - mean)*(x - mean)/std::max<std::size_t>(res.ns.size() - 1, 1);
+        std::vector<double> dev;
+        for (double x : res.ns)
+            dev.push_back(std::fabs(x - med));
+
+        out << (i ? ",\n" : "\n");
+        out << "    {\"name\": \"" << res.name << "\", ";
+        out << "\"iterations\": " << res.iterations << ", ";
+        out << "\"median_ns\": " << med << ", ";
+        out << "\"mad_ns\": " << median(dev) << ", ";
+        out << "\"mean_ns\": " << mean << ", ";
+        out << "\"stddev_ns\": " << std::sqrt(var) << ", ";
+        out << "\"min_ns\": " << *std::min_element(res.ns.begin(), res.ns.end()) << ", ";
+        out << "\"max_ns\": " << *std::max_element(res.ns.begin(), res.ns.end()) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// ========== Initial conditions ==========
+
+// several slightly different states, so that cached values are not reused
+const int STATES = 16;
+
+std::vector<gr2::real> weyl_state(const int &k)
+{
+    std::vector<gr2::real> y(9, 0);
+    y[gr2::Weyl::RHO] = 10 + 1e-3*k;
+    y[gr2::Weyl::Z] = 0.5;
+    y[gr2::Weyl::UT] = 1.190472574611857;
+    y[gr2::Weyl::UPHI] = 3.071259328415933e-02;
+    y[gr2::Weyl::URHO] = 0.1;
+    y[gr2::Weyl::UZ] = 0.1663404206336647;
+    return y;
+}
+
+std::vector<gr2::real> schwarzschild_state(const int &k)
+{
+    std::vector<gr2::real> y(8, 0);
+    y[gr2::Schwarzschild::R] = 10 + 1e-3*k;
+    y[gr2::Schwarzschild::THETA] = 1.2;
+    y[gr2::Schwarzschild::UT] = 1.19;
+    y[gr2::Schwarzschild::UR] = 0.1;
+    y[gr2::Schwarzschild::UTHETA] = 0.01;
+    y[gr2::Schwarzschild::UPHI] = 0.03;
+    return y;
+}
+
+// ========== Benchmarks ==========
+
+void benchmark_spacetime(std::vector<BenchmarkResult> &results, const BenchmarkSettings &settings,
+    const std::string &name, std::shared_ptr<gr2::GeoMotion> spt, const bool &weyl_like)
+{
+    int n = spt->get_n();
+    std::vector<std::vector<gr2::real>> ys;
+    for (int k = 0; k < STATES; k++)
+    {
+        ys.push_back(weyl_like ? weyl_state(k) : schwarzschild_state(k));
+        ys.back().resize(n, 0);
+    }
+    std::vector<gr2::real> dydt(n);
+
+    if ((name + "/function").find(settings.filter) != std::string::npos)
+        results.push_back(run_benchmark(name + "/function", [&](const long &i)
+        {
+            spt->function(0, ys[i % STATES].data(), dydt.data());
+            sink = sink + dydt[n-1];
+        }, settings));
+
+    if ((name + "/calculate_riemann_tensor").find(settings.filter) != std::string::npos)
+        results.push_back(run_benchmark(name + "/calculate_riemann_tensor", [&](const long &i)
+        {
+            spt->calculate_riemann_tensor(ys[i % STATES].data());
+            sink = sink + spt->get_riemann_tensor_data()[1];
+        }, settings));
+}
+
+void benchmark_stepper(std::vector<BenchmarkResult> &results, const BenchmarkSettings &settings,
+    const std::string &name, gr2::StepperBase &stepper, const bool &with_error)
+{
+    if (name.find(settings.filter) == std::string::npos)
+        return;
+
+    auto spt = std::make_shared<gr2::BachWeylRing>(1, 5);
+    stepper.set_OdeSystem(spt);
+    std::vector<std::vector<gr2::real>> ys;
+    for (int k = 0; k < STATES; k++)
+        ys.push_back(weyl_state(k));
+    std::vector<gr2::real> y(9), err(9);
+
+    results.push_back(run_benchmark(name, [&](const long &i)
+    {
+        y = ys[i % STATES];
+        if (with_error)
+            stepper.step_err(0, y.data(), 0.1, err.data());
+        else
+            stepper.step(0, y.data(), 0.1);
+        sink = sink + y[gr2::Weyl::RHO];
+    }, settings));
+}
+
+int main(int argc, char **argv)
+{
+    // ========== Arguments ==========
+    BenchmarkSettings settings;
+    std::string output = "";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: benchmarks [--filter text] [--repetitions n] [--min-time s] [--out file]" << std::endl;
+            return 1;
+        }
+        if (arg == "--filter")
+            settings.filter = argv[++i];
+        else if (arg == "--repetitions")
+            settings.repetitions = std::stoi(argv[++i]);
+        else if (arg == "--min-time")
+            settings.min_time = std::stod(argv[++i]);
+        else if (arg == "--out")
+            output = argv[++i];
+        else
+        {
+            std::cerr << "unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    auto selected = [&settings](const std::string &name) {return name.find(settings.filter) != std::string::npos;};
+
+    // ========== Space-times ==========
+    benchmark_spacetime(results, settings, "Schwarzschild", std::make_shared<gr2::Schwarzschild>(1), false);
+    benchmark_spacetime(results, settings, "WeylSchwarzschild", std::make_shared<gr2::WeylSchwarzschild>(1), true);
+    benchmark_spacetime(results, settings, "BachWeylRing", std::make_shared<gr2::BachWeylRing>(1, 5), true);
+    benchmark_spacetime(results, settings, "InvertedKuzminToomreDisk", std::make_shared<gr2::InvertedKuzminToomreDisk>(3, 1, 5), true);
+    benchmark_spacetime(results, settings, "InvertedMorganMorganDisk", std::make_shared<gr2::InvertedMorganMorganDisk>(3, 1, 5), true);
+    benchmark_spacetime(results, settings, "ReissnerNordstromMPW", std::make_shared<gr2::ReissnerNordstromMPW>(1), true);
+    benchmark_spacetime(results, settings, "MajumdarPapapetrouRing", std::make_shared<gr2::MajumdarPapapetrouRing>(1, 5), true);
+
+    // ========== Reduced geodesic motion ==========
+    if (selected("ReducedGeoMotion"))
+    {
+        auto spt = std::make_shared<gr2::BachWeylRing>(1, 5);
+        gr2::ReducedGeoMotion reduced(spt, 0.97, 3.7);
+        std::vector<std::vector<gr2::real>> ys;
+        for (int k = 0; k < STATES; k++)
+        {
+            std::vector<gr2::real> y = weyl_state(k);
+            ys.push_back(std::vector<gr2::real>(reduced.get_n()));
+            reduced.reduce(y.data(), ys.back().data());
+        }
+        std::vector<gr2::real> dydt(reduced.get_n());
+        results.push_back(run_benchmark("ReducedGeoMotion(BachWeylRing)/function", [&](const long &i)
+        {
+            reduced.function(0, ys[i % STATES].data(), dydt.data());
+            sink = sink + dydt[gr2::ReducedGeoMotion::UZ];
+        }, settings));
+    }
+
+    // ========== Steppers ==========
+    gr2::DoPr853 dopr853;
+    gr2::RK4 rk4;
+    benchmark_stepper(results, settings, "DoPr853/step_err", dopr853, true);
+    benchmark_stepper(results, settings, "RK4/step", rk4, false);
+
+    // ========== Special functions ==========
+    const int N = 20;
+    gr2::real p0[N], p1[N];
+    if (selected("elliptic_KE"))
+        results.push_back(run_benchmark("elliptic_KE", [&](const long &i)
+        {
+            gr2::real K, E;
+            gr2::elliptic_KE(0.3 + 0.01*(i % STATES), K, E);
+            sink = sink + K + E;
+        }, settings));
+    if (selected("legendre_polynomials1"))
+        results.push_back(run_benchmark("legendre_polynomials1/n=20", [&](const long &i)
+        {
+            gr2::legendre_polynomials1(0.27 + 0.01*(i % STATES), N, p0, p1);
+            sink = sink + p1[N-1];
+        }, settings));
+    if (selected("special_function_Q2n1"))
+        results.push_back(run_benchmark("special_function_Q2n1/n=20", [&](const long &i)
+        {
+            gr2::special_function_Q2n1(0.27 + 0.01*(i % STATES), N, p0, p1);
+            sink = sink + p1[N-1];
+        }, settings));
+    if (selected("romb"))
+        results.push_back(run_benchmark("romb<5>/sin", [&](const long &i)
+        {
+            sink = sink + gr2::romb<5>(static_cast<gr2::realfunction>(std::sin), 0, gr2::pi + 0.01*(i % STATES));
+        }, settings));
+
+    // ========== Chaos indicators ==========
+    gr2::WeylSchwarzschild chaos_spt(1);
+    std::vector<std::vector<gr2::real>> ys;
+    for (int k = 0; k < STATES; k++)
+    {
+        ys.push_back(weyl_state(k));
+        chaos_spt.calculate_lambda_init(ys.back().data());
+        ys.back()[gr2::Weyl::LAMBDA] = chaos_spt.get_lambda();
+    }
+    if (selected("matrix_H"))
+        results.push_back(run_benchmark("matrix_H", [&](const long &i)
+        {
+            gsl_matrix* H = gr2::matrix_H(&chaos_spt, ys[i % STATES].data());
+            sink = sink + gsl_matrix_get(H, 4, 0);
+            gsl_matrix_free(H);
+        }, settings));
+    if (selected("expected_growth"))
+        results.push_back(run_benchmark("expected_growth", [&](const long &i)
+        {
+            sink = sink + gr2::expected_growth(&chaos_spt, ys[i % STATES].data());
+        }, settings));
+    if (selected("max_norm_growth"))
+        results.push_back(run_benchmark("max_norm_growth", [&](const long &i)
+        {
+            sink = sink + gr2::max_norm_growth(&chaos_spt, ys[i % STATES].data());
+        }, settings));
+
+    // ========== Output ==========
+    if (output == "")
+        write_json(std::cout, results, settings);
+    else
+    {
+        std::ofstream file(output);
+        if (!file)
+            throw std::runtime_error("file " + output + " can not be opened");
+        write_json(file, results, settings);
+    }
+    return 0;
+}
@@ -1,9 +1,14 @@
 #include "gtest/gtest.h"
 #include "gravitacek2/setup.hpp"
 #include "gravitacek2/chaos/linearized_evolution.hpp"
+#include "gravitacek2/chaos/variational_equations.hpp"
+#include "gravitacek2/chaos/chaos_indicators.hpp"
+#include "gravitacek2/integrator/integrator.hpp"
+#include "gravitacek2/integrator/steppers.hpp"
 #include "gravitacek2/geomotion/spacetimes.hpp"
 
 #include <gsl/gsl_linalg.h>
+#include <gsl/gsl_eigen.h>
 
 TEST(MatrixOfLinearizedEvolution, WeylSchwarzschild)
 {
@@ -40,15 +45,125 @@ TEST(MatrixOfLinearizedEvolution, WeylSchwarzschild)
            EXPECT_NEAR(gsl_matrix_get(matrix, i, j), 0, eps);
            EXPECT_NEAR(gsl_matrix_get(matrix, i+4, j+4), 0, eps);
            value = (int)(i == j);
-           EXPECT_NEAR(gsl_matrix_get(matrix, i, j+4), value, eps + std::labs(value)*eps);
+           EXPECT_NEAR(gsl_matrix_get(matrix, i, j+4), value, eps + std::abs(value)*eps);
            value = H_test[i][j];
-           EXPECT_NEAR(gsl_matrix_get(matrix, i+4, j), value, eps + std::labs(value)*eps);
+           EXPECT_NEAR(gsl_matrix_get(matrix, i+4, j), value, eps + std::abs(value)*eps);
         }
 
     // delete
     gsl_matrix_free(matrix);
 }
 
+TEST(ExpectedGrowth, CompareWithGeneralEigensolver)
+{
+    gr2::real eps = 1e-10;
+    gr2::CombinedWeyl spt({std::make_shared<gr2::WeylSchwarzschild>(1.0), std::make_shared<gr2::BachWeylRing>(0.5, 20)});
+    gr2::real E = 0.977, L = 3.75;
+
+    for (gr2::real rho : {5.0, 10.0, 17.0, 25.0})
+        for (gr2::real z : {0.0, 0.5, 3.0})
+            for (gr2::real angle : {0.0, 0.4, 1.1})
+            {
+                // geodesic with given E and L
+                gr2::real y[9] = {};
+                y[gr2::Weyl::RHO] = rho;
+                y[gr2::Weyl::Z] = z;
+                spt.calculate_lambda_init(y);
+                y[gr2::Weyl::LAMBDA] = spt.get_lambda();
+                spt.calculate_metric(y);
+                gr2::real **g = spt.get_metric();
+                y[gr2::Weyl::UT] = -E/g[gr2::Weyl::T][gr2::Weyl::T];
+                y[gr2::Weyl::UPHI] = L/g[gr2::Weyl::PHI][gr2::Weyl::PHI];
+                gr2::real norm2 = -1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L;
+                gr2::real norm = std::sqrt(std::abs(norm2)/g[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+                y[gr2::Weyl::URHO] = norm*std::sin(angle);
+                y[gr2::Weyl::UZ] = norm*std::cos(angle);
+
+                // eigenvalues of the whole matrix H
+                gsl_matrix *H = gr2::matrix_H(&spt, y);
+                gsl_vector_complex *eig_vals = gsl_vector_complex_alloc(8);
+                gsl_eigen_nonsymm_workspace *work_space = gsl_eigen_nonsymm_alloc(8);
+                gsl_eigen_nonsymm(H, eig_vals, work_space);
+                gr2::real value = 0;
+                for (int i = 0; i < 8; i++)
+                    value = std::max(value, (gr2::real)GSL_REAL(gsl_vector_complex_get(eig_vals, i)));
+                gsl_matrix_free(H);
+                gsl_vector_complex_free(eig_vals);
+                gsl_eigen_nonsymm_free(work_space);
+
+                EXPECT_NEAR(gr2::expected_growth(&spt, y), value, eps*(1 + value)) << rho << " " << z << " " << angle;
+            }
+}
+
+TEST(MaxNormGrowth, CompareWithGeneralMatrices)
+{
+    gr2::real eps = 1e-12;
+    gr2::CombinedWeyl spt({std::make_shared<gr2::WeylSchwarzschild>(1.0), std::make_shared<gr2::BachWeylRing>(0.5, 20)});
+    gr2::real E = 0.977, L = 3.75;
+
+    // values obtained from 8x8 matrices and GSL eigensolver
+    gr2::real samples[4][4] = {
+        {5, 0.5, 1.1, 0.5070017114984627},
+        {10, 3, 0, 0.5007540842195801},
+        {17, 0.5, 4, 0.5005818088427897},
+        {25, 3, 1.1, 0.5001670332065202}
+    };
+
+    for (auto &sample : samples)
+    {
+        gr2::real y[9] = {};
+        y[gr2::Weyl::RHO] = sample[0];
+        y[gr2::Weyl::Z] = sample[1];
+        spt.calculate_lambda_init(y);
+        y[gr2::Weyl::LAMBDA] = spt.get_lambda();
+        spt.calculate_metric(y);
+        gr2::real **g = spt.get_metric();
+        y[gr2::Weyl::UT] = -E/g[gr2::Weyl::T][gr2::Weyl::T];
+        y[gr2::Weyl::UPHI] = L/g[gr2::Weyl::PHI][gr2::Weyl::PHI];
+        gr2::real norm = std::sqrt((-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L)/g[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+        y[gr2::Weyl::URHO] = norm*std::cos(sample[2]);
+        y[gr2::Weyl::UZ] = norm*std::sin(sample[2]);
+
+        EXPECT_NEAR(gr2::max_norm_growth(&spt, y), sample[3], eps) << sample[0] << " " << sample[1];
+    }
+}
+
+TEST(MaxNormGrowth, BatchOfVelocities)
+{
+    gr2::WeylSchwarzschild spt(1.0);
+    gr2::real E = 0.97, L = 4;
+    int n = 7;
+    gr2::real y[9] = {};
+    y[gr2::Weyl::RHO] = 12;
+    y[gr2::Weyl::Z] = 2;
+    spt.calculate_lambda_init(y);
+    y[gr2::Weyl::LAMBDA] = spt.get_lambda();
+    spt.calculate_metric(y);
+    gr2::real **g = spt.get_metric();
+    y[gr2::Weyl::UT] = -E/g[gr2::Weyl::T][gr2::Weyl::T];
+    y[gr2::Weyl::UPHI] = L/g[gr2::Weyl::PHI][gr2::Weyl::PHI];
+    gr2::real norm = std::sqrt((-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L)/g[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+
+    // all directions at once
+    gr2::real u[4*7], values[7];
+    for (int k = 0; k < n; k++)
+    {
+        u[4*k + gr2::Weyl::T] = y[gr2::Weyl::UT];
+        u[4*k + gr2::Weyl::PHI] = y[gr2::Weyl::UPHI];
+        u[4*k + gr2::Weyl::RHO] = norm*std::cos(gr2::real(k));
+        u[4*k + gr2::Weyl::Z] = norm*std::sin(gr2::real(k));
+    }
+    gr2::max_norm_growth(&spt, y, n, u, values);
+
+    // one direction after another
+    for (int k = 0; k < n; k++)
+    {
+        y[gr2::Weyl::URHO] = norm*std::cos(gr2::real(k));
+        y[gr2::Weyl::UZ] = norm*std::sin(gr2::real(k));
+        EXPECT_EQ(gr2::max_norm_growth(&spt, y), values[k]) << k;
+    }
+}
+
 // TEST(MatrixOfLinearizedEvolution, MathematicalCondition)
 // {
 //     gr2::real eps = 1e-10;
@@ -156,6 +271,310 @@ TEST(MatrixOfLinearizedEvolution, WeylSchwarzschild)
 //         EXPECT_NEAR(df[i], 0, eps);
 // }
 
+// orbit in Schwarzschild space-time (circular orbit with small kick)
+void schwarzschild_orbit(gr2::Schwarzschild &spt, gr2::real y[], gr2::real r=10, gr2::real ur=0.02, gr2::real utheta=0.01)
+{
+    y[gr2::Schwarzschild::R] = r;
+    y[gr2::Schwarzschild::THETA] = gr2::pi/2;
+    y[gr2::Schwarzschild::UR] = ur;
+    y[gr2::Schwarzschild::UTHETA] = utheta;
+    y[gr2::Schwarzschild::UPHI] = std::sqrt(1/(r-3))/r;
+    spt.calculate_metric(y);
+    gr2::real **g = spt.get_metric();
+    gr2::real sum = 0;
+    for (int i = 1; i < 4; i++)
+        sum += g[i][i]*y[i+4]*y[i+4];
+    y[gr2::Schwarzschild::UT] = std::sqrt((-1 - sum)/g[0][0]);
+}
+
+TEST(VariationalGeoMotion, CompareWithNearbyGeodesic)
+{
+    gr2::real eps = 1e-6, h = 0.05;
+    int steps = 2000;
+    auto spt = std::make_shared<gr2::Schwarzschild>(1.0);
+    auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, 1);
+    ASSERT_EQ(variational->get_n(), 16);
+
+    // geodesic, nearby geodesic and deviation vector
+    gr2::real y[8] = {}, y2[8], delta[8] = {0.1, 0.3, 0.02, -0.05, 0.01, -0.02, 0.003, 0.001};
+    schwarzschild_orbit(*spt, y);
+    for (int i = 0; i < 8; i++)
+        y2[i] = y[i] + eps*delta[i];
+
+    gr2::real yv[16];
+    for (int i = 0; i < 8; i++)
+        yv[i] = y[i];
+    gr2::real *xi = yv + variational->get_deviation_index(0), *eta = xi + 4;
+    spt->calculate_christoffel_symbols(y);
+    for (int mu = 0; mu < 4; mu++)
+    {
+        xi[mu] = delta[mu];
+        eta[mu] = delta[mu+4];
+        for (int alpha = 0; alpha < 4; alpha++)
+            for (int beta = 0; beta < 4; beta++)
+                eta[mu] += spt->get_christoffel_symbols()[mu][alpha][beta]*y[alpha+4]*delta[beta];
+    }
+
+    // integrate
+    gr2::RK4 stepper, stepper_variational;
+    stepper.set_OdeSystem(spt);
+    stepper_variational.set_OdeSystem(variational);
+    for (int i = 0; i < steps; i++)
+    {
+        stepper.step(i*h, y, h);
+        stepper.step(i*h, y2, h);
+        stepper_variational.step(i*h, yv, h);
+    }
+
+    // coordinate deviation and deviation of four-velocity
+    spt->calculate_christoffel_symbols(y);
+    for (int mu = 0; mu < 4; mu++)
+    {
+        gr2::real du = eta[mu];
+        for (int alpha = 0; alpha < 4; alpha++)
+            for (int beta = 0; beta < 4; beta++)
+                du -= spt->get_christoffel_symbols()[mu][alpha][beta]*y[alpha+4]*xi[beta];
+        EXPECT_NEAR(xi[mu], (y2[mu]-y[mu])/eps, 1e-4) << mu;
+        EXPECT_NEAR(du, (y2[mu+4]-y[mu+4])/eps, 1e-4) << mu;
+    }
+}
+
+TEST(VariationalGeoMotion, Orthonormalize)
+{
+    auto spt = std::make_shared<gr2::Schwarzschild>(1.0);
+    gr2::VariationalGeoMotion variational(spt, 3);
+    gr2::real y[8+3*8] = {}, log_norms[3] = {};
+    for (int i = 8; i < 8+3*8; i++)
+        y[i] = std::sin(gr2::real(i*i));
+
+    gr2::real norm2 = 0;
+    for (int i = 0; i < 8; i++)
+        norm2 += y[8+i]*y[8+i];
+    variational.orthonormalize(y, log_norms);
+
+    EXPECT_NEAR(log_norms[0], 0.5*std::log(norm2), 1e-15);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            gr2::real dot = 0;
+            for (int l = 0; l < 8; l++)
+                dot += y[variational.get_deviation_index(i)+l]*y[variational.get_deviation_index(j)+l];
+            EXPECT_NEAR(dot, i == j, 1e-15);
+        }
+    EXPECT_THROW(gr2::VariationalGeoMotion(spt, 0), std::invalid_argument);
+    EXPECT_THROW(gr2::VariationalGeoMotion(spt, 9), std::invalid_argument);
+}
+
+TEST(LyapunovSpectrum, RegularOrbitSchwarzschild)
+{
+    int k = 8;
+    auto spt = std::make_shared<gr2::Schwarzschild>(1.0);
+    auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, k);
+    gr2::real y[8+8*8] = {};
+    schwarzschild_orbit(*spt, y);
+    variational->init_deviations(y);
+
+    gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+    auto spectrum = std::make_shared<gr2::LyapunovSpectrum>(variational, 1.0);
+    integrator.add_event(spectrum);
+    integrator.integrate(y, 0, 2000, 0.1);
+
+    // exponents of regular orbit vanish, their sum is given by change of
+    // volume element, which is bounded
+    gr2::real exponents[8], sum = 0;
+    spectrum->get_exponents(exponents);
+    EXPECT_GT(spectrum->get_time(), 1990);
+    for (int i = 0; i < k; i++)
+    {
+        EXPECT_LT(std::abs(exponents[i]), 0.02) << i;
+        sum += exponents[i];
+    }
+    EXPECT_NEAR(sum, 0, 1e-2);
+}
+
+// renormalization of the second particle to fixed distance
+class RenormalizeSecondParticle : public gr2::Event
+{
+    public:
+        std::shared_ptr<gr2::GeoMotion> spt;
+        gr2::real d0, log_norm = 0, t_last = 0;
+        RenormalizeSecondParticle(std::shared_ptr<gr2::GeoMotion> spt, gr2::real d0) : gr2::Event(gr2::EventType::data), spt(spt), d0(d0) {}
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return 0;
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            int n = spt->get_n();
+            gr2::real norm2 = 0;
+            for (int i = 0; i < 8; i++)
+                norm2 += (y[n+i]-y[i])*(y[n+i]-y[i]);
+            gr2::real factor = d0/std::sqrt(norm2);
+            for (int i = 0; i < n; i++)
+                y[n+i] = y[i] + (y[n+i]-y[i])*factor;
+            spt->function(t, y+n, dydt+n);
+            log_norm -= std::log(factor);
+            t_last = t;
+        }
+};
+
+TEST(LyapunovSpectrum, CompareWithTwoParticlesWeyl)
+{
+    gr2::real E = 0.977, L = 3.75, t_max = 2000;
+    auto spt = std::make_shared<gr2::CombinedWeyl>(std::vector<std::shared_ptr<gr2::Weyl>>{std::make_shared<gr2::WeylSchwarzschild>(1), std::make_shared<gr2::BachWeylRing>(0.5, 20)});
+    int n = spt->get_n();
+    gr2::real y[64] = {};
+    y[gr2::Weyl::RHO] = 15;
+    y[gr2::Weyl::Z] = 1e-4;
+    spt->calculate_lambda_init(y);
+    if (n > 8)
+        y[gr2::Weyl::LAMBDA] = spt->get_lambda();
+    spt->calculate_metric(y);
+    gr2::real **g = spt->get_metric();
+    y[gr2::Weyl::UT] = -E/g[gr2::Weyl::T][gr2::Weyl::T];
+    y[gr2::Weyl::UPHI] = L/g[gr2::Weyl::PHI][gr2::Weyl::PHI];
+    gr2::real norm = std::sqrt((-1 + y[gr2::Weyl::UT]*E - y[gr2::Weyl::UPHI]*L)/g[gr2::Weyl::RHO][gr2::Weyl::RHO]);
+    y[gr2::Weyl::URHO] = norm*0.9;
+    y[gr2::Weyl::UZ] = norm*std::sqrt(1 - gr2::real(0.9)*gr2::real(0.9));
+
+    // largest exponent from variational equations
+    auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, 1);
+    variational->init_deviations(y);
+    gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+    auto spectrum = std::make_shared<gr2::LyapunovSpectrum>(variational, 1.0);
+    integrator.add_event(spectrum);
+    integrator.integrate(y, 0, t_max, 0.1);
+    gr2::real exponent;
+    spectrum->get_exponents(&exponent);
+
+    // largest exponent from two nearby particles (separated in the same direction)
+    gr2::real y2[18] = {};
+    for (int i = 0; i < n; i++)
+        y2[i] = y2[n+i] = y[i];
+    for (int i = 0; i < 8; i++)
+        y2[n+i] += 1e-9*y[variational->get_deviation_index(0)+i];
+    auto two_particles = std::make_shared<gr2::CombinedOdeSystem>(std::vector<std::shared_ptr<gr2::OdeSystem>>{spt, spt});
+    gr2::Integrator integrator2(two_particles, "DoPr853", 1e-14, 1e-14);
+    auto renormalization = std::make_shared<RenormalizeSecondParticle>(spt, 1e-9);
+    integrator2.add_event(renormalization);
+    integrator2.integrate(y2, 0, t_max, 0.1);
+    gr2::real exponent2 = renormalization->log_norm/renormalization->t_last;
+
+    EXPECT_GT(exponent, 1e-3);
+    EXPECT_NEAR(exponent, exponent2, 0.02*exponent2);
+}
+
+// variational equations with three deviation vectors and MEGNO
+std::shared_ptr<gr2::VariationalGeoMotion> indicators_setup(gr2::real y[], const gr2::real &r, const gr2::real &ur, const gr2::real &utheta)
+{
+    auto spt = std::make_shared<gr2::Schwarzschild>(1.0);
+    auto variational = std::make_shared<gr2::VariationalGeoMotion>(spt, 3, true);
+    schwarzschild_orbit(*spt, y, r, ur, utheta);
+    variational->init_deviations(y);
+    return variational;
+}
+
+TEST(ChaosIndicators, UnstableCircularOrbit)
+{
+    // unstable circular orbit (r < 6M) has positive Lyapunov exponent, so
+    // every indicator classifies it as chaotic and stops integration
+    for (int i = 0; i < 3; i++)
+    {
+        gr2::real y[8+3*8+2] = {};
+        auto variational = indicators_setup(y, 4.5, 0, 0);
+        std::shared_ptr<gr2::ChaosIndicator> indicator;
+        if (i == 0)
+            indicator = std::make_shared<gr2::MEGNO>(variational, 50);
+        else if (i == 1)
+            indicator = std::make_shared<gr2::FLI>(variational, 50, 20);
+        else
+            indicator = std::make_shared<gr2::SALI>(variational, 50, 1e-8);
+
+        gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+        integrator.add_event(indicator);
+        integrator.integrate(y, 0, 10000, 0.1);
+
+        EXPECT_EQ(indicator->get_orbit_class(), gr2::OrbitClass::chaotic) << i;
+        EXPECT_LT(indicator->get_time(), 500) << i;
+    }
+}
+
+TEST(ChaosIndicators, WeaklyChaoticOrbit)
+{
+    // mean MEGNO of unstable circular orbit close to ISCO grows slowly and
+    // passes through 2 at t ~ 21, the orbit must not be classified as
+    // regular there
+    gr2::real y[8+3*8+2] = {};
+    auto variational = indicators_setup(y, 5.9, 0, 0);
+    auto megno = std::make_shared<gr2::MEGNO>(variational, 15, 0.1);
+
+    gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+    integrator.add_event(megno);
+    integrator.integrate(y, 0, 10000, 0.1);
+
+    EXPECT_EQ(megno->get_orbit_class(), gr2::OrbitClass::chaotic);
+    EXPECT_GT(megno->get_time(), 100);
+    EXPECT_LT(megno->get_time(), 1000);
+}
+
+TEST(ChaosIndicators, RegularOrbit)
+{
+    gr2::real y[8+3*8+2] = {};
+    auto variational = indicators_setup(y, 10, 0.02, 0.01);
+    auto megno = std::make_shared<gr2::MEGNO>(variational, 1000, 0.3);
+
+    gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+    integrator.add_event(megno);
+    integrator.integrate(y, 0, 20000, 0.1);
+
+    // mean MEGNO converges to 2 and stops integration
+    EXPECT_EQ(megno->get_orbit_class(), gr2::OrbitClass::regular);
+    EXPECT_NEAR(megno->get_value(), 2, 0.3);
+    EXPECT_LT(megno->get_time(), 20000);
+    EXPECT_GE(megno->get_time(), 1000);
+
+    // indicators can be reused
+    megno->reset();
+    EXPECT_EQ(megno->get_orbit_class(), gr2::OrbitClass::undecided);
+    EXPECT_FALSE(megno->get_terminal());
+    EXPECT_THROW(gr2::MEGNO(std::make_shared<gr2::VariationalGeoMotion>(variational->get_spacetime(), 1), 0), std::invalid_argument);
+    EXPECT_THROW(gr2::MEGNO(variational, 0, 0.05, 5, true, 0.5), std::invalid_argument);
+    EXPECT_THROW(gr2::FLI(variational, 0, 20, 0, true, 2, 1), std::invalid_argument);
+    EXPECT_THROW(gr2::SALI(std::make_shared<gr2::VariationalGeoMotion>(variational->get_spacetime(), 1), 0), std::invalid_argument);
+}
+
+TEST(ChaosIndicators, RegularOrbitFLIAndSALI)
+{
+    // FLI grows as logarithm of time and SALI stays away from zero, both
+    // indicators classify the orbit as regular and stop integration
+    for (int i = 0; i < 2; i++)
+    {
+        gr2::real y[8+3*8+2] = {};
+        auto variational = indicators_setup(y, 10, 0.02, 0.01);
+        std::shared_ptr<gr2::ChaosIndicator> indicator;
+        if (i == 0)
+            indicator = std::make_shared<gr2::FLI>(variational, 1000, 20);
+        else
+            indicator = std::make_shared<gr2::SALI>(variational, 1000, 1e-8);
+
+        gr2::Integrator integrator(variational, "DoPr853", 1e-12, 1e-12);
+        integrator.add_event(indicator);
+        integrator.integrate(y, 0, 20000, 0.1);
+
+        EXPECT_EQ(indicator->get_orbit_class(), gr2::OrbitClass::regular) << i;
+        EXPECT_GE(indicator->get_time(), 1000) << i;
+        EXPECT_LT(indicator->get_time(), 20000) << i;
+        if (i == 0)
+            EXPECT_LT(indicator->get_value(), 20);
+        else
+            EXPECT_GT(indicator->get_value(), 1e-4);
+
+        indicator->reset();
+        EXPECT_EQ(indicator->get_orbit_class(), gr2::OrbitClass::undecided);
+        EXPECT_FALSE(indicator->get_terminal());
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,22 +1,25 @@
 #include "gtest/gtest.h"
 #include "gravitacek2/setup.hpp"
 #include "gravitacek2/integrator/integrator.hpp"
+#include "gravitacek2/integrator/batchintegrator.hpp"
 #include "gravitacek2/integrator/odesystems.hpp"
 
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <iostream>
 
 gr2::real exactDampedHarmonicOscillator(gr2::real t, gr2::real omega0, gr2::real xi, gr2::real x0, gr2::real v0)
 {
     // calculation of omega
-    gr2::real omega = sqrtl(omega0*omega0 - xi*xi);
+    gr2::real omega = std::sqrt(omega0*omega0 - xi*xi);
 
     // calculation of coefficients
     gr2::real A = (v0+xi*x0)/omega;
     gr2::real B = x0;
 
     // final value
-    return expl(-xi*t)*(A*sinl(omega*t) + B*cosl(omega*t));
+    return std::exp(-xi*t)*(A*std::sin(omega*t) + B*std::cos(omega*t));
 }
 
 class Bounce : public gr2::Event
@@ -93,6 +96,128 @@ public:
     };
 };
 
+class DenseOutputAtStepEnd : public gr2::Event
+{
+    public:
+        gr2::real mismatch = 0;
+        DenseOutputAtStepEnd() : gr2::Event(gr2::EventType::data, false, true) {};
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return 0;
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            mismatch = std::max(mismatch, std::abs(stepper->dense_out(0, t) - y[0]));
+        }
+};
+
+class PassSection : public gr2::Event
+{
+    public:
+        int crossings = 0;
+        PassSection() : gr2::Event(gr2::EventType::modyfing) {};
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return y[0];
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            crossings++;
+        }
+        virtual bool get_section(const gr2::real y[], int &index, gr2::real &value) override
+        {
+            index = 0;
+            value = 0;
+            return true;
+        }
+};
+
+class StopAfterTime : public gr2::Event
+{
+    protected:
+        gr2::real t_stop;
+    public:
+        StopAfterTime(gr2::real t_stop) : gr2::Event(gr2::EventType::data, true), t_stop(t_stop) {};
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return t >= t_stop ? 0 : 1;
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+        }
+};
+
+class StopOnCrossing : public gr2::Event
+{
+    public:
+        gr2::real t_event = 0;
+        StopOnCrossing() : gr2::Event(gr2::EventType::modyfing, true) {};
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return y[0];
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            t_event = t;
+        }
+};
+
+class StopOnSection : public StopOnCrossing
+{
+    public:
+        gr2::real x_event = 1;
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            t_event = t;
+            x_event = y[0];
+        }
+        virtual bool get_section(const gr2::real y[], int &index, gr2::real &value) override
+        {
+            index = 0;
+            value = 0;
+            return true;
+        }
+};
+
+class FallToCenter : public gr2::Event
+{
+    public:
+        FallToCenter() : gr2::Event(gr2::EventType::data, true) {};
+        virtual gr2::real value(const gr2::real &t, const gr2::real &dt, const gr2::real y[], const gr2::real dydt[]) override
+        {
+            return y[0] < 0.5 ? 0 : 1;
+        }
+        virtual void apply(gr2::StepperBase* stepper, gr2::real &t, gr2::real &dt, gr2::real y[], gr2::real dydt[]) override
+        {
+            y[0] = 0;
+        }
+};
+
+class LogarithmicSingularity : public gr2::OdeSystem
+{
+    public:
+        LogarithmicSingularity() : gr2::OdeSystem(2) {};
+        virtual void function(const gr2::real &t, const gr2::real y[], gr2::real dydt[]) override
+        {
+            if (y[0] <= 0)
+                throw std::domain_error("right side is not defined for x <= 0");
+            dydt[0] = -1;
+            dydt[1] = 1/y[0];
+        }
+};
+
+class InflectionCrossing : public gr2::OdeSystem
+{
+    public:
+        InflectionCrossing() : gr2::OdeSystem(2) {};
+        virtual void function(const gr2::real &t, const gr2::real y[], gr2::real dydt[]) override
+        {
+            // x = (s - 1)^3/3 crosses x = 0 with zero velocity at s = 1
+            dydt[0] = (y[1] - 1)*(y[1] - 1);
+            dydt[1] = 1;
+        }
+};
+
 TEST(Integrator, BouncingDumpedOscilatorNoStepController)
 {
     gr2::real omega0 = 2.0, xi = 0.5;
@@ -116,7 +241,7 @@ TEST(Integrator, BouncingDumpedOscilatorNoStepController)
     ASSERT_GE(data->times.size(), 10); // check if some data are recorded
     for (int i = 0; i < data->times.size(); i++)
     {
-        EXPECT_NEAR(data->pos[i], abs(exactDampedHarmonicOscillator(data->times[i], omega0, xi, x0, v0)), eps);
+        EXPECT_NEAR(data->pos[i], std::abs(exactDampedHarmonicOscillator(data->times[i], omega0, xi, x0, v0)), eps);
     }
 }
 
@@ -144,7 +269,7 @@ TEST(Integrator, BouncingDumberOscilatorStepController)
     ASSERT_GE(data->times.size(), 10); // check if some data are recorded
     for (int i = 0; i < data->times.size(); i++)
     {
-        EXPECT_NEAR(data->pos[i], abs(exactDampedHarmonicOscillator(data->times[i], omega0, xi, x0, v0)), eps);
+        EXPECT_NEAR(data->pos[i], std::abs(exactDampedHarmonicOscillator(data->times[i], omega0, xi, x0, v0)), eps);
     }
 }
 
@@ -181,6 +306,336 @@ TEST(Integrator, BouncingDumberOscilatorConstantStepData)
     }
 }
 
+TEST(Integrator, PromotionOfTolerance)
+{
+    gr2::real omega0 = 2.0, xi = 0;
+    gr2::real y0[] = {1.5, 0.5};
+    gr2::real t_end = 50;
+    gr2::real atol = 1e-6, rtol = 1e-6;
+    auto energy = [=](const gr2::real y[]) { return 0.5*(y[1]*y[1] + omega0*omega0*y[0]*y[0]); };
+    gr2::real E = energy(y0);
+
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+
+    // basic tolerance only
+    auto data = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator(osc, "DoPr853", atol, rtol);
+    integrator.add_event(data);
+    integrator.integrate(y0, 0, t_end, 0.01);
+    gr2::real y[] = {data->pos.back(), data->vel.back()};
+    gr2::real drift = std::abs(energy(y) - E);
+
+    // drift in one step is much smaller than the limit, so the tolerance is
+    // promoted only when the drift accumulates
+    gr2::real limit = 0.5*drift;
+    int steps_before = 0;
+    for (int i = 0; i < data->times.size(); i++)
+    {
+        gr2::real y_i[] = {data->pos[i], data->vel[i]};
+        if (std::abs(energy(y_i) - E) > limit)
+            break;
+        steps_before++;
+    }
+    ASSERT_GT(steps_before, 10);
+
+    // promotion of tolerance
+    auto data_promoted = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator_promoted(osc, "DoPr853", atol, rtol);
+    integrator_promoted.add_event(data_promoted);
+    integrator_promoted.set_tolerance_promotion(energy, limit, 1e-14, 1e-14);
+    integrator_promoted.integrate(y0, 0, t_end, 0.01);
+    gr2::real y_promoted[] = {data_promoted->pos.back(), data_promoted->vel.back()};
+    gr2::real drift_promoted = std::abs(energy(y_promoted) - E);
+
+    EXPECT_EQ(integrator_promoted.get_promotion_time(), data->times[steps_before-1]);
+    EXPECT_LE(drift_promoted, limit);
+    for (int i = 0; i < steps_before; i++)
+        EXPECT_EQ(data->pos[i], data_promoted->pos[i]);
+    for (int i = 1; i < data_promoted->times.size(); i++)
+        EXPECT_GT(data_promoted->times[i], data_promoted->times[i-1]);
+
+    // return to basic tolerance, drift of every accepted step is checked
+    auto data_demoted = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator_demoted(osc, "DoPr853", atol, rtol);
+    integrator_demoted.add_event(data_demoted);
+    integrator_demoted.set_tolerance_promotion(energy, limit, 1e-14, 1e-14, std::numeric_limits<gr2::real>::quiet_NaN(), 5);
+    integrator_demoted.enable_statistics();
+    integrator_demoted.integrate(y0, 0, t_end, 0.01);
+
+    EXPECT_EQ(integrator_demoted.get_promotion_time(), data->times[steps_before-1]);
+    EXPECT_GT(integrator_demoted.get_statistics().promotions, 1);
+    EXPECT_GE(data_demoted->times.back(), t_end);
+    for (int i = 0; i < data_demoted->times.size(); i++)
+    {
+        gr2::real y_i[] = {data_demoted->pos[i], data_demoted->vel[i]};
+        EXPECT_LE(std::abs(energy(y_i) - E), limit);
+    }
+
+    // reference value given by user (promotion right at the beginning, drift
+    // can not be kept under the limit)
+    gr2::Integrator integrator_reference(osc, "DoPr853", atol, rtol);
+    integrator_reference.set_tolerance_promotion(energy, limit, 1e-14, 1e-14, E + 2*limit);
+    gr2::real y_reference[] = {y0[0], y0[1]};
+    EXPECT_THROW(integrator_reference.integrate(y_reference, 0, t_end, 0.01), std::runtime_error);
+    EXPECT_EQ(integrator_reference.get_promotion_time(), 0);
+
+    // promotion is never triggered
+    auto data_unpromoted = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator_unpromoted(osc, "DoPr853", atol, rtol);
+    integrator_unpromoted.add_event(data_unpromoted);
+    integrator_unpromoted.set_tolerance_promotion(energy, 1e10, 1e-14, 1e-14);
+    integrator_unpromoted.integrate(y0, 0, t_end, 0.01);
+
+    EXPECT_TRUE(std::isnan(integrator_unpromoted.get_promotion_time()));
+    ASSERT_EQ(data->times.size(), data_unpromoted->times.size());
+    for (int i = 0; i < data->times.size(); i++)
+        EXPECT_EQ(data->pos[i], data_unpromoted->pos[i]);
+}
+
+TEST(Integrator, Statistics)
+{
+    gr2::real omega0 = 2.0, xi = 0.1;
+    gr2::real y0[] = {1.5, 0.5};
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+    auto counted = std::make_shared<gr2::CountingOdeSystem>(osc);
+
+    // integration without statistics
+    auto data = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator(osc, "DoPr853", 1e-12, 1e-12);
+    integrator.add_event(data);
+    integrator.integrate(y0, 0, 20, 0.5);
+    EXPECT_EQ(integrator.get_statistics().accepted_steps, 0);
+
+    // integration with statistics
+    auto data_stat = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator_stat(counted, "DoPr853", 1e-12, 1e-12);
+    integrator_stat.add_event(data_stat);
+    integrator_stat.enable_statistics();
+    integrator_stat.integrate(y0, 0, 20, 0.5);
+    const gr2::IntegratorStatistics &stat = integrator_stat.get_statistics();
+
+    EXPECT_EQ(stat.rhs_evaluations, counted->get_evaluations());
+    EXPECT_EQ(stat.accepted_steps, data_stat->times.size());
+    EXPECT_GT(stat.rejected_steps, 0);
+    EXPECT_EQ(stat.hadjust_iterations, stat.accepted_steps + stat.rejected_steps);
+    EXPECT_EQ(stat.events, 0);
+    EXPECT_GT(stat.h_min, 0);
+    EXPECT_LE(stat.h_min, stat.h_max);
+    EXPECT_GE(stat.time_total, stat.time_events);
+
+    // statistics do not change the solution
+    ASSERT_EQ(data->times.size(), data_stat->times.size());
+    for (int i = 0; i < data->times.size(); i++)
+        EXPECT_EQ(data->pos[i], data_stat->pos[i]);
+
+    // statistics are reset before integration
+    integrator_stat.integrate(y0, 0, 20, 0.5);
+    EXPECT_EQ(integrator_stat.get_statistics().accepted_steps, data_stat->times.size()/2);
+}
+
+TEST(Integrator, EventOnDenseOutput)
+{
+    gr2::real omega0 = 2.0, xi = 0.1;
+    gr2::real x0 = 1.5, v0 = 0.5;
+    gr2::real y0[] = {x0, v0};
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+
+    // exact time of the first crossing of x = 0
+    gr2::real omega = std::sqrt(omega0*omega0 - xi*xi);
+    gr2::real t_exact = (gr2::pi - std::atan2(x0*omega, v0 + xi*x0))/omega;
+
+    for (std::string stepper : {"DoPr853", "RK4"})
+    {
+        auto crossing = std::make_shared<StopOnCrossing>();
+        gr2::Integrator integrator(osc, stepper, 1e-12, 1e-12);
+        integrator.add_event(crossing);
+        integrator.enable_statistics();
+        integrator.integrate(y0, 0, 20, 0.5);
+        const gr2::IntegratorStatistics &stat = integrator.get_statistics();
+
+        EXPECT_NEAR(crossing->t_event, t_exact, 1e-9) << stepper;
+        EXPECT_EQ(stat.events, 1) << stepper;
+        EXPECT_GT(stat.event_iterations, 0) << stepper;
+        EXPECT_LE(stat.event_steps, 2) << stepper;
+    }
+}
+
+TEST(Integrator, EventOnSection)
+{
+    gr2::real omega0 = 2.0, xi = 0.1;
+    gr2::real x0 = 1.5, v0 = 0.5;
+    gr2::real y0[] = {x0, v0};
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+
+    // exact time of the first crossing of x = 0
+    gr2::real omega = std::sqrt(omega0*omega0 - xi*xi);
+    gr2::real t_exact = (gr2::pi - std::atan2(x0*omega, v0 + xi*x0))/omega;
+
+    for (std::string stepper : {"DoPr853", "RK4"})
+    {
+        auto section = std::make_shared<StopOnSection>();
+        gr2::Integrator integrator(osc, stepper, 1e-12, 1e-12);
+        integrator.add_event(section);
+        integrator.enable_statistics();
+        integrator.integrate(y0, 0, 20, 0.5);
+        const gr2::IntegratorStatistics &stat = integrator.get_statistics();
+
+        // hyperplane is reached exactly without root finding
+        EXPECT_NEAR(section->t_event, t_exact, 1e-9) << stepper;
+        EXPECT_EQ(section->x_event, 0) << stepper;
+        EXPECT_EQ(stat.events, 1) << stepper;
+        EXPECT_EQ(stat.event_iterations, 0) << stepper;
+    }
+}
+
+TEST(Integrator, DenseOutputAfterSection)
+{
+    // dense output after landing on hyperplane belongs to the landed step
+    // (not to the trial step, which was not checked by step controller),
+    // so it has to end at the landed state
+    gr2::real omega0 = 2.0, xi = 0.1;
+    gr2::real x0 = 1.5, v0 = -1.0;
+    gr2::real tol = 1e-4;
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+
+    for (std::string stepper : {"DoPr853", "RK4"})
+    {
+        gr2::real y0[] = {x0, v0};
+        auto section = std::make_shared<PassSection>();
+        auto data = std::make_shared<DenseOutputAtStepEnd>();
+        gr2::Integrator integrator(osc, stepper, tol, tol);
+        integrator.add_event(section);
+        integrator.add_event(data);
+        integrator.integrate(y0, 0, 3, 1.0);
+
+        EXPECT_GT(section->crossings, 0) << stepper;
+        EXPECT_LT(data->mismatch, 0.05*tol) << stepper;
+    }
+}
+
+TEST(Integrator, EventOnGrazingSection)
+{
+    // Hénon's step is singular, crossing has to be found on dense output
+    gr2::real y0[] = {-1.0/3, 0};
+    auto ode = std::make_shared<InflectionCrossing>();
+
+    for (std::string stepper : {"DoPr853", "RK4"})
+    {
+        auto section = std::make_shared<StopOnSection>();
+        gr2::Integrator integrator(ode, stepper, 1e-12, 1e-12);
+        integrator.add_event(section);
+        integrator.enable_statistics();
+        integrator.integrate(y0, 0, 5, 0.3);
+
+        EXPECT_TRUE(std::isfinite(section->t_event)) << stepper;
+        EXPECT_TRUE(std::isfinite(section->x_event)) << stepper;
+        EXPECT_NEAR(section->x_event, 0, 1e-8) << stepper;
+        EXPECT_NEAR(section->t_event, 1, 1e-2) << stepper;
+        EXPECT_GT(integrator.get_statistics().event_iterations, 0) << stepper;
+    }
+}
+
+TEST(BatchIntegrator, DumpedOscillators)
+{
+    gr2::real omega0 = 1.5, xi = 0.2;
+    const int lanes = 5;
+    gr2::real y[2*lanes];
+    for (int l = 0; l < lanes; l++)
+    {
+        y[2*l] = 0.5 + 0.3*l;
+        y[2*l+1] = 1.5 - 0.4*l;
+    }
+    gr2::real y0[2*lanes];
+    std::copy(y, y+2*lanes, y0);
+
+    gr2::real eps = 1e-9;
+    gr2::real t_start = 0, t_end = 10;
+    gr2::real h0 = 0.01;
+    gr2::real atol = 1e-12, rtol = 1e-12;
+
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+    gr2::BatchIntegrator integrator(osc, lanes, "DoPr853", atol, rtol);
+    auto stop = std::make_shared<StopAfterTime>(5);
+    integrator.add_event(lanes-1, stop);
+
+    integrator.integrate(y, t_start, t_end, h0);
+
+    for (int l = 0; l < lanes; l++)
+    {
+        gr2::real t = integrator.get_t(l);
+        if (l == lanes-1)
+        {
+            EXPECT_EQ(integrator.get_state(l), gr2::LaneState::terminated);
+            EXPECT_GE(t, 5);
+            EXPECT_LT(t, t_end);
+        }
+        else
+        {
+            EXPECT_EQ(integrator.get_state(l), gr2::LaneState::finished);
+            EXPECT_GE(t, t_end);
+        }
+        EXPECT_NEAR(y[2*l], exactDampedHarmonicOscillator(t, omega0, xi, y0[2*l], y0[2*l+1]), eps);
+    }
+}
+
+TEST(BatchIntegrator, SameAsIntegrator)
+{
+    gr2::real omega0 = 2.0, xi = 0.5;
+    gr2::real y[] = {1.5, 0.5};
+    gr2::real t_end = 10;
+
+    auto osc = std::make_shared<gr2::DampedHarmonicOscillator>(omega0, xi);
+    auto data = std::make_shared<DataMonitoring>();
+    gr2::Integrator integrator(osc, "DoPr853", 1e-10, 1e-10);
+    integrator.add_event(data);
+    integrator.integrate(y, 0, t_end, 0.01);
+
+    gr2::BatchIntegrator batch_integrator(osc, 1, "DoPr853", 1e-10, 1e-10);
+    auto batch_data = std::make_shared<DataMonitoring>();
+    batch_integrator.add_event(0, batch_data);
+    batch_integrator.integrate(y, 0, t_end, 0.01);
+
+    // error estimates of short steps are at the level of round-off errors, so
+    // step sizes differ by a multiple of machine epsilon
+    gr2::real eps = 1e8*std::numeric_limits<gr2::real>::epsilon();
+    ASSERT_EQ(data->times.size(), batch_data->times.size());
+    for (int i = 0; i < data->times.size(); i++)
+    {
+        EXPECT_NEAR(data->times[i], batch_data->times[i], eps);
+        EXPECT_NEAR(data->pos[i], batch_data->pos[i], eps);
+    }
+}
+
+TEST(BatchIntegrator, TerminatedLaneNotEvaluated)
+{
+    const int lanes = 4;
+    gr2::real y[2*lanes];
+    for (int l = 0; l < lanes; l++)
+    {
+        y[2*l] = 1 + 10*l;
+        y[2*l+1] = 0;
+    }
+    gr2::real t_end = 5;
+
+    auto ode = std::make_shared<LogarithmicSingularity>();
+    gr2::BatchIntegrator integrator(ode, lanes, "DoPr853", 1e-12, 1e-12);
+    integrator.add_event(0, std::make_shared<FallToCenter>());
+
+    // lane 0 stops in the singularity, other lanes continue
+    ASSERT_NO_THROW(integrator.integrate(y, 0, t_end, 0.01));
+
+    EXPECT_EQ(integrator.get_state(0), gr2::LaneState::terminated);
+    EXPECT_EQ(y[0], 0);
+    for (int l = 1; l < lanes; l++)
+    {
+        gr2::real x0 = 1 + 10*l;
+        gr2::real t = integrator.get_t(l);
+        EXPECT_EQ(integrator.get_state(l), gr2::LaneState::finished);
+        EXPECT_NEAR(y[2*l], x0 - t, 1e-10);
+        EXPECT_NEAR(y[2*l+1], std::log(x0/(x0 - t)), 1e-10);
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
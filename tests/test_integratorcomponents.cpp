@@ -11,14 +11,14 @@
 gr2::real exactDampedHarmonicOscillator(gr2::real t, gr2::real omega0, gr2::real xi, gr2::real x0, gr2::real v0)
 {
     // calculation of omega
-    gr2::real omega = sqrtl(omega0*omega0 - xi*xi);
+    gr2::real omega = std::sqrt(omega0*omega0 - xi*xi);
 
     // calculation of coefficients
     gr2::real A = (v0+xi*x0)/omega;
     gr2::real B = x0;
 
     // final value
-    return expl(-xi*t)*(A*sinl(omega*t) + B*cosl(omega*t));
+    return std::exp(-xi*t)*(A*std::sin(omega*t) + B*std::cos(omega*t));
 }
 
 class DampedHarmonicOscillator : public gr2::OdeSystem
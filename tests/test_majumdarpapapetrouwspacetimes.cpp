@@ -1,9 +1,11 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <limits>
 
 #include "gtest/gtest.h"
 #include "gravitacek2/setup.hpp"
+#include "gravitacek2/mymath.hpp"
 #include "gravitacek2/geomotion/spacetimes.hpp"
 
 class MPTestCase
@@ -32,25 +34,25 @@ public:
 
         // position
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf;%Lf;%Lf%*s", y, y+1, y+2, y+3);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", y, y+1, y+2, y+3);
         if (c != 4)
             throw std::runtime_error("Unable to read position from file " + filename);
 
         // inverse of lapse
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf%*s", &N_inv);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL "%*s", &N_inv);
         if (c != 1)
             throw std::runtime_error("Unable to read inverse of lapse function from file " + filename);
 
         // derivatives of inverse lapse
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf%*s", &N_inv_rho, &N_inv_z);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", &N_inv_rho, &N_inv_z);
         if (c != 2)
             throw std::runtime_error("Unable to read derivatives of inverse lapse from file " + filename);
 
         // second derivatives of inverse lapse
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf;%Lf%*s", &N_inv_rhorho, &N_inv_rhoz, &N_inv_zz);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", &N_inv_rhorho, &N_inv_rhoz, &N_inv_zz);
         if (c != 3)
             throw std::runtime_error("Unable to read second derivatives of lapse inverse from file " + filename);
 
@@ -105,6 +107,88 @@ TEST_P(GeneralMPTest, SecondDerivativesOfLapse)
     EXPECT_NEAR(spacetime->get_N_inv_zz(), N_inv_zz, eps + eps*std::abs(N_inv_zz));
 }
 
+TEST_P(GeneralMPTest, Clone)
+{
+    std::shared_ptr<gr2::MajumdarPapapetrouWeyl> spacetime(GetParam().spacetime->clone());
+    gr2::real eps = GetParam().eps;
+    gr2::real N_inv_rhorho = GetParam().N_inv_rhorho;
+    gr2::real N_inv_rhoz = GetParam().N_inv_rhoz;
+    gr2::real N_inv_zz = GetParam().N_inv_zz;
+    ASSERT_NE(spacetime.get(), GetParam().spacetime.get());
+    spacetime->calculate_N_inv2(GetParam().y);
+    EXPECT_NEAR(spacetime->get_N_inv_rhorho(), N_inv_rhorho, eps + eps*std::abs(N_inv_rhorho));
+    EXPECT_NEAR(spacetime->get_N_inv_rhoz(), N_inv_rhoz, eps + eps*std::abs(N_inv_rhoz));
+    EXPECT_NEAR(spacetime->get_N_inv_zz(), N_inv_zz, eps + eps*std::abs(N_inv_zz));
+}
+
+TEST(MajumdarPapapetrouRing, SecondDerivativesAgreeWithRichardson)
+{
+    gr2::MajumdarPapapetrouRing spacetime(0.3, 5);
+    gr2::real eps = 1e-9;
+
+    for (int i = 0; i < 10; i++)
+        for (int j = -5; j < 5; j++)
+        {
+            gr2::real rho = 0.35 + 1.031*i, z = 0.617*j + 0.0213;
+            auto N_inv_rho_func = [&spacetime, &z](gr2::real rho)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_N_inv1(y);
+                return spacetime.get_N_inv_rho();
+            };
+            auto N_inv_z_func_rho = [&spacetime, &z](gr2::real rho)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_N_inv1(y);
+                return spacetime.get_N_inv_z();
+            };
+            auto N_inv_z_func = [&spacetime, &rho](gr2::real z)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_N_inv1(y);
+                return spacetime.get_N_inv_z();
+            };
+            gr2::real N_inv_rhorho = gr2::richder<5>(N_inv_rho_func, rho, 0.1, 1e-10);
+            gr2::real N_inv_rhoz = gr2::richder<5>(N_inv_z_func_rho, rho, 0.1, 1e-10);
+            gr2::real N_inv_zz = gr2::richder<5>(N_inv_z_func, z, 0.1, 1e-10);
+
+            gr2::real y[] = {0, 0, rho, z};
+            spacetime.calculate_N_inv2(y);
+            EXPECT_NEAR(spacetime.get_N_inv_rhorho(), N_inv_rhorho, eps + eps*std::abs(N_inv_rhorho));
+            EXPECT_NEAR(spacetime.get_N_inv_rhoz(), N_inv_rhoz, eps + eps*std::abs(N_inv_rhoz));
+            EXPECT_NEAR(spacetime.get_N_inv_zz(), N_inv_zz, eps + eps*std::abs(N_inv_zz));
+        }
+}
+
+TEST(MajumdarPapapetrouWeyl, FunctionBatch)
+{
+    gr2::real eps = 1e3*std::numeric_limits<gr2::real>::epsilon();
+    gr2::MajumdarPapapetrouRing spacetime(0.3, 5);
+
+    // lanes with different positions and velocities
+    const int lanes = 3, n = 8;
+    gr2::real t[lanes] = {0, 1, 2};
+    gr2::real y[n*lanes], dydt[n*lanes], y_lane[n], dydt_lane[n];
+    for (int l = 0; l < lanes; l++)
+        for (int i = 0; i < n; i++)
+            y[i*lanes + l] = 0.1*(i + 1) + 0.05*l*i;
+    for (int l = 0; l < lanes; l++)
+    {
+        y[gr2::MajumdarPapapetrouWeyl::RHO*lanes + l] = 4 + 1.5*l;
+        y[gr2::MajumdarPapapetrouWeyl::Z*lanes + l] = 1 - 0.7*l;
+    }
+
+    spacetime.function_batch(lanes, t, y, dydt);
+    for (int l = 0; l < lanes; l++)
+    {
+        for (int i = 0; i < n; i++)
+            y_lane[i] = y[i*lanes + l];
+        spacetime.function(t[l], y_lane, dydt_lane);
+        for (int i = 0; i < n; i++)
+            EXPECT_NEAR(dydt[i*lanes + l], dydt_lane[i], eps + eps*std::abs(dydt_lane[i])) << "lane " << l << ", index " << i;
+    }
+}
+
 void PrintTo(const MPTestCase& testcase, std::ostream* os) {
     *os << "0";
 }
@@ -121,6 +205,7 @@ std::shared_ptr<gr2::CombinedMPW> rnmp = std::make_shared<gr2::CombinedMPW>(vec_
 auto test_cases = testing::Values(
     MPTestCase(std::make_shared<gr2::ReissnerNordstromMPW>(0.3), folder + "reissnernordstrom.txt", "ReissnerNordstrom", 1e-12),
     MPTestCase(std::make_shared<gr2::MajumdarPapapetrouRing>(0.3, 5), folder + "majumdarpapapetrouring.txt", "MajumdarPapapetrouRing", 1e-12),
+    MPTestCase(std::make_shared<gr2::MajumdarPapapetrouRing>(0.3, 5), folder + "majumdarpapapetrouring_axis.txt", "MajumdarPapapetrouRingAxis", 1e-12),
     MPTestCase(rnmp, folder + "rnmpr.txt", "ReissnerNordstromMajumdarPapapetrouRing", 1e-12)
 );
 
@@ -1,5 +1,7 @@
 #include "gravitacek2/mymath.hpp"
 
+#include <limits>
+
 #include "gtest/gtest.h"
 
 TEST(elliptic_KE, K)
@@ -75,7 +77,7 @@ TEST(elliptic_KE, E)
 TEST(romb5, IntegrateSinX)
 {
     gr2::real eps=1e-13;
-    EXPECT_NEAR(gr2::romb<5>(*sinl, 0, gr2::pi), 2, eps);
+    EXPECT_NEAR(gr2::romb<5>(static_cast<gr2::realfunction>(std::sin), 0, gr2::pi), 2, eps);
 }
 
 TEST(legendre_polynomials, Values)
@@ -211,13 +213,99 @@ TEST(special_function_Q2n, Derivatives)
 TEST(richder_5, DiffSinX)
 {
     gr2::real eps=1e-10;
-    EXPECT_NEAR(gr2::richder<5>(*sinl, 1, 0.1), cosl(1), eps);
+    EXPECT_NEAR(gr2::richder<5>(static_cast<gr2::realfunction>(std::sin), 1, 0.1), std::cos(gr2::real(1)), eps);
 }
 
 TEST(richder2_5, DiffSinX)
 {
     gr2::real eps=1e-10;
-    EXPECT_NEAR(gr2::richder2<5>(*sinl, 1, 0.1), -sinl(1), eps);
+    EXPECT_NEAR(gr2::richder2<5>(static_cast<gr2::realfunction>(std::sin), 1, 0.1), -std::sin(gr2::real(1)), eps);
+}
+
+TEST(eigenvalues_nonsymm4, KnownEigenvalues)
+{
+    gr2::real eps = 1e4*std::numeric_limits<gr2::real>::epsilon();
+
+    // block diagonal matrix with eigenvalues 2, -1 and 1 +- 3i hidden by
+    // similarity transformation with permutation and shear
+    gr2::real a[16] = {
+        2, 0, 0, 0,
+        0, 1, 3, 0,
+        0, -3, 1, 0,
+        0, 0, 0, -1
+    };
+    gr2::real b[16];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            b[i*4 + j] = a[((i+1)%4)*4 + (j+1)%4];
+    for (int j = 0; j < 4; j++)
+        b[3*4 + j] += 0.5*b[0*4 + j];
+    for (int i = 0; i < 4; i++)
+        b[i*4 + 0] -= 0.5*b[i*4 + 3];
+
+    gr2::real re[4], im[4];
+    gr2::eigenvalues_nonsymm4(b, re, im);
+
+    gr2::real expected_re[4] = {-1, 1, 1, 2}, expected_im[4] = {0, -3, 3, 0};
+    int order[4] = {0, 1, 2, 3};
+    std::sort(order, order + 4, [&](int i, int j){ return re[i] < re[j] || (re[i] == re[j] && im[i] < im[j]); });
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR(re[order[i]], expected_re[i], eps*10);
+        EXPECT_NEAR(im[order[i]], expected_im[i], eps*10);
+    }
+}
+
+TEST(eigenvalues_nonsymm4, RepeatedEigenvalues)
+{
+    gr2::real eps = 1e4*std::numeric_limits<gr2::real>::epsilon();
+
+    // eigenvalues -2, 1, 1, 0 (as for tidal matrix of a point mass) hidden by
+    // similarity transformation with shears
+    gr2::real b[16] = {
+        -2, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 0
+    };
+    for (int k = 0; k < 3; k++)
+    {
+        for (int j = 0; j < 4; j++)
+            b[(k+1)*4 + j] += 0.7*b[k*4 + j];
+        for (int i = 0; i < 4; i++)
+            b[i*4 + k] -= 0.7*b[i*4 + k+1];
+    }
+
+    gr2::real re[4], im[4];
+    gr2::eigenvalues_nonsymm4(b, re, im);
+
+    gr2::real expected_re[4] = {-2, 0, 1, 1};
+    std::sort(re, re + 4);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_NEAR(re[i], expected_re[i], eps*10);
+        EXPECT_NEAR(im[i], 0, eps*10);
+    }
+}
+
+TEST(eigenvalues_symm, CompareWithNonsymm)
+{
+    gr2::real eps = 1e4*std::numeric_limits<gr2::real>::epsilon();
+    const int n = 4;
+    gr2::real a[16], b[16], eig[4], re[4], im[4];
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            a[i*n + j] = a[j*n + i] = b[i*n + j] = b[j*n + i] = std::sin(gr2::real(1 + i + 3*j)) + (i == j)*i;
+
+    gr2::eigenvalues_symm(n, a, eig);
+    gr2::eigenvalues_nonsymm4(b, re, im);
+    std::sort(eig, eig + n);
+    std::sort(re, re + n);
+    for (int i = 0; i < n; i++)
+    {
+        EXPECT_NEAR(eig[i], re[i], eps);
+        EXPECT_NEAR(im[i], 0, eps);
+    }
 }
 
 int main(int argc, char **argv)
@@ -34,7 +34,7 @@ public:
 
         // position
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf;%Lf;%Lf%*s", y, y+1, y+2, y+3);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", y, y+1, y+2, y+3);
         if (c != 4)
             throw std::runtime_error("Unable to read position from file " + filename);
 
@@ -48,7 +48,7 @@ public:
                 break;
             if (file.eof())
                 throw std::runtime_error("File " + filename + "does not contain all information for the test");
-            c = sscanf(line.c_str(), "%d;%d;%Lf%*s", &i, &j, &value);
+            c = sscanf(line.c_str(), "%d;%d;%" GR2_SCN_REAL "%*s", &i, &j, &value);
             if (c != 3)
                 throw std::runtime_error("Unable to read metric component from file " + filename);
             this->metric[i][j] = value;
@@ -62,7 +62,7 @@ public:
                 break;
             if (file.eof())
                 throw std::runtime_error("File " + filename + "does not contain all information for the test");
-            c = sscanf(line.c_str(), "%d;%d;%d;%Lf%*s", &i, &j, &k, &value);
+            c = sscanf(line.c_str(), "%d;%d;%d;%" GR2_SCN_REAL "%*s", &i, &j, &k, &value);
             if (c != 4)
                 throw std::runtime_error("Unable to read Christoffel symbol component from file " + filename);
             this->christoffel_symbols[i][j][k] = value;
@@ -74,7 +74,7 @@ public:
             std::getline(file, line);
             if (line[0] == '=')
                 break;
-            c = sscanf(line.c_str(), "%d;%d;%d;%d;%Lf%*s", &i, &j, &k, &l, &value);
+            c = sscanf(line.c_str(), "%d;%d;%d;%d;%" GR2_SCN_REAL "%*s", &i, &j, &k, &l, &value);
             if (c != 5)
                 throw std::runtime_error("Unable to read Christoffel symbol component from file " + filename);
             this->riemann_tensor[i][j][k][l] = value;
@@ -134,6 +134,29 @@ TEST_P(GeneralSpacetimeTest, RiemannTensor)
                 }
 }
 
+TEST_P(GeneralSpacetimeTest, Function)
+{
+    std::shared_ptr<gr2::GeoMotion> spacetime = GetParam().spacetime;
+    gr2::real eps = GetParam().eps;
+    gr2::real y[9] = {}, dydt[9] = {};
+    gr2::real u[4] = {1.3, 0.2, -0.4, 0.7};
+    for (int i = 0; i < 4; i++)
+    {
+        y[i] = GetParam().y[i];
+        y[4+i] = u[i];
+    }
+    spacetime->function(0, y, dydt);
+    for (int i = 0; i < 4; i++)
+    {
+        gr2::real value = 0;
+        for (int j = 0; j < 4; j++)
+            for (int k = 0; k < 4; k++)
+                value += -GetParam().christoffel_symbols[i][j][k]*u[j]*u[k];
+        EXPECT_NEAR(dydt[i], u[i], eps);
+        EXPECT_NEAR(dydt[4+i], value, eps + std::abs(value)*eps*10);
+    }
+}
+
 void PrintTo(const SpacetimeTestCase& testcase, std::ostream* os) {
     *os << "0";
 }
@@ -9,6 +9,7 @@
 #include "gravitacek2/integrator/steppers.hpp"
 #include "gravitacek2/geomotion/geomotion.hpp"
 #include "gravitacek2/geomotion/spacetimes.hpp"
+#include "gravitacek2/geomotion/reducedgeomotion.hpp"
 
 class DataRecord : public gr2::Event
 {
@@ -81,7 +82,7 @@ TEST(SchwarzschildTrajectory, IntegralsOfMotionPlanar)
     spt->calculate_metric(y);
     gr2::real L = 3.6823981191047921;
     y[gr2::Schwarzschild::UPHI] = L/spt->get_metric()[gr2::Schwarzschild::PHI][gr2::Schwarzschild::PHI];
-    y[gr2::Schwarzschild::UT] = sqrtl((-1 - L*y[gr2::Schwarzschild::UPHI])/spt->get_metric()[gr2::Schwarzschild::T][gr2::Schwarzschild::T]);
+    y[gr2::Schwarzschild::UT] = std::sqrt((-1 - L*y[gr2::Schwarzschild::UPHI])/spt->get_metric()[gr2::Schwarzschild::T][gr2::Schwarzschild::T]);
     gr2::real E = -spt->get_metric()[gr2::Schwarzschild::T][gr2::Schwarzschild::T]*y[gr2::Schwarzschild::UT];
     ASSERT_NEAR(E, 0.9598686615055122147, 1e-15); // check if energy is correct
 
@@ -136,7 +137,7 @@ TEST(SchwarzschildTrajectory, IntegralsOfMotionGeneral)
     for (int j = 0; j < 4; j++)
         norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
     ASSERT_GT(-1-norm2, 0);
-    y[gr2::Schwarzschild::UTHETA] = sqrtl((-1-norm2)/spt->get_metric()[gr2::Schwarzschild::THETA][gr2::Schwarzschild::THETA]);
+    y[gr2::Schwarzschild::UTHETA] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::Schwarzschild::THETA][gr2::Schwarzschild::THETA]);
 
     // initial conditions - steps
     const gr2::real dt = 0.7;
@@ -171,13 +172,13 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionPlanar)
     gr2::real y[8]{};
 
     // initial conditions - position
-    y[gr2::Weyl::RHO] = sqrtl(16*14);
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
 
     // initial conditions - velocity
     spt->calculate_metric(y);
     gr2::real L = 3.6823981191047921;
     y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
-    y[gr2::Weyl::UT] = sqrtl((-1 - L*y[gr2::Weyl::UPHI])/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]);
+    y[gr2::Weyl::UT] = std::sqrt((-1 - L*y[gr2::Weyl::UPHI])/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]);
     gr2::real E = -spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]*y[gr2::Weyl::UT];
     ASSERT_NEAR(E, 0.9598686615055122147, 1e-15); // check if energy is correct
 
@@ -214,7 +215,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionGeneral)
     gr2::real y[8]{};
 
     // initial conditions - position
-    y[gr2::Weyl::RHO] = sqrtl(16*14);
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
 
     // initial conditions - velocity
     spt->calculate_metric(y);
@@ -228,7 +229,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionGeneral)
     for (int j = 0; j < 4; j++)
         norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
     ASSERT_GT(-1-norm2, 0);
-    y[gr2::Weyl::UZ] = sqrtl((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
+    y[gr2::Weyl::UZ] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
 
     // initial conditions - steps
     const gr2::real dt = 0.7;
@@ -261,7 +262,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionPlanarWithLambda)
     gr2::real y[9]{};
 
     // initial conditions - position
-    y[gr2::Weyl::RHO] = sqrtl(16*14);
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
     
     // lambda
     spt->calculate_lambda_init(y);
@@ -271,7 +272,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionPlanarWithLambda)
     spt->calculate_metric(y);
     gr2::real L = 3.6823981191047921;
     y[gr2::Weyl::UPHI] = L/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
-    y[gr2::Weyl::UT] = sqrtl((-1 - L*y[gr2::Weyl::UPHI])/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]);
+    y[gr2::Weyl::UT] = std::sqrt((-1 - L*y[gr2::Weyl::UPHI])/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]);
     gr2::real E = -spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]*y[gr2::Weyl::UT];
     ASSERT_NEAR(E, 0.9598686615055122147, 1e-15); // check if energy is correct
 
@@ -313,7 +314,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionGeneralWithLambda)
     gr2::real y[9]{};
 
     // initial conditions - position
-    y[gr2::Weyl::RHO] = sqrtl(16*14);
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
     
     // lambda
     spt->calculate_lambda_init(y);
@@ -331,7 +332,7 @@ TEST(WeylSchwarzschildTrajectory, IntegralsOfMotionGeneralWithLambda)
     for (int j = 0; j < 4; j++)
         norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
     ASSERT_GT(-1-norm2, 0);
-    y[gr2::Weyl::UZ] = sqrtl((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
+    y[gr2::Weyl::UZ] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
 
     // initial conditions - steps
     gr2::real dt = 0.2;
@@ -369,7 +370,7 @@ TEST(CombinedWeylSpacetime, IntegralsOfMotionGeneral)
     gr2::real y[9]{};
 
     // initial conditions - position
-    y[gr2::Weyl::RHO] = sqrtl(16*14);
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
     y[gr2::Weyl::Z] = 1e-5;
     
     // lambda
@@ -388,7 +389,7 @@ TEST(CombinedWeylSpacetime, IntegralsOfMotionGeneral)
     for (int j = 0; j < 4; j++)
         norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
     ASSERT_GT(-1-norm2, 0);
-    y[gr2::Weyl::UZ] = sqrtl((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
+    y[gr2::Weyl::UZ] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
 
     // initial conditions - steps
     gr2::real dt = 0.05;
@@ -430,8 +431,121 @@ TEST(CombinedWeylSpacetime, IntegralsOfMotionGeneral)
         EXPECT_NEAR(d, 0, 1e-7);
 }
 
+void compare_reduced_motion(std::shared_ptr<gr2::GeoMotion> spt, gr2::real y[], const gr2::real &eps)
+{
+    // reduced system with quadrature of t and phi
+    auto reduced = std::make_shared<gr2::ReducedGeoMotion>(spt, y, true);
+    int n = spt->get_n(), m = reduced->get_n();
+    ASSERT_EQ(m, n - 2);
+    std::vector<gr2::real> y_red(m), y_rec(n);
+    reduced->reduce(y, y_red.data());
+
+    // reconstruction of initial values
+    reduced->reconstruct(y_red.data(), y_rec.data());
+    for (int i = 0; i < n; i++)
+        EXPECT_NEAR(y_rec[i], y[i], eps);
+
+    gr2::DoPr853 stepper, stepper_red;
+    stepper.set_OdeSystem(spt);
+    stepper_red.set_OdeSystem(reduced);
+    gr2::real dt = 0.2;
+    for (int i = 0; i < 500; i++)
+    {
+        stepper.step(i*dt, y, dt);
+        stepper_red.step(i*dt, y_red.data(), dt);
+        reduced->reconstruct(y_red.data(), y_rec.data());
+        for (int j = 0; j < n; j++)
+            EXPECT_NEAR(y_rec[j], y[j], eps);
+
+        // integrals of motion are exact
+        spt->calculate_metric(y_rec.data());
+        EXPECT_NEAR(reduced->get_E(), -spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T]*y_rec[gr2::Weyl::UT], 1e-15);
+        EXPECT_NEAR(reduced->get_L(), spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI]*y_rec[gr2::Weyl::UPHI], 1e-15);
+    }
+}
+
+TEST(ReducedGeoMotion, WeylSchwarzschildWithLambda)
+{
+    auto spt = std::make_shared<gr2::WeylSchwarzschild>(1.0, gr2::exact, gr2::diff);
+    gr2::real y[9]{};
+
+    // initial conditions - position
+    y[gr2::Weyl::RHO] = std::sqrt(gr2::real(16*14));
+    y[gr2::Weyl::Z] = 0.5;
+    spt->calculate_lambda_init(y);
+    y[gr2::Weyl::LAMBDA] = spt->get_lambda();
+
+    // initial conditions - velocity
+    spt->calculate_metric(y);
+    y[gr2::Weyl::UPHI] = 3.6823981191047921/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+    y[gr2::Weyl::UT] = -0.97/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+    y[gr2::Weyl::URHO] = 0.05;
+    gr2::real norm2 = 0;
+    for (int j = 0; j < 3; j++)
+        norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
+    ASSERT_GT(-1-norm2, 0);
+    y[gr2::Weyl::UZ] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::Weyl::Z][gr2::Weyl::Z]);
+
+    compare_reduced_motion(spt, y, 1e-9);
+}
+
+TEST(ReducedGeoMotion, ReissnerNordstromMPW)
+{
+    auto spt = std::make_shared<gr2::ReissnerNordstromMPW>(1.0);
+    gr2::real y[8]{};
+
+    // initial conditions - position
+    y[gr2::MajumdarPapapetrouWeyl::RHO] = 15;
+    y[gr2::MajumdarPapapetrouWeyl::Z] = 0.5;
+
+    // initial conditions - velocity
+    spt->calculate_metric(y);
+    y[gr2::MajumdarPapapetrouWeyl::UPHI] = 0.016;
+    y[gr2::MajumdarPapapetrouWeyl::URHO] = 0.05;
+    y[gr2::MajumdarPapapetrouWeyl::UZ] = 0.01;
+    gr2::real norm2 = 0;
+    for (int j = 1; j < 4; j++)
+        norm2 += spt->get_metric()[j][j]*y[4+j]*y[4+j];
+    y[gr2::MajumdarPapapetrouWeyl::UT] = std::sqrt((-1-norm2)/spt->get_metric()[gr2::MajumdarPapapetrouWeyl::T][gr2::MajumdarPapapetrouWeyl::T]);
+
+    compare_reduced_motion(spt, y, 1e-9);
+}
+
+TEST(ReducedGeoMotion, InvalidSpacetime)
+{
+    EXPECT_THROW(gr2::ReducedGeoMotion(std::make_shared<gr2::Schwarzschild>(1.0), 0.97, 3.7), std::invalid_argument);
+}
+
+TEST(ReducedGeoMotion, SpacetimeUsedInOtherPoint)
+{
+    // spacetime evaluated in other point between two calls must not change
+    // the right-hand side (Christoffel symbols are cached)
+    auto spt = std::make_shared<gr2::WeylSchwarzschild>(1.0);
+    gr2::real y[9]{}, y_other[9]{};
+    y[gr2::Weyl::RHO] = 15;
+    y[gr2::Weyl::Z] = 0.5;
+    y[gr2::Weyl::URHO] = 0.05;
+    y[gr2::Weyl::UZ] = 0.01;
+    y_other[gr2::Weyl::RHO] = 6;
+    y_other[gr2::Weyl::Z] = 2;
+    spt->calculate_metric(y);
+    y[gr2::Weyl::UPHI] = 3.7/spt->get_metric()[gr2::Weyl::PHI][gr2::Weyl::PHI];
+    y[gr2::Weyl::UT] = -0.97/spt->get_metric()[gr2::Weyl::T][gr2::Weyl::T];
+
+    gr2::ReducedGeoMotion reduced(spt, y);
+    int m = reduced.get_n();
+    std::vector<gr2::real> y_red(m), dydt(m), dydt_other(m);
+    reduced.reduce(y, y_red.data());
+    reduced.function(0, y_red.data(), dydt.data());
+    reduced.function(0, y_red.data(), dydt.data()); // position of cache is saved
+    spt->calculate_metric(y_other);
+    reduced.function(0, y_red.data(), dydt_other.data());
+    for (int i = 0; i < m; i++)
+        EXPECT_EQ(dydt[i], dydt_other[i]);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
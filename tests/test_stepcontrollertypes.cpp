@@ -21,38 +21,39 @@ TEST(StepControllerValues, StandardStepController)
 
     gr2::real eps = 1e-3;
 
+    // desired error D = eps_abs + eps_rel*(a_y*|y| + a_dydt*|dydt|) = 2.2e-10
     gr2::StandardStepController stepcontroller = gr2::StandardStepController(n, k, eps_abs, eps_rel, a_y, a_dydt);
 
     // large error
-    err[0] = err[1] = 1e-4;
+    err[0] = err[1] = 2.2e-4;
     h_new = h_old; 
     test = stepcontroller.hadjust(y, err, dydt, h_new);
     EXPECT_FALSE(test);
     EXPECT_NEAR(h_new/h_old, 1.0/5, eps);
 
     // little bit larger error
-    err[0] = err[1] = 1.2e-10;
+    err[0] = err[1] = 2.64e-10;
     h_new = h_old;
     test = stepcontroller.hadjust(y, err, dydt, h_new);
     EXPECT_FALSE(test);
     EXPECT_NEAR(h_new/h_old, 0.907671, eps);
 
     // normal error 
-    err[0] = err[1] = 1e-10;
+    err[0] = err[1] = 2.2e-10;
     h_new = h_old;
     test = stepcontroller.hadjust(y, err, dydt, h_new);
     EXPECT_TRUE(test);
     EXPECT_NEAR(h_new/h_old, 1.0, eps);
 
     // little bit small error
-    err[0] = err[1] = 0.4e-10;
+    err[0] = err[1] = 0.88e-10;
     h_new = h_old;
     test = stepcontroller.hadjust(y, err, dydt, h_new);
     EXPECT_TRUE(test);
     EXPECT_NEAR(h_new/h_old, 1.14107, eps);
 
     // small error
-    err[0] = err[1] = 1e-15;
+    err[0] = err[1] = 2.2e-15;
     h_new = h_old;
     test = stepcontroller.hadjust(y, err, dydt, h_new);
     EXPECT_TRUE(test);
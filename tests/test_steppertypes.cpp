@@ -1,4 +1,5 @@
 #include <cmath>
+#include <limits>
 
 #include "gtest/gtest.h"
 #include "gravitacek2/integrator/odesystem.hpp"
@@ -9,14 +10,14 @@
 gr2::real exactDampedHarmonicOscillator(gr2::real t, gr2::real omega0, gr2::real xi, gr2::real x0, gr2::real v0)
 {
     // calculation of omega
-    gr2::real omega = sqrtl(omega0*omega0 - xi*xi);
+    gr2::real omega = std::sqrt(omega0*omega0 - xi*xi);
 
     // calculation of coefficients
     gr2::real A = (v0+xi*x0)/omega;
     gr2::real B = x0;
 
     // final value
-    return expl(-xi*t)*(A*sinl(omega*t) + B*cosl(omega*t));
+    return std::exp(-xi*t)*(A*std::sin(omega*t) + B*std::cos(omega*t));
 }
 
 class DampedHarmonicOscillator : public gr2::OdeSystem
@@ -39,6 +40,18 @@ class DampedHarmonicOscillator : public gr2::OdeSystem
         }
 };
 
+class TimePolynomial : public gr2::OdeSystem
+{
+    public:
+        TimePolynomial():gr2::OdeSystem(2) {}
+
+        virtual void function(const gr2::real &t, const gr2::real y[], gr2::real dydt[]) override
+        {
+            dydt[0] = t*t*t;
+            dydt[1] = 0;
+        }
+};
+
 void linear_regression(gr2::real x_data[], gr2::real y_data[], int N, gr2::real &a, gr2::real &b)
 {
     gr2::real sum_xy = 0, sum_x = 0, sum_y = 0, sum_x2 = 0;
@@ -99,14 +112,14 @@ TEST_P(GeneralStepperTest, OrderOfIntegrator)
     for (int i = 0; i < N; i++)
     {
         exp = min_exp + (max_exp-min_exp)/(N-1)*i;
-        h = powl(10, exp);
+        h = std::pow(10, exp);
         y[0] = x0;
         y[1] = v0;
 
         stepper->step(0, y, h);
-        err = fabs(y[0] - exactDampedHarmonicOscillator(h, omega0, xi, x0, v0));
+        err = std::abs(y[0] - exactDampedHarmonicOscillator(h, omega0, xi, x0, v0));
         x_data[i] = exp;
-        y_data[i] = log10(err);
+        y_data[i] = std::log10(err);
     }
     gr2::real order, bias;
     linear_regression(x_data, y_data, N, order, bias);
@@ -138,13 +151,13 @@ TEST_P(GeneralStepperTest, OrderOfError)
     for (int i = 0; i < N; i++)
     {
         exp = min_exp + (max_exp-min_exp)/(N-1)*i;
-        h = powl(10, exp);
+        h = std::pow(10, exp);
         y[0] = x0;
         y[1] = v0;
 
         stepper->step_err(0, y, h, error);
         x_data[i] = exp;
-        y_data[i] = log10(std::fabs(error[0]));
+        y_data[i] = std::log10(std::abs(error[0]));
     }
     gr2::real order, bias;
     linear_regression(x_data, y_data, N, order, bias);
@@ -175,6 +188,37 @@ TEST_P(GeneralStepperTest, Integration)
     }
 }
 
+// stages are evaluated at correct times (both steppers are exact for cubic
+// polynomial in t)
+TEST_P(GeneralStepperTest, TimeDependentSystem)
+{
+    gr2::real h = 0.25, t0 = 0.5;
+    gr2::real y[2]{t0*t0*t0*t0/4, 1}, err[2]{1, 1};
+
+    // ODE
+    auto ode = std::make_shared<TimePolynomial>();
+
+    // Stepper
+    auto stepper = GetParam().stepper;
+    stepper->set_OdeSystem(ode);
+
+    // test steps
+    for (int i = 0; i < 8; i++)
+    {
+        gr2::real t = t0 + i*h;
+        if (i%2)
+            stepper->step(t, y, h);
+        else
+        {
+            stepper->step_err(t, y, h, err);
+            EXPECT_EQ(err[1], 0);
+        }
+        t += h;
+        EXPECT_NEAR(y[0], t*t*t*t/4, 1e-15*t*t*t*t);
+        EXPECT_EQ(y[1], 1);
+    }
+}
+
 // correctness of the integration (with error)
 TEST_P(GeneralStepperTest, IntegrationWithError)
 {
@@ -252,6 +296,75 @@ TEST_P(GeneralStepperTest, DenseOutputWithError)
     }
 }
 
+TEST_P(GeneralStepperTest, DenseOutputAllCoordinates)
+{
+    // parameters and variables
+    gr2::real omega0 = 1.5, xi = 1.0;
+    gr2::real x0 = 0.5, v0 = 1.5;
+    gr2::real h = GetParam().h;
+    gr2::real y[2]{x0, v0}, err[2];
+
+    // ODE
+    auto osc = std::make_shared<DampedHarmonicOscillator>(omega0, xi);
+
+    // Stepper
+    auto stepper = GetParam().stepper;
+    stepper->set_OdeSystem(osc);
+
+    // dense output of all coordinates agrees with dense output of one coordinate
+    const int m = 5;
+    gr2::real ts[m], y_all[2], Y_data[m][2];
+    gr2::real *Y[m];
+    for (int k = 0; k < m; k++)
+        Y[k] = Y_data[k];
+    for (int i = 0; i < 3; i++)
+    {
+        stepper->step_err(i*h, y, h, err, true);
+        stepper->prepare_dense();
+        for (int k = 0; k < m; k++)
+            ts[k] = h*(i + k/(m-1.0));
+        stepper->dense_out_many(m, ts, Y);
+        for (int k = 0; k < m; k++)
+        {
+            stepper->dense_out_all(ts[k], y_all);
+            for (int j = 0; j < 2; j++)
+            {
+                EXPECT_DOUBLE_EQ(y_all[j], stepper->dense_out(j, ts[k]));
+                EXPECT_DOUBLE_EQ(Y[k][j], stepper->dense_out(j, ts[k]));
+            }
+        }
+    }
+}
+
+TEST_P(GeneralStepperTest, LazyDenseOutput)
+{
+    // parameters and variables
+    gr2::real omega0 = 1.5, xi = 1.0;
+    gr2::real x0 = 0.5, v0 = 1.5;
+    gr2::real h = GetParam().h;
+    gr2::real y[2]{x0, v0}, err[2];
+
+    // ODE
+    auto osc = std::make_shared<gr2::CountingOdeSystem>(std::make_shared<DampedHarmonicOscillator>(omega0, xi));
+
+    // Stepper
+    auto stepper = GetParam().stepper;
+    stepper->set_OdeSystem(osc);
+
+    // dense output is prepared only once on the first request
+    for (int i = 0; i < 3; i++)
+    {
+        stepper->step_err(i*h, y, h, err, true);
+        long evaluations = osc->get_evaluations();
+        ASSERT_NEAR(stepper->dense_out(0, h*(i+0.5)), exactDampedHarmonicOscillator(h*(i+0.5), omega0, xi, x0, v0), GetParam().eps_integration);
+        long evaluations_dense = osc->get_evaluations();
+        EXPECT_LE(evaluations_dense - evaluations, 3);
+        stepper->prepare_dense();
+        ASSERT_NEAR(stepper->dense_out(0, h*(i+1)), exactDampedHarmonicOscillator(h*(i+1), omega0, xi, x0, v0), GetParam().eps_integration);
+        EXPECT_EQ(osc->get_evaluations(), evaluations_dense);
+    }
+}
+
 void PrintTo(const StepperTestCase& testcase, std::ostream* os) {
     *os << "0";
 }
@@ -260,9 +373,16 @@ std::string MyTestNameGenerator(const ::testing::TestParamInfo<StepperTestCase>&
     return info.param.name;
 };
 
+// smallest exponent of step size for which error of the step is still well
+// above round-off errors
+gr2::real min_step_exp(const gr2::real &min_exp, const int &order)
+{
+    return std::max(min_exp, (std::log10(std::numeric_limits<gr2::real>::epsilon()) + 3.5)/(order + 1));
+}
+
 auto test_cases = testing::Values(
-    StepperTestCase("RK4", std::make_shared<gr2::RK4>(), -3, -1, 1e-7, 0.25, 0.002),
-    StepperTestCase("DoPr853", std::make_shared<gr2::DoPr853>(), -1, 1, 1e-7, 0.6, 0.01)
+    StepperTestCase("RK4", std::make_shared<gr2::RK4>(), min_step_exp(-3, 4), -1, 1e-7, 0.25, 0.002),
+    StepperTestCase("DoPr853", std::make_shared<gr2::DoPr853>(), min_step_exp(-1, 8), 1, 1e-7, 0.6, 0.01)
 );
 
 INSTANTIATE_TEST_SUITE_P(
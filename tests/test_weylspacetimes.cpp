@@ -1,9 +1,12 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <limits>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "gravitacek2/setup.hpp"
+#include "gravitacek2/mymath.hpp"
 #include "gravitacek2/geomotion/spacetimes.hpp"
 
 class WeylTestCase
@@ -33,31 +36,31 @@ public:
 
         // position
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf;%Lf;%Lf%*s", y, y+1, y+2, y+3);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", y, y+1, y+2, y+3);
         if (c != 4)
             throw std::runtime_error("Unable to read position from file " + filename);
 
         // potential
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf%*s", &nu);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL "%*s", &nu);
         if (c != 1)
             throw std::runtime_error("Unable to read potential from file " + filename);
 
         // derivatives of potential 
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf%*s", &nu_rho, &nu_z);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", &nu_rho, &nu_z);
         if (c != 2)
             throw std::runtime_error("Unable to read derivatives of potential from file " + filename);
 
         // second derivatives of potential
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf;%Lf;%Lf%*s", &nu_rhorho, &nu_rhoz, &nu_zz);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", &nu_rhorho, &nu_rhoz, &nu_zz);
         if (c != 3)
             throw std::runtime_error("Unable to read second derivatives of potential from file " + filename);
 
         // lambda
         std::getline(file, line);
-        c = sscanf(line.c_str(), "%Lf%*s", &lambda);
+        c = sscanf(line.c_str(), "%" GR2_SCN_REAL "%*s", &lambda);
         if (c != 1)
             throw std::runtime_error("Unable to read lambda from file " + filename);
 
@@ -118,7 +121,189 @@ TEST_P(GeneralWeylTest, Lambda)
     gr2::real eps = GetParam().eps;
     gr2::real lambda =  GetParam().lambda;
     spacetime->calculate_lambda_init(GetParam().y);
-    EXPECT_NEAR(spacetime->get_lambda(), lambda, eps + eps*std::labs(lambda));
+    EXPECT_NEAR(spacetime->get_lambda(), lambda, eps + eps*std::abs(lambda));
+}
+
+TEST_P(GeneralWeylTest, Clone)
+{
+    std::shared_ptr<gr2::Weyl> spacetime(GetParam().spacetime->clone());
+    gr2::real eps = GetParam().eps;
+    gr2::real nu_rhorho =  GetParam().nu_rhorho;
+    gr2::real nu_rhoz =  GetParam().nu_rhoz;
+    gr2::real nu_zz =  GetParam().nu_zz;
+    gr2::real lambda =  GetParam().lambda;
+    ASSERT_NE(spacetime.get(), GetParam().spacetime.get());
+    spacetime->calculate_nu2(GetParam().y);
+    EXPECT_NEAR(spacetime->get_nu_rhorho(), nu_rhorho, eps + eps*std::abs(nu_rhorho));
+    EXPECT_NEAR(spacetime->get_nu_rhoz(), nu_rhoz, eps + eps*std::abs(nu_rhoz));
+    EXPECT_NEAR(spacetime->get_nu_zz(), nu_zz, eps + eps*std::abs(nu_zz));
+    spacetime->calculate_lambda_init(GetParam().y);
+    EXPECT_NEAR(spacetime->get_lambda(), lambda, eps + eps*std::abs(lambda));
+    EXPECT_EQ(spacetime->get_n(), GetParam().spacetime->get_n());
+}
+
+TEST(Weyl, EvaluateCache)
+{
+    gr2::BachWeylRing spacetime(0.3, 5);
+    gr2::real y[] = {0, 0, 3.5, 1.25};
+    gr2::real y_other[] = {0, 0, 7, -2};
+
+    spacetime.calculate_nu2(y);
+    gr2::real nu = spacetime.get_nu(), nu_z = spacetime.get_nu_z(), nu_rhoz = spacetime.get_nu_rhoz();
+
+    // values are served from cache even if members were overwritten
+    spacetime.evaluate(y, 2);
+    spacetime.calculate_nu1(y_other);
+    spacetime.evaluate(y, 1);
+    EXPECT_EQ(spacetime.get_nu(), nu);
+    EXPECT_EQ(spacetime.get_nu_z(), nu_z);
+    spacetime.evaluate(y, 0);
+    EXPECT_EQ(spacetime.get_nu_rhoz(), nu_rhoz);
+
+    // different position
+    spacetime.evaluate(y_other, 0);
+    EXPECT_NE(spacetime.get_nu(), nu);
+}
+
+TEST(Weyl, FunctionBatch)
+{
+    gr2::real eps = 1e3*std::numeric_limits<gr2::real>::epsilon();
+    std::vector<std::shared_ptr<gr2::Weyl>> spacetimes = {
+        std::make_shared<gr2::WeylSchwarzschild>(1, gr2::LambdaEvaluation::exact, gr2::LambdaEvaluation::exact),
+        std::make_shared<gr2::BachWeylRing>(0.3, 5)
+    };
+
+    for (auto &spacetime : spacetimes)
+    {
+        // lanes with different positions and velocities
+        const int lanes = 3;
+        int n = spacetime->get_n();
+        gr2::real t[lanes] = {0, 1, 2};
+        std::vector<gr2::real> y(n*lanes), dydt(n*lanes), y_lane(n), dydt_lane(n);
+        for (int l = 0; l < lanes; l++)
+            for (int i = 0; i < n; i++)
+                y[i*lanes + l] = 0.1*(i + 1) + 0.05*l*i;
+        for (int l = 0; l < lanes; l++)
+        {
+            y[gr2::Weyl::RHO*lanes + l] = 4 + 1.5*l;
+            y[gr2::Weyl::Z*lanes + l] = 1 - 0.7*l;
+        }
+
+        spacetime->function_batch(lanes, t, y.data(), dydt.data());
+        for (int l = 0; l < lanes; l++)
+        {
+            for (int i = 0; i < n; i++)
+                y_lane[i] = y[i*lanes + l];
+            spacetime->function(t[l], y_lane.data(), dydt_lane.data());
+            for (int i = 0; i < n; i++)
+                EXPECT_NEAR(dydt[i*lanes + l], dydt_lane[i], eps + eps*std::abs(dydt_lane[i])) << "lane " << l << ", index " << i;
+        }
+    }
+}
+
+TEST(WeylSchwarzschild, SecondDerivativesAgreeWithRichardson)
+{
+    gr2::WeylSchwarzschild spacetime(0.7);
+    gr2::real eps = 1e-9;
+
+    for (int i = 0; i < 10; i++)
+        for (int j = -5; j < 5; j++)
+        {
+            gr2::real rho = 0.15 + 0.731*i, z = 0.617*j + 0.0213;
+            auto nu_rho_func = [&spacetime, &z](gr2::real rho)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_nu1(y);
+                return spacetime.get_nu_rho();
+            };
+            auto nu_z_func_rho = [&spacetime, &z](gr2::real rho)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_nu1(y);
+                return spacetime.get_nu_z();
+            };
+            auto nu_z_func = [&spacetime, &rho](gr2::real z)
+            {
+                gr2::real y[] = {0, 0, rho, z};
+                spacetime.calculate_nu1(y);
+                return spacetime.get_nu_z();
+            };
+            gr2::real nu_rhorho = gr2::richder<5>(nu_rho_func, rho, 0.1, 1e-10);
+            gr2::real nu_rhoz = gr2::richder<5>(nu_z_func_rho, rho, 0.1, 1e-10);
+            gr2::real nu_zz = gr2::richder<5>(nu_z_func, z, 0.1, 1e-10);
+
+            gr2::real y[] = {0, 0, rho, z};
+            spacetime.calculate_nu2(y);
+            EXPECT_NEAR(spacetime.get_nu_rhorho(), nu_rhorho, eps + eps*std::abs(nu_rhorho));
+            EXPECT_NEAR(spacetime.get_nu_rhoz(), nu_rhoz, eps + eps*std::abs(nu_rhoz));
+            EXPECT_NEAR(spacetime.get_nu_zz(), nu_zz, eps + eps*std::abs(nu_zz));
+        }
+}
+
+TEST(SurrogateWeyl, AgreesWithSource)
+{
+    gr2::real tol = 1e-9;
+    auto source = std::make_shared<gr2::InvertedKuzminToomreDisk>(1, 0.3, 5);
+    auto surrogate = std::make_shared<gr2::SurrogateWeyl>(source, 0.5, 15, 10, tol);
+    std::shared_ptr<gr2::Weyl> clone(surrogate->clone());
+    EXPECT_LE(surrogate->get_sampled_error(), tol);
+
+    for (int i = 0; i < 40; i++)
+        for (int j = -20; j < 20; j++)
+        {
+            gr2::real y[] = {0, 0, 0.6 + 0.3587*i, 0.4931*j + 0.0123};
+            source->calculate_nu2(y);
+            surrogate->calculate_nu2(y);
+            EXPECT_NEAR(surrogate->get_nu(), source->get_nu(), 10*tol);
+            EXPECT_NEAR(surrogate->get_nu_rho(), source->get_nu_rho(), 10*tol);
+            EXPECT_NEAR(surrogate->get_nu_z(), source->get_nu_z(), 10*tol);
+            EXPECT_NEAR(surrogate->get_nu_rhorho(), source->get_nu_rhorho(), 1e-5);
+            EXPECT_NEAR(surrogate->get_nu_rhoz(), source->get_nu_rhoz(), 1e-5);
+            EXPECT_NEAR(surrogate->get_nu_zz(), source->get_nu_zz(), 1e-5);
+
+            clone->calculate_nu2(y);
+            EXPECT_EQ(clone->get_nu_rhoz(), surrogate->get_nu_rhoz());
+        }
+
+    // outside of the region source is used
+    gr2::real y[] = {0, 0, 20, 3};
+    source->calculate_nu2(y);
+    surrogate->calculate_nu2(y);
+    EXPECT_EQ(surrogate->get_nu(), source->get_nu());
+    EXPECT_EQ(surrogate->get_nu_zz(), source->get_nu_zz());
+}
+
+// Curzon particle shifted from equatorial plane
+class ShiftedCurzon : public gr2::Weyl
+{
+public:
+    gr2::real z0;
+    ShiftedCurzon(gr2::real z0) : gr2::Weyl(gr2::LambdaEvaluation::custom, gr2::LambdaEvaluation::diff), z0(z0) {};
+    virtual ShiftedCurzon* clone() const override { return new ShiftedCurzon(z0); };
+    virtual void calculate_lambda_init(const gr2::real* y) override { lambda = 0; };
+    virtual void calculate_lambda_run(const gr2::real* y) override { calculate_lambda_diff(y); };
+    virtual void calculate_nu(const gr2::real* y) override
+    {
+        nu = -1/std::hypot(y[RHO], y[Z] - z0);
+    };
+    virtual void calculate_nu1(const gr2::real* y) override
+    {
+        gr2::real r = std::hypot(y[RHO], y[Z] - z0);
+        nu = -1/r;
+        nu_rho = y[RHO]/(r*r*r);
+        nu_z = (y[Z] - z0)/(r*r*r);
+    };
+    virtual void calculate_nu2(const gr2::real* y) override
+    {
+        calculate_nu1(y);
+        nu_rhorho = nu_rhoz = nu_zz = 0;
+    };
+};
+
+TEST(SurrogateWeyl, AsymmetricSource)
+{
+    EXPECT_THROW(gr2::SurrogateWeyl(std::make_shared<ShiftedCurzon>(0.5), 0.5, 15, 10, 1e-9), std::invalid_argument);
+    EXPECT_NO_THROW(gr2::SurrogateWeyl(std::make_shared<ShiftedCurzon>(0), 0.5, 15, 10, 1e-6, 4, 4, 2));
 }
 
 void PrintTo(const WeylTestCase& testcase, std::ostream* os) {
@@ -137,8 +322,11 @@ std::shared_ptr<gr2::CombinedWeyl> schbw = std::make_shared<gr2::CombinedWeyl>(v
 auto test_cases = testing::Values(
     WeylTestCase(std::make_shared<gr2::WeylSchwarzschild>(0.3), folder + "weylschwarzschild.txt", "WeylSchwarzschild", 1e-12),
     WeylTestCase(std::make_shared<gr2::BachWeylRing>(0.3, 5), folder + "bachweylring.txt", "BachWeylRing", 1e-12),
+    WeylTestCase(std::make_shared<gr2::BachWeylRing>(0.3, 5), folder + "bachweylring_axis.txt", "BachWeylRingAxis", 1e-12),
     WeylTestCase(std::make_shared<gr2::InvertedKuzminToomreDisk>(1, 0.3, 5), folder + "invertedkuzmintoomredisk1.txt", "InvertedKuzminToomre1", 1e-12),
     WeylTestCase(std::make_shared<gr2::InvertedKuzminToomreDisk>(3, 0.3, 5), folder + "invertedkuzmintoomredisk3.txt", "InvertedKuzminToomre3", 1e-12),
+    WeylTestCase(std::make_shared<gr2::InvertedKuzminToomreDisk>(1, 0.3, 5), folder + "invertedkuzmintoomredisk1_axis.txt", "InvertedKuzminToomre1Axis", 1e-12),
+    WeylTestCase(std::make_shared<gr2::InvertedKuzminToomreDisk>(3, 0.3, 5), folder + "invertedkuzmintoomredisk3_axis.txt", "InvertedKuzminToomre3Axis", 1e-12),
     WeylTestCase(std::make_shared<gr2::InvertedMorganMorganDisk>(1, 0.3, 5), folder + "invertedmorganmorgandisk1.txt", "InvertedMorganMorgan1", 1e-12),
     WeylTestCase(std::make_shared<gr2::InvertedMorganMorganDisk>(3, 0.3, 5), folder + "invertedmorganmorgandisk3.txt", "InvertedMorganMorgan3", 1e-12),
     WeylTestCase(schbw, folder + "schwarzschildbachweyl.txt", "SchwarzschildBachWeyl", 1e-12)
@@ -0,0 +1,266 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#include "gravitacek2/setup.hpp"
+#include "gravitacek2/integrator/odesystem.hpp"
+#include "gravitacek2/integrator/steppers.hpp"
+#include "gravitacek2/integrator/stepcontrollers.hpp"
+#include "gravitacek2/geomotion/spacetimes.hpp"
+
+// ========== Settings ==========
+
+struct HarnessSettings
+{
+    gr2::real t_end = 1000;         // proper time of integration
+    gr2::real tol_max = 1e-6;       // loosest tolerance of the ladder
+    gr2::real tol_min = 1e-16;      // tightest tolerance of the ladder
+    gr2::real tol_factor = 100;     // ratio of neighbouring tolerances
+    long max_steps = 1000000;       // budget of accepted steps for one run
+    std::string filter = "";        // only cases containing this text are run
+};
+
+// ========== Reference geodesics ==========
+
+struct ReferenceGeodesic
+{
+    std::string name;
+    std::shared_ptr<gr2::GeoMotion> spacetime;
+    std::vector<gr2::real> y;   // initial values
+    int phi;                    // index of coordinate phi
+};
+
+// energy E = -u_t and angular momentum L = u_phi (all space-times are diagonal and stationary)
+void integrals_of_motion(ReferenceGeodesic &geodesic, const gr2::real y[], gr2::real &E, gr2::real &L)
+{
+    int phi = geodesic.phi, uphi = geodesic.phi + 4;
+    geodesic.spacetime->calculate_metric(y);
+    gr2::real **g = geodesic.spacetime->get_metric();
+    E = -g[0][0]*y[4];
+    L = g[phi][phi]*y[uphi];
+}
+
+// position is read from the first line of test fixture, four-velocity gives
+// nearly circular orbit (velocity of circular Schwarzschild orbit in direction
+// of phi with small radial kick)
+ReferenceGeodesic reference_geodesic(const std::string &name, std::shared_ptr<gr2::GeoMotion> spt, const std::string &filename, const bool &spherical)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Unable to open file " + filename);
+    std::string line;
+    std::getline(file, line);
+    gr2::real x[4];
+    if (sscanf(line.c_str(), "%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL ";%" GR2_SCN_REAL "%*s", x, x+1, x+2, x+3) != 4)
+        throw std::runtime_error("Unable to read position from file " + filename);
+
+    ReferenceGeodesic geodesic;
+    geodesic.name = name;
+    geodesic.spacetime = spt;
+    geodesic.y = std::vector<gr2::real>(spt->get_n(), 0);
+    gr2::real *y = geodesic.y.data();
+    for (int i = 0; i < 4; i++)
+        y[i] = x[i];
+
+    // spatial part of four-velocity
+    gr2::real M = 0.3, r, R;
+    if (spherical)
+    {
+        geodesic.phi = gr2::Schwarzschild::PHI;
+        r = y[gr2::Schwarzschild::R];
+        R = r*std::sin(y[gr2::Schwarzschild::THETA]);
+        y[gr2::Schwarzschild::UR] = 0.02;
+    }
+    else
+    {
+        geodesic.phi = gr2::Weyl::PHI;
+        R = y[gr2::Weyl::RHO];
+        r = std::sqrt(R*R + y[gr2::Weyl::Z]*y[gr2::Weyl::Z]);
+        y[gr2::Weyl::URHO] = 0.02;
+    }
+    y[geodesic.phi + 4] = std::sqrt(M/(r - 3*M))/R;
+
+    // normalization of four-velocity
+    spt->calculate_metric(y);
+    gr2::real **g = spt->get_metric();
+    gr2::real sum = 0;
+    for (int i = 1; i < 4; i++)
+        sum += g[i][i]*y[i+4]*y[i+4];
+    y[4] = std::sqrt((-1 - sum)/g[0][0]);
+
+    // initial value of lambda
+    auto weyl = std::dynamic_pointer_cast<gr2::Weyl>(spt);
+    if (weyl)
+    {
+        weyl->calculate_lambda_init(y);
+        y[gr2::Weyl::LAMBDA] = weyl->get_lambda();
+    }
+    return geodesic;
+}
+
+// ========== One run ==========
+
+struct RunRecord
+{
+    long rhs = 0;
+    long accepted = 0;
+    long rejected = 0;
+    double time = 0;
+    gr2::real dE = 0;
+    gr2::real dL = 0;
+    std::string status = "ok";
+};
+
+RunRecord run(ReferenceGeodesic &geodesic, const std::string &stepper_name, const std::string &controller_name, const gr2::real &tol, const HarnessSettings &settings)
+{
+    RunRecord record;
+    int n = geodesic.spacetime->get_n();
+    auto ode = std::make_shared<gr2::CountingOdeSystem>(std::shared_ptr<gr2::GeoMotion>(geodesic.spacetime->clone()));
+
+    std::unique_ptr<gr2::StepperBase> stepper;
+    if (stepper_name == "RK4")
+        stepper = std::make_unique<gr2::RK4>();
+    else
+        stepper = std::make_unique<gr2::DoPr853>();
+    stepper->set_OdeSystem(ode);
+
+    std::unique_ptr<gr2::StepControllerBase> controller;
+    if (controller_name == "StepControllerNR")
+        controller = std::make_unique<gr2::StepControllerNR>(n, stepper->get_err_order(), tol, tol, 0.8, 0.2, 10.0);
+    else
+        controller = std::make_unique<gr2::StandardStepController>(n, stepper->get_err_order(), tol, tol, 1, 0);
+
+    std::vector<gr2::real> y = geodesic.y, y2(n), dydt(n), dydt2(n), err(n);
+    gr2::real t = 0, h = 0.1, h_step;
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        ode->function(t, y.data(), dydt.data());
+        while (t < settings.t_end)
+        {
+            if (record.accepted >= settings.max_steps)
+            {
+                record.status = "budget";
+                break;
+            }
+            h_step = std::min(h, settings.t_end - t);
+            y2 = y;
+            stepper->step_err(t, y2.data(), h_step, err.data(), false, dydt.data(), dydt2.data());
+            h = h_step;
+            if (!controller->hadjust(y2.data(), err.data(), dydt2.data(), h))
+            {
+                record.rejected++;
+                continue;
+            }
+            record.accepted++;
+            t += h_step;
+            y.swap(y2);
+            dydt.swap(dydt2);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        record.status = "failed";
+    }
+    auto end = std::chrono::steady_clock::now();
+    record.time = std::chrono::duration<double>(end - start).count();
+    record.rhs = ode->get_evaluations();
+
+    // drift of integrals of motion
+    gr2::real E0, L0, E, L;
+    integrals_of_motion(geodesic, geodesic.y.data(), E0, L0);
+    integrals_of_motion(geodesic, y.data(), E, L);
+    record.dE = std::abs((E - E0)/E0);
+    record.dL = std::abs((L - L0)/L0);
+    return record;
+}
+
+// ========== Main ==========
+
+int main(int argc, char **argv)
+{
+    HarnessSettings settings;
+    std::string output = "";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: workprecision [--filter text] [--t-end t] [--tol-max tol] [--tol-min tol] [--tol-factor f] [--max-steps n] [--out file]" << std::endl;
+            return 1;
+        }
+        if (arg == "--filter")
+            settings.filter = argv[++i];
+        else if (arg == "--t-end")
+            settings.t_end = std::stold(argv[++i]);
+        else if (arg == "--tol-max")
+            settings.tol_max = std::stold(argv[++i]);
+        else if (arg == "--tol-min")
+            settings.tol_min = std::stold(argv[++i]);
+        else if (arg == "--tol-factor")
+            settings.tol_factor = std::stold(argv[++i]);
+        else if (arg == "--max-steps")
+            settings.max_steps = std::stol(argv[++i]);
+        else if (arg == "--out")
+            output = argv[++i];
+        else
+        {
+            std::cerr << "unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (settings.tol_factor <= 1 || settings.tol_min > settings.tol_max)
+    {
+        std::cerr << "invalid tolerance ladder" << std::endl;
+        return 1;
+    }
+
+    // reference geodesics (fixtures are copied next to the tests)
+    std::string spt_folder = "./test_spacetime/", weyl_folder = "./test_weylspacetime/";
+    std::vector<ReferenceGeodesic> geodesics = {
+        reference_geodesic("Schwarzschild", std::make_shared<gr2::Schwarzschild>(0.3), spt_folder + "schwarzschild.txt", true),
+        reference_geodesic("Weyl", std::make_shared<gr2::WeylSchwarzschild>(0.3), spt_folder + "weyl.txt", false),
+        reference_geodesic("MajumdarPapapetrouWeyl", std::make_shared<gr2::ReissnerNordstromMPW>(0.3), spt_folder + "mp.txt", false),
+        reference_geodesic("WeylSchwarzschild", std::make_shared<gr2::WeylSchwarzschild>(0.3), weyl_folder + "weylschwarzschild.txt", false),
+        reference_geodesic("BachWeylRing", std::make_shared<gr2::BachWeylRing>(0.3, 5), weyl_folder + "bachweylring.txt", false),
+        reference_geodesic("InvertedKuzminToomre1", std::make_shared<gr2::InvertedKuzminToomreDisk>(1, 0.3, 5), weyl_folder + "invertedkuzmintoomredisk1.txt", false),
+        reference_geodesic("InvertedMorganMorgan1", std::make_shared<gr2::InvertedMorganMorganDisk>(1, 0.3, 5), weyl_folder + "invertedmorganmorgandisk1.txt", false),
+    };
+
+    std::ofstream file;
+    if (output != "")
+    {
+        file.open(output);
+        if (!file)
+            throw std::runtime_error("file " + output + " can not be opened");
+    }
+    std::ostream &out = output == "" ? std::cout : file;
+
+    // work-precision tables
+    out << "# case stepper controller tol rhs accepted rejected time_s dE dL status" << std::endl;
+    for (auto &geodesic : geodesics)
+    {
+        if (geodesic.name.find(settings.filter) == std::string::npos)
+            continue;
+        for (std::string stepper : {"DoPr853", "RK4"})
+            for (std::string controller : {"StepControllerNR", "StandardStepController"})
+            {
+                for (gr2::real tol = settings.tol_max; tol >= settings.tol_min*(1 - 1e-6); tol /= settings.tol_factor)
+                {
+                    RunRecord record = run(geodesic, stepper, controller, tol, settings);
+                    out << std::setw(24) << std::left << geodesic.name << " " << std::setw(8) << stepper << " " << std::setw(23) << controller << std::right << std::scientific << std::setprecision(1)
+                        << " " << (double)tol << " " << std::setw(9) << record.rhs << " " << std::setw(8) << record.accepted << " " << std::setw(7) << record.rejected
+                        << std::setprecision(3) << " " << record.time << " " << (double)record.dE << " " << (double)record.dL << " " << record.status << std::endl;
+                }
+                out << std::endl;
+            }
+    }
+    return 0;
+}